@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <core/application.hpp>
+#include <core/event.hpp>
+#include <game_types.hpp>
+#include <headless_game.hpp>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Standalone engine benchmarks, results are written to the log.
+struct Benchmark {
+    std::string_view name;
+    bool (*run)();
+};
+
+bool run_job_system_benchmark();
+bool run_fiber_benchmark();
+bool run_recording_benchmark();
+bool run_staging_benchmark();
+bool run_bindless_benchmark();
+
+// Wall clock seconds elapsed since start
+inline double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs a game from make_headless_game() to its frame limit to its frame limit. collect reads the results while the engine systems are still alive, nothing
+// is returned when the run failed
+template <typename Collect>
+std::optional<std::invoke_result_t<Collect, const Game&>> measure_headless(Game& game, Collect collect) {
+    EventManager eventManager{};
+    Application application{game, eventManager};
+    if (!application.run()) {
+        return std::nullopt;
+    }
+    return collect(std::as_const(game));
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "benchmark.hpp"
+#include <array>
+#include <chrono>
+#include <core/frame_stats.hpp>
+#include <core/logger.hpp>
+#include <renderer/renderer.hpp>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Draw throughput when every draw reads its own storage buffer, bound with a descriptor set per draw or indexed
+// in the bindless set. The bindless run is skipped on devices without descriptor indexing.
+
+namespace {
+    constexpr u32 DRAW_COUNT = 4096;
+    constexpr u64 FRAME_COUNT = 300;
+    // Pipelines compile off-thread, frames drawn with the builtin pipeline would skew the results
+    constexpr std::chrono::seconds PIPELINE_TIMEOUT{30};
+
+    struct Scenario {
+        std::string_view name;
+        const char* vertexShader{nullptr};
+        bool bindless{false};
+    };
+    constexpr std::array scenarios{Scenario{"descriptor sets", "draw_data.vert.spv", false},
+                                   Scenario{"bindless", "draw_data_bindless.vert.spv", true}};
+
+    // Matches DrawData of the draw_data shaders
+    struct DrawData {
+        f32 offset[4];
+        f32 tint[4];
+    };
+
+    struct Result {
+        double recordSeconds{0};
+        double frameSeconds{0};
+        bool skipped{false};
+    };
+
+    Game* sGame{nullptr};
+    const Scenario* sScenario{nullptr};
+    bool sSkipped{false};
+    BufferHandle sVertexBuffer{};
+    PipelineHandle sPipeline{};
+    std::vector<DrawCommand> sDraws;
+
+    bool initialize() {
+        auto& renderer = *sGame->mRenderer;
+        sSkipped = sScenario->bindless && !renderer.supports_bindless();
+        sDraws.clear();
+        if (sSkipped) {
+            return true;
+        }
+        constexpr std::array<Vertex, 3> triangle{Vertex{{0.0F, -0.01F, 0.0F}, {1.0F, 1.0F, 1.0F, 1.0F}},
+                                                 Vertex{{0.01F, 0.01F, 0.0F}, {1.0F, 1.0F, 1.0F, 1.0F}},
+                                                 Vertex{{-0.01F, 0.01F, 0.0F}, {1.0F, 1.0F, 1.0F, 1.0F}}};
+        sVertexBuffer = renderer.create_buffer(BufferUsage::BUFFER_USAGE_VERTEX, sizeof(triangle));
+        if (!renderer.upload_buffer(sVertexBuffer, triangle.data(), sizeof(triangle))) {
+            return false;
+        }
+
+        PipelineDescription description{};
+        description.vertexShader = sScenario->vertexShader;
+        sPipeline = renderer.create_pipeline(description);
+        const auto start = std::chrono::steady_clock::now();
+        while (!renderer.is_pipeline_ready(sPipeline)) {
+            if (!sPipeline.is_valid() || std::chrono::steady_clock::now() - start > PIPELINE_TIMEOUT) {
+                MSG_ERROR("Bindless benchmark: pipeline with {} never became ready", description.vertexShader);
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        // A grid of triangles across the screen, each with its own buffer
+        constexpr u32 columns = 64;
+        for (u32 i = 0; i < DRAW_COUNT; ++i) {
+            const DrawData data{{static_cast<f32>(i % columns) / columns * 2.0F - 1.0F,
+                                 static_cast<f32>(i / columns) / (DRAW_COUNT / columns) * 2.0F - 1.0F, 0.0F, 0.0F},
+                                {1.0F, static_cast<f32>(i) / DRAW_COUNT, 0.5F, 1.0F}};
+            const BufferHandle resources = renderer.create_buffer(BufferUsage::BUFFER_USAGE_STORAGE, sizeof(data));
+            if (!renderer.upload_buffer(resources, &data, sizeof(data))) {
+                return false;
+            }
+            DrawCommand draw{sVertexBuffer, {}, 3};
+            draw.pipeline = sPipeline;
+            draw.resources = resources;
+            sDraws.push_back(draw);
+        }
+        return true;
+    }
+    bool render(double /*unused*/, RenderPacket& packet) {
+        packet.drawCommands = sDraws;
+        return true;
+    }
+    // Average times per frame, negative when the run failed
+    Result measure(const Scenario& scenario) {
+        Game game = make_headless_game("Bindless benchmark", FRAME_COUNT);
+        game.initialize = initialize;
+        game.render = render;
+        sGame = &game;
+        sScenario = &scenario;
+        return measure_headless(game, [](const Game& measured) {
+                   return Result{measured.mFrameStats->get_summary(FrameStats::METRIC_RECORD_TIME).average,
+                                 measured.mFrameStats->get_summary(FrameStats::METRIC_FRAME_TIME).average, sSkipped};
+               })
+            .value_or(Result{-1.0, -1.0});
+    }
+}  // namespace
+
+bool run_bindless_benchmark() {
+    double baselineSeconds = 0;
+    for (const auto& scenario : scenarios) {
+        const Result result = measure(scenario);
+        if (result.recordSeconds < 0) {
+            return false;
+        }
+        if (result.skipped) {
+            MSG_INFO("  {:<15}: skipped, the device does not support descriptor indexing", scenario.name);
+            continue;
+        }
+        if (baselineSeconds == 0) {
+            baselineSeconds = result.frameSeconds;
+        }
+        MSG_INFO("  {:<15}: {:8.3f} ms recording, {:8.3f} ms per frame for {} draws, {:8.0f} draws/s, "
+                 "speedup {:5.2f}x",
+                 scenario.name, result.recordSeconds * 1000.0, result.frameSeconds * 1000.0, DRAW_COUNT,
+                 DRAW_COUNT / result.frameSeconds, baselineSeconds / result.frameSeconds);
+    }
+    return true;
+}
\ No newline at end of file
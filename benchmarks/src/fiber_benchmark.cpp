@@ -0,0 +1,86 @@
+#include "benchmark.hpp"
+#include <atomic>
+#include <core/job_system.hpp>
+#include <core/logger.hpp>
+#include <platform/fiber.hpp>
+#include <vector>
+
+// Raw fiber switch cost, and a stress run of 100k small jobs where every parent job waits on its children.
+
+namespace {
+    constexpr u32 SWITCH_COUNT = 1000000;
+    constexpr u32 PARENT_JOB_COUNT = 100;
+    constexpr u32 CHILD_JOB_COUNT = 1000;
+
+    struct PingPong {
+        Fiber* caller{nullptr};
+        Fiber* fiber{nullptr};
+    };
+
+    void ping_pong(void* userData) {
+        auto* pingPong = static_cast<PingPong*>(userData);
+        while (true) {
+            Fiber::switch_to(*pingPong->fiber, *pingPong->caller);
+        }
+    }
+
+    struct StressState {
+        JobSystem* jobSystem{nullptr};
+        std::atomic<u64> sum{0};
+    };
+
+    void child_job(void* userData) {
+        static_cast<StressState*>(userData)->sum.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void parent_job(void* userData) {
+        auto* state = static_cast<StressState*>(userData);
+        std::vector<JobSystem::JobDeclaration> children(CHILD_JOB_COUNT, {child_job, state});
+        JobCounter counter;
+        state->jobSystem->run(children, counter);
+        state->jobSystem->wait(counter);
+    }
+
+    bool run_stress(u32 fiberCount) {
+        JobSystem jobSystem{JobSystem::get_default_worker_count(), fiberCount};
+        StressState state{&jobSystem};
+        std::vector<JobSystem::JobDeclaration> parents(PARENT_JOB_COUNT, {parent_job, &state});
+
+        const auto start = std::chrono::steady_clock::now();
+        JobCounter counter;
+        jobSystem.run(parents, counter);
+        jobSystem.wait(counter);
+        const double seconds = seconds_since(start);
+
+        const auto statistics = jobSystem.get_statistics();
+        MSG_INFO("  {} jobs with {} fibers: {:8.3f} ms, {} stolen, {} fiber switches", statistics.jobsExecuted,
+                 fiberCount, seconds * 1000.0, statistics.jobsStolen, statistics.fiberSwitches);
+
+        const u64 expected = static_cast<u64>(PARENT_JOB_COUNT) * CHILD_JOB_COUNT;
+        if (state.sum.load() != expected || statistics.jobsExecuted != expected + PARENT_JOB_COUNT) {
+            MSG_ERROR("Stress run lost jobs: {} of {} children ran", state.sum.load(), expected);
+            return false;
+        }
+        return true;
+    }
+}  // namespace
+
+bool run_fiber_benchmark() {
+    {
+        Fiber caller;
+        PingPong pingPong{&caller};
+        Fiber fiber{ping_pong, &pingPong};
+        pingPong.fiber = &fiber;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (u32 i = 0; i < SWITCH_COUNT; ++i) {
+            Fiber::switch_to(caller, fiber);
+        }
+        const double seconds = seconds_since(start);
+        // Every iteration switches to the fiber and back
+        MSG_INFO("  Fiber switch: {:.1f} ns", seconds * 1e9 / (2.0 * SWITCH_COUNT));
+    }
+
+    // Without fibers waiting parents nest other jobs on their stack instead of suspending
+    return run_stress(0) && run_stress(JobSystem::DEFAULT_FIBER_COUNT);
+}
\ No newline at end of file
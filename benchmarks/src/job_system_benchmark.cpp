@@ -0,0 +1,66 @@
+#include "benchmark.hpp"
+#include <cmath>
+#include <core/job_system.hpp>
+#include <core/logger.hpp>
+#include <vector>
+
+// Scaling of a synthetic, evenly divisible workload from 1 thread up to every hardware thread.
+// Each job fills a slice of an array with some transcendental math so the work is compute bound.
+
+namespace {
+    constexpr u32 JOB_COUNT = 2048;
+    constexpr u32 ELEMENTS_PER_JOB = 4096;
+    constexpr u32 REPETITIONS = 5;
+
+    struct Slice {
+        f32* output;
+        u32 first;
+    };
+
+    void compute_slice(void* userData) {
+        const auto* slice = static_cast<const Slice*>(userData);
+        for (u32 i = 0; i < ELEMENTS_PER_JOB; ++i) {
+            const auto x = static_cast<f32>(slice->first + i);
+            slice->output[slice->first + i] = std::sin(x) * std::cos(x * 0.5F) + std::sqrt(x);
+        }
+    }
+}  // namespace
+
+bool run_job_system_benchmark() {
+    std::vector<f32> output(static_cast<size_t>(JOB_COUNT) * ELEMENTS_PER_JOB);
+    std::vector<Slice> slices(JOB_COUNT);
+    std::vector<JobSystem::JobDeclaration> jobs(JOB_COUNT);
+    for (u32 i = 0; i < JOB_COUNT; ++i) {
+        slices[i] = {output.data(), i * ELEMENTS_PER_JOB};
+        jobs[i] = {compute_slice, &slices[i]};
+    }
+
+    const u32 maxThreads = JobSystem::get_default_worker_count() + 1;
+    double singleThreadSeconds = 0;
+    for (u32 threads = 1; threads <= maxThreads; ++threads) {
+        JobSystem jobSystem{threads - 1};
+
+        // Best of several runs, the first one also warms up the workers
+        double bestSeconds = 0;
+        for (u32 repetition = 0; repetition < REPETITIONS; ++repetition) {
+            const auto start = std::chrono::steady_clock::now();
+            JobCounter counter;
+            jobSystem.run(jobs, counter);
+            jobSystem.wait(counter);
+            const double seconds = seconds_since(start);
+            bestSeconds = repetition == 0 ? seconds : std::min(bestSeconds, seconds);
+        }
+
+        if (threads == 1) {
+            singleThreadSeconds = bestSeconds;
+        }
+        const auto statistics = jobSystem.get_statistics();
+        MSG_INFO("  {:>2} threads: {:8.3f} ms, speedup {:5.2f}x, {} jobs stolen", threads, bestSeconds * 1000.0,
+                 singleThreadSeconds / bestSeconds, statistics.jobsStolen);
+        if (statistics.jobsExecuted != static_cast<u64>(JOB_COUNT) * REPETITIONS) {
+            MSG_ERROR("Job system executed {} jobs, expected {}", statistics.jobsExecuted, JOB_COUNT * REPETITIONS);
+            return false;
+        }
+    }
+    return true;
+}
\ No newline at end of file
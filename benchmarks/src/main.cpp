@@ -0,0 +1,37 @@
+#include "benchmark.hpp"
+#include <array>
+#include <core/logger.hpp>
+#include <string_view>
+
+namespace {
+    constexpr std::array benchmarks{
+        Benchmark{"jobs", run_job_system_benchmark},
+        Benchmark{"fibers", run_fiber_benchmark},
+        Benchmark{"recording", run_recording_benchmark},
+        Benchmark{"staging", run_staging_benchmark},
+        Benchmark{"bindless", run_bindless_benchmark},
+    };
+}  // namespace
+
+// Usage: Benchmarks [name...], runs every benchmark when no names are given
+int main(int argc, char** argv) {
+    Logger::init_logging();
+
+    bool success = true;
+    for (const auto& benchmark : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || benchmark.name == std::string_view{argv[i]};
+        }
+        if (!selected) {
+            continue;
+        }
+
+        MSG_INFO("Running benchmark: {}", benchmark.name);
+        if (!benchmark.run()) {
+            MSG_ERROR("Benchmark failed: {}", benchmark.name);
+            success = false;
+        }
+    }
+    return success ? 0 : -1;
+}
\ No newline at end of file
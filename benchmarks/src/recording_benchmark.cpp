@@ -0,0 +1,63 @@
+#include "benchmark.hpp"
+#include <array>
+#include <core/frame_stats.hpp>
+#include <core/job_system.hpp>
+#include <core/logger.hpp>
+#include <renderer/renderer.hpp>
+
+// Command buffer recording time of a frame with thousands of draws, from inline recording on the render thread
+// up to recording on every hardware thread.
+
+namespace {
+    constexpr u32 DRAW_COUNT = 10000;
+    constexpr u64 FRAME_COUNT = 300;
+
+    Game* sGame{nullptr};
+    BufferHandle sVertexBuffer{};
+
+    bool initialize() {
+        constexpr std::array<Vertex, 3> triangle{Vertex{{0.0F, -0.01F, 0.0F}, {1.0F, 0.0F, 0.0F, 1.0F}},
+                                                 Vertex{{0.01F, 0.01F, 0.0F}, {0.0F, 1.0F, 0.0F, 1.0F}},
+                                                 Vertex{{-0.01F, 0.01F, 0.0F}, {0.0F, 0.0F, 1.0F, 1.0F}}};
+        sVertexBuffer = sGame->mRenderer->create_buffer(BufferUsage::BUFFER_USAGE_VERTEX, sizeof(triangle));
+        return sGame->mRenderer->upload_buffer(sVertexBuffer, triangle.data(), sizeof(triangle));
+    }
+    bool render(double /*unused*/, RenderPacket& packet) {
+        packet.drawCommands.assign(DRAW_COUNT, DrawCommand{sVertexBuffer, {}, 3});
+        return true;
+    }
+
+    // Average recording time per frame in seconds, negative when the run failed
+    double measure(u32 workerThreadCount, u32 renderQueueDepth) {
+        Game game = make_headless_game("Recording benchmark", FRAME_COUNT);
+        game.mWorkerThreadCount = workerThreadCount;
+        game.mRenderQueueDepth = renderQueueDepth;
+        game.initialize = initialize;
+        game.render = render;
+        sGame = &game;
+        return measure_headless(game, [](const Game& measured) {
+                   return measured.mFrameStats->get_summary(FrameStats::METRIC_RECORD_TIME).average;
+               })
+            .value_or(-1.0);
+    }
+}  // namespace
+
+bool run_recording_benchmark() {
+    // The render thread is not a job system thread, so its frames are always recorded inline
+    const double inlineSeconds = measure(0, 1);
+    if (inlineSeconds < 0) {
+        return false;
+    }
+    MSG_INFO("  inline     : {:8.3f} ms per frame for {} draws", inlineSeconds * 1000.0, DRAW_COUNT);
+
+    const u32 maxThreads = JobSystem::get_default_worker_count() + 1;
+    for (u32 threads = 2; threads <= maxThreads; ++threads) {
+        const double seconds = measure(threads - 1, 0);
+        if (seconds < 0) {
+            return false;
+        }
+        MSG_INFO("  {:>2} threads: {:8.3f} ms per frame, speedup {:5.2f}x", threads, seconds * 1000.0,
+                 inlineSeconds / seconds);
+    }
+    return true;
+}
\ No newline at end of file
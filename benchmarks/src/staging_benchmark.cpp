@@ -0,0 +1,72 @@
+#include "benchmark.hpp"
+#include <array>
+#include <chrono>
+#include <core/logger.hpp>
+#include <renderer/renderer.hpp>
+#include <string_view>
+#include <vector>
+
+// Upload throughput through the renderer's staging ring, for many small uploads and for a few large ones per frame.
+
+namespace {
+    constexpr u64 FRAME_COUNT = 200;
+
+    struct Scenario {
+        std::string_view name;
+        u32 uploadsPerFrame{0};
+        u32 uploadSize{0};
+    };
+    constexpr std::array scenarios{Scenario{"many small", 4096, 256},
+                                   Scenario{"few large", 4, 4 * 1024 * 1024}};
+
+    Game* sGame{nullptr};
+    const Scenario* sScenario{nullptr};
+    BufferHandle sBuffer{};
+    std::vector<u8> sData;
+    std::chrono::steady_clock::time_point sStart;
+
+    bool initialize() {
+        sBuffer = sGame->mRenderer->create_buffer(BufferUsage::BUFFER_USAGE_VERTEX,
+                                                  static_cast<u64>(sScenario->uploadsPerFrame) * sScenario->uploadSize);
+        sData.assign(sScenario->uploadSize, 0xAB);
+        sStart = std::chrono::steady_clock::now();
+        return sBuffer.is_valid();
+    }
+    bool update(double /*unused*/) {
+        for (u32 i = 0; i < sScenario->uploadsPerFrame; ++i) {
+            if (!sGame->mRenderer->upload_buffer(sBuffer, sData.data(), sData.size(),
+                                                 static_cast<u64>(i) * sScenario->uploadSize)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Uploaded MiB per second including the GPU copies, negative when the run failed
+    double measure(const Scenario& scenario) {
+        Game game = make_headless_game("Staging benchmark", FRAME_COUNT);
+        game.initialize = initialize;
+        game.update = update;
+        sGame = &game;
+        sScenario = &scenario;
+        return measure_headless(game, [](const Game& measured) {
+                   // Copies of the last frames in flight may still run, a small share of FRAME_COUNT frames
+                   const double seconds = seconds_since(sStart);
+                   const auto bytes = static_cast<double>(measured.mRenderer->get_statistics().bytesUploaded);
+                   return bytes / (1024.0 * 1024.0) / seconds;
+               })
+            .value_or(-1.0);
+    }
+}  // namespace
+
+bool run_staging_benchmark() {
+    for (const auto& scenario : scenarios) {
+        const double mebibytesPerSecond = measure(scenario);
+        if (mebibytesPerSecond < 0) {
+            return false;
+        }
+        MSG_INFO("  {:<10}: {:5} uploads of {:8} bytes per frame, {:9.1f} MiB/s", scenario.name,
+                 scenario.uploadsPerFrame, scenario.uploadSize, mebibytesPerSecond);
+    }
+    return true;
+}
\ No newline at end of file
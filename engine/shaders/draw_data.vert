@@ -0,0 +1,17 @@
+#version 450
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec4 inColor;
+
+layout(location = 0) out vec4 fragColor;
+
+// The draw's resources buffer, bound with a descriptor set per draw
+layout(std430, set = 0, binding = 0) readonly buffer DrawData {
+    vec4 offset;
+    vec4 tint;
+} drawData;
+
+void main() {
+    gl_Position = vec4(inPosition + drawData.offset.xyz, 1.0);
+    fragColor = inColor * drawData.tint;
+}
\ No newline at end of file
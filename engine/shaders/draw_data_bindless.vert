@@ -0,0 +1,23 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec4 inColor;
+
+layout(location = 0) out vec4 fragColor;
+
+// Storage buffer array of the bindless set, indexed with the slot of the draw's resources buffer
+layout(std430, set = 0, binding = 0) readonly buffer DrawData {
+    vec4 offset;
+    vec4 tint;
+} drawData[];
+
+layout(push_constant) uniform PushConstants {
+    uint drawDataSlot;
+} pushConstants;
+
+void main() {
+    const uint slot = pushConstants.drawDataSlot;
+    gl_Position = vec4(inPosition + drawData[slot].offset.xyz, 1.0);
+    fragColor = inColor * drawData[slot].tint;
+}
\ No newline at end of file
@@ -1,12 +1,26 @@
 #include "application.hpp"
 #include "core/clock.hpp"
 #include "core/event.hpp"
+#include "core/frame_stats.hpp"
 #include "core/input.hpp"
+#include "core/input_mapping.hpp"
+#include "core/job_system.hpp"
 #include "core/logger.hpp"
+#include "core/task_graph.hpp"
 #include "game_types.hpp"
 #include "platform/platform.hpp"
 #include "renderer/renderer.hpp"
 
+namespace {
+    enum EngineAction {
+        ENGINE_ACTION_QUIT
+    };
+
+    constexpr std::array engineActionBindings{
+        InputMapping::ActionBinding{ENGINE_ACTION_QUIT, InputMapping::key(InputHandler::Key::KEY_ESCAPE)},
+    };
+    constexpr InputMapping engineMapping{engineActionBindings, {}};
+}  // namespace
 
 Application::Application(Game& game, EventManager& eventManager)
     : mX{game.mX}, mY{game.mY}, mWidth{game.mWidth}, mHeight{game.mHeight}, mName{game.mName}, mRunning{true},
@@ -19,16 +33,36 @@ Application::Application(Game& game, EventManager& eventManager)
     mEventManager.register_event(EventManager::EventCode::EVENT_CODE_KEY_RELEASED, this, Application::on_key);
     mEventManager.register_event(EventManager::EventCode::EVENT_CODE_MOUSE_MOVED, this, Application::on_mouse_move);
 
-    mPlatform = std::make_unique<Platform>(*mInputHandler, mEventManager);
+    mPlatform = std::make_unique<Platform>(*mInputHandler, mEventManager, game.mHeadless);
+    mStartTime = mPlatform->getAbsoluteTime();
     if (!(mPlatform->startup(mName, mX, mY, mWidth, mHeight))) {
         MSG_FATAL("Failed to start platform window!");
         // TODO: Probably throw an exception here too...
         // Move these into functions to lessen error checking here
     }
+    if (!game.mInputScriptPath.empty()) {
+        if (!game.mHeadless) {
+            MSG_WARN("Input script: {} ignored, scripted input is only replayed when headless",
+                     game.mInputScriptPath);
+        } else if (!mPlatform->loadInputScript(game.mInputScriptPath)) {
+            MSG_ERROR("Failed to load input script: {}", game.mInputScriptPath);
+        }
+    }
 
     mClock = std::make_unique<Clock>(mPlatform.get());
 
-    mRenderer = std::make_unique<Renderer>(game.mName, mPlatform.get(), game.mWidth, game.mHeight);
+    mJobSystem = std::make_unique<JobSystem>(game.mWorkerThreadCount > 0 ? game.mWorkerThreadCount
+                                                                         : JobSystem::get_default_worker_count());
+    mGame.mJobSystem = mJobSystem.get();
+
+    mRenderer = std::make_unique<Renderer>(game.mName, mPlatform.get(), game.mRendererBackend, game.mWidth,
+                                           game.mHeight, game.mHeadless, mJobSystem.get(), game.mRenderQueueDepth,
+                                           game.mFramesInFlight, game.mPipelineCachePath, game.mTransferQueue);
+    mGame.mRenderer = mRenderer.get();
+
+    mFrameStats = std::make_unique<FrameStats>();
+    mGame.mFrameStats = mFrameStats.get();
+    mGame.mInputHandler = mInputHandler.get();
 
     if (!(mGame.initialize())) {
         MSG_FATAL("Game failed to initialize!");
@@ -39,6 +73,7 @@ Application::Application(Game& game, EventManager& eventManager)
     mEventManager.register_event(EventManager::EventCode::EVENT_CODE_WINDOW_RESIZED, this, Application::on_event);
 
     mGame.on_resize(mWidth, mHeight);
+    build_frame_graph();
     MSG_TRACE("Application: {:p} created", static_cast<void*>(this));
 }
 
@@ -49,30 +84,79 @@ bool Application::run() {
     // f64 targetFrameSeconds = 1.0F / framesPerSecondTarget;
     mClock->start();
     f64 deltaTime = 0;
+    f64 previousFrameStartTime = 0;
+    u64 frameCount = 0;
     while (mRunning) {
         if (!(mPlatform->pumpMessages())) {
             mRunning = false;
             break;
         };
+        if (engineMapping.was_action_pressed(*mInputHandler, ENGINE_ACTION_QUIT)) {
+            mEventManager.fire_event(EventManager::EventCode::EVENT_CODE_APPLICATION_QUIT, this,
+                                     EventManager::Context{});
+        }
 
         if (!mSuspended) {
             mClock->update();
             // START OF FRAME
+            const f64 frameStartTime = mPlatform->getAbsoluteTime();
 
-            if (!(mGame.update(deltaTime))) {
-                MSG_FATAL("Game update failed! Shutting down.");
-                mRunning = false;
-                break;
+            // Pipelined: this frame's update and packet build overlap the draw of the packet built last frame
+            mFrameDeltaTime = deltaTime;
+            if (mGame.mSerialFrames) {
+                mDrawPacketIndex = mBuildPacketIndex;
+                mDrawPending = true;
             }
-            if (!(mGame.render(deltaTime))) {
-                MSG_FATAL("Game render failed! Shutting down.");
+            mFrameGraph->execute(*mJobSystem);
+            if (mFrameFailed.load(std::memory_order_relaxed)) {
                 mRunning = false;
                 break;
             }
 
-            Renderer::RenderPacket packet{};
-            packet.deltaTime = deltaTime;
-            mRenderer->draw_frame(packet);
+            // With a render thread these are the frames it finished since the last poll, not this frame's packet
+            f64 gpuWaitTime = 0;
+            f64 presentTime = 0;
+            Renderer::FrameResult frameResult{};
+            while (mRenderer->poll_frame_result(frameResult)) {
+                // Pipeline creation dominates startup, a warm pipeline cache shows up here
+                if (!mFirstFrameDone) {
+                    mFirstFrameDone = true;
+                    MSG_INFO("Startup: first frame after {:.3f} ms, {} bytes of pipeline cache loaded",
+                             (mPlatform->getAbsoluteTime() - mStartTime) * 1000.0,
+                             mRenderer->get_statistics().pipelineCacheBytesLoaded);
+                }
+                gpuWaitTime += frameResult.timings.gpuWaitTime;
+                presentTime += frameResult.timings.presentTime;
+                mFrameStats->record(FrameStats::METRIC_RECORD_TIME, frameResult.timings.recordTime);
+                // Input to photon latency, ends when the image is queued for presentation not when it is scanned out
+                if (frameResult.presented && frameResult.inputTime > 0) {
+                    mFrameStats->record(FrameStats::METRIC_INPUT_LATENCY,
+                                        frameResult.timings.presentedTime - frameResult.inputTime);
+                } else if (!frameResult.presented && frameResult.inputTime > 0 &&
+                           (mPendingInputTime == 0 || frameResult.inputTime < mPendingInputTime)) {
+                    // Not shown yet, hand the input to the next packet
+                    mPendingInputTime = frameResult.inputTime;
+                }
+            }
+            if (!mGame.mSerialFrames) {
+                mDrawPacketIndex = mBuildPacketIndex;
+                mBuildPacketIndex = (mBuildPacketIndex + 1) % mRenderPackets.size();
+            }
+            mDrawPending = !mGame.mSerialFrames;
+
+            FrameStats::Sample frameSample{};
+            frameSample.frameTime = previousFrameStartTime > 0 ? frameStartTime - previousFrameStartTime : 0;
+            frameSample.gpuWaitTime = gpuWaitTime;
+            frameSample.presentTime = presentTime;
+            // Time spent blocked in the renderer is excluded from the CPU time, unless it was spent on the render thread
+            frameSample.cpuTime = mPlatform->getAbsoluteTime() - frameStartTime;
+            if (!mRenderer->has_render_thread()) {
+                frameSample.cpuTime -= gpuWaitTime + presentTime;
+            }
+            if (previousFrameStartTime > 0) {
+                mFrameStats->record(frameSample);
+            }
+            previousFrameStartTime = frameStartTime;
 
             // END OF FRAME
             mInputHandler->update(deltaTime);
@@ -80,23 +164,98 @@ bool Application::run() {
             deltaTime = mClock->delta_time();
             // f64 timeLeftAfterTargetFrame = targetFrameSeconds - deltaTime;
             // TODO allow state to sleep here depending on timeLeft
-            const auto SleepTime = 20;
-            mPlatform->sleep(SleepTime);
+            // Headless runs are benchmarks, there is no display to pace against
+            if (!mPlatform->isHeadless()) {
+                const auto SleepTime = 20;
+                mPlatform->sleep(SleepTime);
+            }
             MSG_TRACE("Frame and input delta: {:f}", deltaTime);
+
+            ++frameCount;
+            if (mGame.mFrameLimit > 0 && frameCount >= mGame.mFrameLimit) {
+                MSG_INFO("Frame limit of {} reached, shutting down", mGame.mFrameLimit);
+                mRunning = false;
+            }
         }
     }
 
+    // The last pipelined packet has not been drawn yet
+    if (mDrawPending && !mFrameFailed.load(std::memory_order_relaxed)) {
+        mRenderer->draw_frame(mRenderPackets[mDrawPacketIndex]);
+        mDrawPending = false;
+    }
+    mRenderer->stop_render_thread();
     mRunning = false;
 
+    MSG_INFO("{}", mFrameStats->get_report());
+    const auto& rendererStatistics = mRenderer->get_statistics();
+    MSG_INFO("Renderer: {} frames, {} draw calls, {} bytes uploaded", rendererStatistics.frameCount,
+             rendererStatistics.drawCalls, rendererStatistics.bytesUploaded);
+    MSG_INFO("GPU memory: {} bytes used of {} reserved", rendererStatistics.gpuBytesUsed,
+             rendererStatistics.gpuBytesReserved);
+    const auto jobStatistics = mJobSystem->get_statistics();
+    MSG_INFO("Jobs: {} executed, {} stolen", jobStatistics.jobsExecuted, jobStatistics.jobsStolen);
+
     mEventManager.unregister_event(EventManager::EventCode::EVENT_CODE_APPLICATION_QUIT, this, Application::on_event);
     mEventManager.unregister_event(EventManager::EventCode::EVENT_CODE_WINDOW_RESIZED, this, Application::on_event);
     mEventManager.unregister_event(EventManager::EventCode::EVENT_CODE_KEY_PRESSED, this, Application::on_key);
     mEventManager.unregister_event(EventManager::EventCode::EVENT_CODE_KEY_RELEASED, this, Application::on_key);
     mEventManager.unregister_event(EventManager::EventCode::EVENT_CODE_MOUSE_MOVED, this, Application::on_mouse_move);
 
+    mGame.mJobSystem = nullptr;
+    mJobSystem.reset();
     mPlatform->shutdown();
 
-    return true;
+    // A failed frame shuts down as well, but is reported to the caller
+    return !mFrameFailed.load(std::memory_order_relaxed);
+}
+
+void Application::build_frame_graph() {
+    mFrameGraph = std::make_unique<TaskGraph>();
+    const auto update = mFrameGraph->add_task("update", Application::update_task, this);
+    const auto build = mFrameGraph->add_task("build packet", Application::build_packet_task, this, {update});
+    if (mGame.mSerialFrames) {
+        mFrameGraph->add_task("draw", Application::draw_task, this, {build});
+    } else {
+        mFrameGraph->add_task("draw", Application::draw_task, this);
+    }
+    MSG_DEBUG("Frame graph: {} execution", mGame.mSerialFrames ? "serial" : "pipelined");
+}
+
+void Application::update_task(void* userData) {
+    auto* instance = static_cast<Application*>(userData);
+    if (!(instance->mGame.update(instance->mFrameDeltaTime))) {
+        MSG_FATAL("Game update failed! Shutting down.");
+        instance->mFrameFailed.store(true, std::memory_order_relaxed);
+    }
+}
+
+void Application::build_packet_task(void* userData) {
+    auto* instance = static_cast<Application*>(userData);
+    if (instance->mFrameFailed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (instance->mInputHandler->get_frame_sample_count() > 0 && instance->mPendingInputTime == 0) {
+        instance->mPendingInputTime = instance->mInputHandler->get_frame_sample(0).timestamp;
+    }
+    auto& packet = instance->mRenderPackets[instance->mBuildPacketIndex];
+    packet.deltaTime = instance->mFrameDeltaTime;
+    packet.inputTime = instance->mPendingInputTime;
+    packet.dispatchCommands.clear();
+    packet.drawCommands.clear();
+    instance->mPendingInputTime = 0;
+    if (!(instance->mGame.render(instance->mFrameDeltaTime, packet))) {
+        MSG_FATAL("Game render failed! Shutting down.");
+        instance->mFrameFailed.store(true, std::memory_order_relaxed);
+    }
+}
+
+void Application::draw_task(void* userData) {
+    auto* instance = static_cast<Application*>(userData);
+    if (!instance->mDrawPending || instance->mFrameFailed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    instance->mRenderer->draw_frame(instance->mRenderPackets[instance->mDrawPacketIndex]);
 }
 
 bool Application::on_event(EventManager::EventCode code, void* /*unused*/, void* listener,
@@ -135,18 +294,11 @@ bool Application::on_event(EventManager::EventCode code, void* /*unused*/, void*
     return false;
 }
 
-bool Application::on_key(EventManager::EventCode code, void* /*unused*/, void* listener,
+bool Application::on_key(EventManager::EventCode code, void* /*unused*/, void* /*unused*/,
                          EventManager::Context context) {
     //TODO: Remove/Replace some debug information here
-    auto* instance = static_cast<Application*>(listener);
     if (code == EventManager::EventCode::EVENT_CODE_KEY_PRESSED) {
         const auto keyCode = static_cast<InputHandler::Key>(context.i16[0]);
-        if (keyCode == InputHandler::Key::KEY_ESCAPE) {
-            EventManager::Context quitContext{};
-            instance->mEventManager.fire_event(EventManager::EventCode::EVENT_CODE_APPLICATION_QUIT, listener,
-                                               quitContext);
-            return true;
-        }
         if (keyCode == InputHandler::Key::KEY_A) {
             MSG_DEBUG("Explicit 'A' Key pressed");
         } else {
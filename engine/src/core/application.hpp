@@ -2,6 +2,9 @@
 
 #include "core/event.hpp"
 #include "defines.hpp"
+#include "renderer/renderer_types.hpp"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -11,6 +14,9 @@ class Game;
 class InputHandler;
 class Clock;
 class Renderer;
+class FrameStats;
+class JobSystem;
+class TaskGraph;
 
 class Application {
 public:
@@ -34,13 +40,35 @@ private:
 
     bool mRunning{false};
     bool mSuspended{false};
+    // Platform time the application started at, startup lasts until the first frame result arrives
+    f64 mStartTime{0};
+    bool mFirstFrameDone{false};
 
     std::unique_ptr<Clock> mClock;
     std::unique_ptr<Platform> mPlatform;
     Game& mGame;
     EventManager& mEventManager;
     std::unique_ptr<InputHandler> mInputHandler;
+    std::unique_ptr<JobSystem> mJobSystem;
     std::unique_ptr<Renderer> mRenderer;
+    std::unique_ptr<FrameStats> mFrameStats;
+    std::unique_ptr<TaskGraph> mFrameGraph;
+
+    // Frame N+1 is built into one packet while frame N is drawn from the other.
+    // Packets are reused so the draw lists keep their capacity between frames
+    std::array<RenderPacket, 2> mRenderPackets{};
+    size_t mBuildPacketIndex{0};
+    size_t mDrawPacketIndex{0};
+    bool mDrawPending{false};
+    f64 mFrameDeltaTime{0};
+    std::atomic<bool> mFrameFailed{false};
+    // Oldest input not yet shown by a presented frame, carried over frames that fail to render
+    f64 mPendingInputTime{0};
+
+    void build_frame_graph();
+    static void update_task(void* userData);
+    static void build_packet_task(void* userData);
+    static void draw_task(void* userData);
 
     static bool on_event(EventManager::EventCode code, void* sender, void* listener, EventManager::Context context);
     static bool on_key(EventManager::EventCode code, void* sender, void* listener, EventManager::Context context);
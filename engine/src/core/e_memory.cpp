@@ -2,6 +2,7 @@
 #include "logger.hpp"
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <string>
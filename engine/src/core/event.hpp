@@ -8,20 +8,21 @@
 class EventManager {
 public:
     struct Context {
+        // Underlying types spelled out, reusing the aliases here changes their meaning (rejected by GCC)
         union {
-            i64 i64[2];
-            u64 u64[2];
-            f64 f64[2];
+            std::int64_t i64[2];
+            std::uint64_t u64[2];
+            double f64[2];
 
-            i32 i32[2];
-            u32 u32[2];
-            f32 f32[2];
+            std::int32_t i32[2];
+            std::uint32_t u32[2];
+            float f32[2];
 
-            i16 i16[2];
-            u16 u16[2];
+            std::int16_t i16[2];
+            std::uint16_t u16[2];
 
-            i8 i8[2];
-            u8 u8[2];
+            std::int8_t i8[2];
+            std::uint8_t u8[2];
 
             char c[16];
         };
@@ -0,0 +1,105 @@
+#include "frame_stats.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+FrameStats::FrameStats() {
+    MSG_TRACE("FrameStats: {:p} created", static_cast<void*>(this));
+}
+
+void FrameStats::record(const Sample& sample) {
+    mSamples.at(METRIC_FRAME_TIME).push(sample.frameTime);
+    mSamples.at(METRIC_CPU_TIME).push(sample.cpuTime);
+    mSamples.at(METRIC_GPU_WAIT_TIME).push(sample.gpuWaitTime);
+    mSamples.at(METRIC_PRESENT_TIME).push(sample.presentTime);
+    ++mFrameCount;
+}
+
+void FrameStats::record(const Metric metric, const f64 seconds) {
+    mSamples.at(metric).push(seconds);
+}
+
+void FrameStats::reset() {
+    for (auto& samples : mSamples) {
+        samples.clear();
+    }
+    mFrameCount = 0;
+}
+
+FrameStats::Summary FrameStats::get_summary(const Metric metric) const {
+    const auto& samples = mSamples.at(metric);
+    Summary summary{};
+    summary.sampleCount = samples.size();
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::vector<f64> sorted(samples.size());
+    f64 total{0};
+    for (size_t i = 0; i < samples.size(); ++i) {
+        sorted[i] = samples[i];
+        total += samples[i];
+    }
+    std::ranges::sort(sorted);
+
+    // Nearest-rank percentile
+    const auto percentile = [&sorted](f64 fraction) {
+        const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<f64>(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    };
+
+    summary.average = total / static_cast<f64>(sorted.size());
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    summary.max = sorted.back();
+    return summary;
+}
+
+FrameStats::Histogram FrameStats::get_histogram(const Metric metric, const f64 bucketWidth) const {
+    Histogram histogram{};
+    histogram.bucketWidth = bucketWidth;
+    if (bucketWidth <= 0) {
+        MSG_WARN("Histogram requested with non-positive bucket width: {}", bucketWidth);
+        return histogram;
+    }
+
+    const auto& samples = mSamples.at(metric);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto bucket = static_cast<size_t>(std::max(samples[i], 0.0) / bucketWidth);
+        ++histogram.buckets.at(std::min(bucket, HISTOGRAM_BUCKET_COUNT - 1));
+    }
+    return histogram;
+}
+
+std::string FrameStats::get_report() const {
+    const f64 millisecondsPerSecond = 1000.0;
+    const auto outputWidth = 10;
+
+    std::ostringstream stringStream;
+    stringStream << "Frame statistics (last " << mSamples.at(METRIC_FRAME_TIME).size() << " of " << mFrameCount
+                 << " frames, ms): \n";
+    stringStream << std::fixed << std::setprecision(3);
+
+    for (size_t metric = 0; metric < METRIC_MAX_METRICS; ++metric) {
+        const auto summary = get_summary(static_cast<Metric>(metric));
+        stringStream << "  " << std::left << std::setw(outputWidth) << metricNames.at(metric) << ": avg "
+                     << summary.average * millisecondsPerSecond << " p50 " << summary.p50 * millisecondsPerSecond
+                     << " p95 " << summary.p95 * millisecondsPerSecond << " p99 "
+                     << summary.p99 * millisecondsPerSecond << " max " << summary.max * millisecondsPerSecond << "\n";
+    }
+
+    const auto histogram = get_histogram(METRIC_FRAME_TIME);
+    stringStream << "  Frame time histogram: \n";
+    for (size_t bucket = 0; bucket < HISTOGRAM_BUCKET_COUNT; ++bucket) {
+        const f64 bucketStart = static_cast<f64>(bucket) * histogram.bucketWidth * millisecondsPerSecond;
+        stringStream << "    " << std::right << std::setw(outputWidth) << bucketStart
+                     << (bucket + 1 == HISTOGRAM_BUCKET_COUNT ? "+ : " : "  : ") << histogram.buckets.at(bucket)
+                     << "\n";
+    }
+
+    return stringStream.str();
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "core/ring_buffer.hpp"
+#include "defines.hpp"
+#include <array>
+#include <string>
+
+// Rolling per-frame timing statistics, all values are recorded in seconds.
+class FrameStats {
+public:
+    enum Metric {
+        METRIC_FRAME_TIME,
+        METRIC_CPU_TIME,
+        METRIC_GPU_WAIT_TIME,
+        METRIC_PRESENT_TIME,
+        // Recorded for every drawn frame, with a render thread independently of the frame loop
+        METRIC_RECORD_TIME,
+        // Recorded only for frames that consumed input
+        METRIC_INPUT_LATENCY,
+
+        METRIC_MAX_METRICS
+    };
+
+    static constexpr size_t SAMPLE_CAPACITY = 1024;
+    static constexpr size_t HISTOGRAM_BUCKET_COUNT = 16;
+    static constexpr f64 DEFAULT_HISTOGRAM_BUCKET_WIDTH = 0.002;
+    static constexpr std::array metricNames{"Frame", "CPU", "GPU wait", "Present", "Record", "Input"};
+    static_assert(metricNames.size() == METRIC_MAX_METRICS);
+
+    struct Sample {
+        f64 frameTime{0};
+        f64 cpuTime{0};
+        f64 gpuWaitTime{0};
+        f64 presentTime{0};
+    };
+
+    struct Summary {
+        size_t sampleCount{0};
+        f64 average{0};
+        f64 p50{0};
+        f64 p95{0};
+        f64 p99{0};
+        f64 max{0};
+    };
+
+    // Fixed width buckets starting at zero, the last bucket also holds every sample beyond it
+    struct Histogram {
+        f64 bucketWidth{0};
+        std::array<u32, HISTOGRAM_BUCKET_COUNT> buckets{};
+    };
+
+    DLL_EXPORT FrameStats();
+
+    void record(const Sample& sample);
+    void record(Metric metric, f64 seconds);
+    DLL_EXPORT void reset();
+
+    [[nodiscard]] DLL_EXPORT Summary get_summary(Metric metric) const;
+    [[nodiscard]] DLL_EXPORT Histogram get_histogram(Metric metric,
+                                                     f64 bucketWidth = DEFAULT_HISTOGRAM_BUCKET_WIDTH) const;
+    [[nodiscard]] DLL_EXPORT std::string get_report() const;
+    [[nodiscard]] u64 get_frame_count() const {
+        return mFrameCount;
+    }
+
+private:
+    std::array<RingBuffer<f64, SAMPLE_CAPACITY>, METRIC_MAX_METRICS> mSamples{};
+    u64 mFrameCount{0};
+};
\ No newline at end of file
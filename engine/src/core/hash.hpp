@@ -0,0 +1,36 @@
+#pragma once
+
+#include "defines.hpp"
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+// 64 bit FNV-1a, for cache keys and checksums, not for anything facing untrusted input.
+// Hashes chain by passing the previous hash as the seed.
+namespace hash {
+    constexpr u64 FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    constexpr u64 FNV_PRIME = 1099511628211ULL;
+
+    [[nodiscard]] inline u64 fnv1a(const void* data, size_t size, u64 seed = FNV_OFFSET_BASIS) {
+        const auto* bytes = static_cast<const u8*>(data);
+        u64 result = seed;
+        for (size_t i = 0; i < size; ++i) {
+            result = (result ^ bytes[i]) * FNV_PRIME;
+        }
+        return result;
+    }
+
+    [[nodiscard]] inline u64 fnv1a(std::string_view text, u64 seed = FNV_OFFSET_BASIS) {
+        // The length keeps "ab" + "c" apart from "a" + "bc"
+        const size_t length = text.size();
+        return fnv1a(text.data(), text.size(), fnv1a(&length, sizeof(length), seed));
+    }
+
+    // Trivially copyable values without padding only, padding bytes are indeterminate
+    template <typename T>
+    [[nodiscard]] u64 fnv1a_value(const T& value, u64 seed = FNV_OFFSET_BASIS) {
+        static_assert(std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>,
+                      "Hashed values must not contain padding");
+        return fnv1a(&value, sizeof(value), seed);
+    }
+}  // namespace hash
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "input.hpp"
+#include "core/asserts.hpp"
 #include "core/event.hpp"
 #include "core/logger.hpp"
 #include "logger.hpp"
+#include <algorithm>
 
 InputHandler::InputHandler(EventManager& eventManager) : mEventManager{&eventManager} {
     MSG_TRACE("Inputhandler: {:p} created", static_cast<void*>(this));
@@ -9,12 +11,27 @@ InputHandler::InputHandler(EventManager& eventManager) : mEventManager{&eventMan
 
 void InputHandler::update(f64 /*unused*/) {
     mInputState.previousKeyBoardState = mInputState.currentKeyBoardState;
-    mInputState.currentMouseState = mInputState.currentMouseState;
+    mInputState.previousMouseState = mInputState.currentMouseState;
+
+    mFrameSampleCount = 0;
+    ++mFrame;
+}
+
+void InputHandler::record_sample(const InputSample& sample) {
+    mSamples.push(sample);
+    // Samples older than the ring buffer capacity are lost, even if they arrived this frame
+    mFrameSampleCount = std::min(mFrameSampleCount + 1, mSamples.size());
 }
 
-void InputHandler::process_key(const Key key, const bool pressed) {
-    if (mInputState.currentKeyBoardState.keys.at(key) != pressed) {
-        mInputState.currentKeyBoardState.keys.at(key) = pressed;
+void InputHandler::process_key(const Key key, const bool pressed, const f64 timestamp) {
+    record_sample({.timestamp = timestamp,
+                   .frame = mFrame,
+                   .type = InputSample::Type::KEY,
+                   .pressed = pressed,
+                   .code = static_cast<i16>(key)});
+
+    if (mInputState.currentKeyBoardState.keys.test(key) != pressed) {
+        mInputState.currentKeyBoardState.keys.set(key, pressed);
 
         EventManager::Context eventContext{};
         eventContext.i16[0] = static_cast<i16>(key);
@@ -23,9 +40,15 @@ void InputHandler::process_key(const Key key, const bool pressed) {
     }
 }
 
-void InputHandler::process_button(const Button button, const bool pressed) {
-    if (mInputState.currentMouseState.buttons.at(button) != pressed) {
-        mInputState.currentMouseState.buttons.at(button) = pressed;
+void InputHandler::process_button(const Button button, const bool pressed, const f64 timestamp) {
+    record_sample({.timestamp = timestamp,
+                   .frame = mFrame,
+                   .type = InputSample::Type::BUTTON,
+                   .pressed = pressed,
+                   .code = static_cast<i16>(button)});
+
+    if (mInputState.currentMouseState.buttons.test(button) != pressed) {
+        mInputState.currentMouseState.buttons.set(button, pressed);
 
         EventManager::Context eventContext{};
         eventContext.i16[0] = static_cast<i16>(button);
@@ -33,7 +56,13 @@ void InputHandler::process_button(const Button button, const bool pressed) {
                                   this, eventContext);
     }
 }
-void InputHandler::process_mouse_move(const i16 x, const i16 y) {
+void InputHandler::process_mouse_move(const i16 x, const i16 y, const f64 timestamp) {
+    record_sample({.timestamp = timestamp,
+                   .frame = mFrame,
+                   .type = InputSample::Type::MOUSE_MOVE,
+                   .x = x,
+                   .y = y});
+
     if (mInputState.currentMouseState.x != x || mInputState.currentMouseState.y != y) {
         mInputState.currentMouseState.x = x;
         mInputState.currentMouseState.y = y;
@@ -46,7 +75,12 @@ void InputHandler::process_mouse_move(const i16 x, const i16 y) {
                                   this, eventContext);
     }
 }
-void InputHandler::process_mouse_wheel(const i8 z_delta) {
+void InputHandler::process_mouse_wheel(const i8 z_delta, const f64 timestamp) {
+    record_sample({.timestamp = timestamp,
+                   .frame = mFrame,
+                   .type = InputSample::Type::MOUSE_WHEEL,
+                   .code = z_delta});
+
     // No internal state for now
     EventManager::Context eventContext{};
     eventContext.i8[0] = z_delta;
@@ -54,38 +88,70 @@ void InputHandler::process_mouse_wheel(const i8 z_delta) {
                               this, eventContext);
 }
 
-bool InputHandler::is_key_down(const Key key) {
-    return mInputState.currentKeyBoardState.keys.at(key);
+bool InputHandler::is_key_down(const Key key) const {
+    return mInputState.currentKeyBoardState.keys.test(key);
 }
 
-bool InputHandler::is_key_up(const Key key) {
+bool InputHandler::is_key_up(const Key key) const {
     return !is_key_down(key);
 }
 
-bool InputHandler::was_key_down(const Key key) {
-    return mInputState.previousKeyBoardState.keys.at(key);
+bool InputHandler::was_key_down(const Key key) const {
+    return mInputState.previousKeyBoardState.keys.test(key);
 }
 
-bool InputHandler::was_key_up(const Key key) {
+bool InputHandler::was_key_up(const Key key) const {
     return !was_key_down(key);
 }
 
-bool InputHandler::is_button_down(const Button button) {
-    return mInputState.currentMouseState.buttons.at(button);
+bool InputHandler::was_key_pressed(const Key key) const {
+    return is_key_down(key) && was_key_up(key);
 }
 
-bool InputHandler::is_button_up(const Button button) {
+bool InputHandler::was_key_released(const Key key) const {
+    return is_key_up(key) && was_key_down(key);
+}
+
+InputHandler::KeySet InputHandler::get_pressed_keys() const {
+    return mInputState.currentKeyBoardState.keys & ~mInputState.previousKeyBoardState.keys;
+}
+
+InputHandler::KeySet InputHandler::get_released_keys() const {
+    return ~mInputState.currentKeyBoardState.keys & mInputState.previousKeyBoardState.keys;
+}
+
+bool InputHandler::is_button_down(const Button button) const {
+    return mInputState.currentMouseState.buttons.test(button);
+}
+
+bool InputHandler::is_button_up(const Button button) const {
     return !is_button_down(button);
 }
 
-bool InputHandler::was_button_down(const Button button) {
-    return mInputState.previousMouseState.buttons.at(button);
+bool InputHandler::was_button_down(const Button button) const {
+    return mInputState.previousMouseState.buttons.test(button);
 }
 
-bool InputHandler::was_button_up(const Button button) {
+bool InputHandler::was_button_up(const Button button) const {
     return !was_button_down(button);
 }
 
+bool InputHandler::was_button_pressed(const Button button) const {
+    return is_button_down(button) && was_button_up(button);
+}
+
+bool InputHandler::was_button_released(const Button button) const {
+    return is_button_up(button) && was_button_down(button);
+}
+
+InputHandler::ButtonSet InputHandler::get_pressed_buttons() const {
+    return mInputState.currentMouseState.buttons & ~mInputState.previousMouseState.buttons;
+}
+
+InputHandler::ButtonSet InputHandler::get_released_buttons() const {
+    return ~mInputState.currentMouseState.buttons & mInputState.previousMouseState.buttons;
+}
+
 void InputHandler::get_mouse_position(i32& x, i32& y) const {
     x = mInputState.currentMouseState.x;
     y = mInputState.currentMouseState.y;
@@ -94,4 +160,13 @@ void InputHandler::get_mouse_position(i32& x, i32& y) const {
 void InputHandler::get_previous_mouse_position(i32& x, i32& y) const {
     x = mInputState.previousMouseState.x;
     y = mInputState.previousMouseState.y;
+}
+
+size_t InputHandler::get_frame_sample_count() const {
+    return mFrameSampleCount;
+}
+
+const InputHandler::InputSample& InputHandler::get_frame_sample(const size_t index) const {
+    ENGINE_ASSERT(index < mFrameSampleCount);
+    return mSamples[mSamples.size() - mFrameSampleCount + index];
 }
\ No newline at end of file
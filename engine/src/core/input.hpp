@@ -1,7 +1,8 @@
 #pragma once
 
+#include "core/ring_buffer.hpp"
 #include "defines.hpp"
-#include <array>
+#include <bitset>
 
 class EventManager;
 
@@ -146,39 +147,96 @@ public:
         KEYS_MAX_KEYS
     };
 
+    // One bit per key/button, edges for every key are computed with a few word wide operations
+    using KeySet = std::bitset<Key::KEYS_MAX_KEYS>;
+    using ButtonSet = std::bitset<Button::BUTTON_MAX_BUTTONS>;
+
+    // Raw input as received from the platform, before it is folded into the key/button state
+    struct InputSample {
+        enum class Type : u8 {
+            KEY,
+            BUTTON,
+            MOUSE_MOVE,
+            MOUSE_WHEEL
+        };
+
+        f64 timestamp{0};  // Platform absolute time the input was received at
+        u64 frame{0};
+        Type type{Type::KEY};
+        bool pressed{false};
+        i16 code{0};  // Key, button or wheel delta
+        i16 x{0};
+        i16 y{0};
+    };
+
+    static constexpr size_t INPUT_SAMPLE_CAPACITY = 1024;
+
     InputHandler(EventManager& eventManager);
 
+    // Called at the end of every frame, the current state becomes the previous state
     void update(f64 delta_time);
 
-    void process_key(Key key, bool pressed);
+    void process_key(Key key, bool pressed, f64 timestamp);
 
-    void process_button(Button button, bool pressed);
-    void process_mouse_move(i16 x, i16 y);
-    void process_mouse_wheel(i8 z_delta);
+    void process_button(Button button, bool pressed, f64 timestamp);
+    void process_mouse_move(i16 x, i16 y, f64 timestamp);
+    void process_mouse_wheel(i8 z_delta, f64 timestamp);
 
     // keyboard input
-    DLL_EXPORT bool is_key_down(Key key);
-    DLL_EXPORT bool is_key_up(Key key);
-    DLL_EXPORT bool was_key_down(Key key);
-    DLL_EXPORT bool was_key_up(Key key);
+    DLL_EXPORT bool is_key_down(Key key) const;
+    DLL_EXPORT bool is_key_up(Key key) const;
+    DLL_EXPORT bool was_key_down(Key key) const;
+    DLL_EXPORT bool was_key_up(Key key) const;
+    // Went down/up since the last update()
+    DLL_EXPORT bool was_key_pressed(Key key) const;
+    DLL_EXPORT bool was_key_released(Key key) const;
+    DLL_EXPORT KeySet get_pressed_keys() const;
+    DLL_EXPORT KeySet get_released_keys() const;
 
     // mouse input
-    DLL_EXPORT bool is_button_down(Button button);
-    DLL_EXPORT bool is_button_up(Button button);
-    DLL_EXPORT bool was_button_down(Button button);
-    DLL_EXPORT bool was_button_up(Button button);
+    DLL_EXPORT bool is_button_down(Button button) const;
+    DLL_EXPORT bool is_button_up(Button button) const;
+    DLL_EXPORT bool was_button_down(Button button) const;
+    DLL_EXPORT bool was_button_up(Button button) const;
+    DLL_EXPORT bool was_button_pressed(Button button) const;
+    DLL_EXPORT bool was_button_released(Button button) const;
+    DLL_EXPORT ButtonSet get_pressed_buttons() const;
+    DLL_EXPORT ButtonSet get_released_buttons() const;
     DLL_EXPORT void get_mouse_position(i32& x, i32& y) const;
     DLL_EXPORT void get_previous_mouse_position(i32& x, i32& y) const;
 
+    // Whole state access for bulk queries such as the action mapping
+    [[nodiscard]] const KeySet& get_keys() const {
+        return mInputState.currentKeyBoardState.keys;
+    }
+    [[nodiscard]] const KeySet& get_previous_keys() const {
+        return mInputState.previousKeyBoardState.keys;
+    }
+    [[nodiscard]] const ButtonSet& get_buttons() const {
+        return mInputState.currentMouseState.buttons;
+    }
+    [[nodiscard]] const ButtonSet& get_previous_buttons() const {
+        return mInputState.previousMouseState.buttons;
+    }
+
+    // Raw samples received this frame in arrival order, a press and release within a single
+    // frame shows up here even though the key state does not change
+    DLL_EXPORT size_t get_frame_sample_count() const;
+    DLL_EXPORT const InputSample& get_frame_sample(size_t index) const;
+    // The last INPUT_SAMPLE_CAPACITY samples over all frames
+    [[nodiscard]] const RingBuffer<InputSample, INPUT_SAMPLE_CAPACITY>& get_samples() const {
+        return mSamples;
+    }
+
 private:
     struct KeyboardState {
-        std::array<bool, Key::KEYS_MAX_KEYS> keys;
+        KeySet keys;
     };
 
     struct MouseState {
         i16 x;
         i16 y;
-        std::array<bool, Button::BUTTON_MAX_BUTTONS> buttons;
+        ButtonSet buttons;
     };
 
     struct InputState {
@@ -190,4 +248,10 @@ private:
 
     InputState mInputState{};
     EventManager* mEventManager;
+
+    RingBuffer<InputSample, INPUT_SAMPLE_CAPACITY> mSamples;
+    size_t mFrameSampleCount{0};
+    u64 mFrame{0};
+
+    void record_sample(const InputSample& sample);
 };
\ No newline at end of file
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "core/input.hpp"
+#include "defines.hpp"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+
+// Maps game defined actions ("Jump") and axes ("MoveX") onto keys and mouse buttons.
+//
+// Bindings are declared in constexpr tables and compiled into fixed size per action/axis slot arrays,
+// resolving an action is a few indexed bit loads into the input state. Action and axis ids are the
+// game's own enum values. Everything is stored inline, rebinding at runtime never allocates.
+//
+//   enum Action { ACTION_JUMP };
+//   enum Axis { AXIS_MOVE_X };
+//   constexpr std::array actions{InputMapping::ActionBinding{ACTION_JUMP, InputMapping::key(InputHandler::KEY_SPACE)}};
+//   constexpr std::array axes{InputMapping::AxisBinding{AXIS_MOVE_X, InputMapping::key(InputHandler::KEY_D), 1.0F},
+//                             InputMapping::AxisBinding{AXIS_MOVE_X, InputMapping::key(InputHandler::KEY_A), -1.0F}};
+//   constexpr InputMapping defaultMapping{actions, axes};
+class InputMapping {
+public:
+    static constexpr size_t MAX_ACTIONS = 64;
+    static constexpr size_t MAX_AXES = 16;
+    static constexpr size_t MAX_BINDINGS_PER_ACTION = 4;
+    static constexpr size_t MAX_BINDINGS_PER_AXIS = 4;
+
+    struct Binding {
+        enum class Source : u8 {
+            NONE,
+            KEY,
+            BUTTON
+        };
+
+        Source source{Source::NONE};
+        u8 code{0};
+
+        [[nodiscard]] constexpr bool is_bound() const {
+            return source != Source::NONE;
+        }
+        constexpr bool operator==(const Binding&) const = default;
+    };
+
+    struct ActionBinding {
+        u32 action{0};
+        Binding binding;
+    };
+
+    struct AxisBinding {
+        u32 axis{0};
+        Binding binding;
+        f32 scale{1.0F};  // Contribution to the axis value while the binding is held
+    };
+
+    static_assert(InputHandler::Key::KEYS_MAX_KEYS <= 256 && InputHandler::Button::BUTTON_MAX_BUTTONS <= 256,
+                  "Binding codes are stored as u8");
+
+    [[nodiscard]] static constexpr Binding key(InputHandler::Key key) {
+        return {Binding::Source::KEY, static_cast<u8>(key)};
+    }
+    [[nodiscard]] static constexpr Binding button(InputHandler::Button button) {
+        return {Binding::Source::BUTTON, static_cast<u8>(button)};
+    }
+
+    constexpr InputMapping() = default;
+    // Invalid tables (unknown ids, too many bindings for one slot) fail to compile when evaluated as constexpr
+    constexpr InputMapping(std::span<const ActionBinding> actions, std::span<const AxisBinding> axes) {
+        for (const auto& actionBinding : actions) {
+            if (!bind_action(actionBinding.action, actionBinding.binding)) {
+                throw std::invalid_argument("Invalid action binding table");
+            }
+        }
+        for (const auto& axisBinding : axes) {
+            if (!bind_axis(axisBinding.axis, axisBinding.binding, axisBinding.scale)) {
+                throw std::invalid_argument("Invalid axis binding table");
+            }
+        }
+    }
+
+    // Runtime rebinding, returns false when the id is out of range or its binding slots are full
+    constexpr bool bind_action(u32 action, Binding binding) {
+        if (action >= MAX_ACTIONS || !binding.is_bound()) {
+            return false;
+        }
+        auto& slots = mActions[action];
+        auto freeSlot = std::ranges::find_if(slots, [](const Binding& slot) { return !slot.is_bound(); });
+        if (freeSlot == slots.end()) {
+            return false;
+        }
+        *freeSlot = binding;
+        return true;
+    }
+    constexpr void unbind_action(u32 action, Binding binding) {
+        if (action < MAX_ACTIONS) {
+            std::ranges::replace(mActions[action], binding, Binding{});
+        }
+    }
+    constexpr void clear_action(u32 action) {
+        if (action < MAX_ACTIONS) {
+            mActions[action].fill(Binding{});
+        }
+    }
+
+    constexpr bool bind_axis(u32 axis, Binding binding, f32 scale) {
+        if (axis >= MAX_AXES || !binding.is_bound()) {
+            return false;
+        }
+        auto& slots = mAxes[axis];
+        auto freeSlot = std::ranges::find_if(slots, [](const AxisSlot& slot) { return !slot.binding.is_bound(); });
+        if (freeSlot == slots.end()) {
+            return false;
+        }
+        *freeSlot = {binding, scale};
+        return true;
+    }
+    constexpr void unbind_axis(u32 axis, Binding binding) {
+        if (axis < MAX_AXES) {
+            std::ranges::replace_if(
+                mAxes[axis], [&binding](const AxisSlot& slot) { return slot.binding == binding; }, AxisSlot{});
+        }
+    }
+    constexpr void clear_axis(u32 axis) {
+        if (axis < MAX_AXES) {
+            mAxes[axis].fill(AxisSlot{});
+        }
+    }
+
+    // An action is down while any of its bindings is held
+    [[nodiscard]] bool is_action_down(const InputHandler& input, u32 action) const {
+        return action < MAX_ACTIONS && any_down(mActions[action], input.get_keys(), input.get_buttons());
+    }
+    [[nodiscard]] bool was_action_down(const InputHandler& input, u32 action) const {
+        return action < MAX_ACTIONS &&
+            any_down(mActions[action], input.get_previous_keys(), input.get_previous_buttons());
+    }
+    [[nodiscard]] bool was_action_pressed(const InputHandler& input, u32 action) const {
+        return is_action_down(input, action) && !was_action_down(input, action);
+    }
+    [[nodiscard]] bool was_action_released(const InputHandler& input, u32 action) const {
+        return !is_action_down(input, action) && was_action_down(input, action);
+    }
+
+    // Sum of the scales of every held binding, clamped to [-1, 1]
+    [[nodiscard]] f32 get_axis(const InputHandler& input, u32 axis) const {
+        if (axis >= MAX_AXES) {
+            return 0.0F;
+        }
+        const auto& keys = input.get_keys();
+        const auto& buttons = input.get_buttons();
+        f32 value = 0.0F;
+        for (const auto& slot : mAxes[axis]) {
+            if (is_down(slot.binding, keys, buttons)) {
+                value += slot.scale;
+            }
+        }
+        return std::clamp(value, -1.0F, 1.0F);
+    }
+
+    [[nodiscard]] constexpr const std::array<Binding, MAX_BINDINGS_PER_ACTION>& get_action_bindings(u32 action) const {
+        return mActions.at(action);
+    }
+
+private:
+    struct AxisSlot {
+        Binding binding;
+        f32 scale{0.0F};
+    };
+
+    std::array<std::array<Binding, MAX_BINDINGS_PER_ACTION>, MAX_ACTIONS> mActions{};
+    std::array<std::array<AxisSlot, MAX_BINDINGS_PER_AXIS>, MAX_AXES> mAxes{};
+
+    [[nodiscard]] static bool is_down(const Binding& binding, const InputHandler::KeySet& keys,
+                                      const InputHandler::ButtonSet& buttons) {
+        switch (binding.source) {
+            case Binding::Source::KEY:
+                return binding.code < keys.size() && keys[binding.code];
+            case Binding::Source::BUTTON:
+                return binding.code < buttons.size() && buttons[binding.code];
+            case Binding::Source::NONE:
+                break;
+        }
+        return false;
+    }
+
+    [[nodiscard]] static bool any_down(const std::array<Binding, MAX_BINDINGS_PER_ACTION>& slots,
+                                       const InputHandler::KeySet& keys, const InputHandler::ButtonSet& buttons) {
+        return std::ranges::any_of(slots, [&](const Binding& binding) { return is_down(binding, keys, buttons); });
+    }
+};
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "job_system.hpp"
+#include "core/asserts.hpp"
+#include "core/logger.hpp"
+#include "platform/fiber.hpp"
+#include <algorithm>
+
+namespace {
+    // Identifies the job system and worker the current thread belongs to
+    thread_local const JobSystem* tJobSystem{nullptr};
+    thread_local u32 tWorkerIndex{0};
+
+    constexpr u32 IDLE_SPIN_COUNT = 64;
+}  // namespace
+
+JobSystem::JobSystem(u32 workerThreadCount, u32 fiberCount) {
+    mWorkers.reserve(workerThreadCount + 1);
+    for (u32 i = 0; i < workerThreadCount + 1; ++i) {
+        mWorkers.push_back(std::make_unique<Worker>());
+        mWorkers.back()->nextVictim = i + 1;
+    }
+
+    tJobSystem = this;
+    tWorkerIndex = 0;
+
+    if (fiberCount > 0) {
+        // Every worker holds a fiber while idle, keep some for suspended jobs on top of that
+        fiberCount = std::max(fiberCount, 2 * (workerThreadCount + 1));
+        mFibers.reserve(fiberCount);
+        mFreeFibers.reserve(fiberCount);
+        // Every fiber and thread can be waiting at the same time, reserved so suspending never allocates
+        mWaitingFibers.reserve(fiberCount + workerThreadCount + 1);
+        for (u32 i = 0; i < fiberCount; ++i) {
+            mFibers.push_back(std::make_unique<Fiber>(&JobSystem::fiber_main, this));
+            mFreeFibers.push_back(mFibers.back().get());
+        }
+        mWorkers[0]->threadFiber = std::make_unique<Fiber>();
+        mWorkers[0]->currentFiber = mWorkers[0]->threadFiber.get();
+    }
+
+    mThreads.reserve(workerThreadCount);
+    for (u32 i = 1; i <= workerThreadCount; ++i) {
+        mThreads.emplace_back(&JobSystem::worker_main, this, i);
+    }
+    MSG_INFO("Job system started with {} worker threads and {} fibers", workerThreadCount, mFibers.size());
+    MSG_TRACE("JobSystem: {:p} created", static_cast<void*>(this));
+}
+
+JobSystem::~JobSystem() {
+    mRunning.store(false, std::memory_order_release);
+    wake_workers();
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+
+    if (tJobSystem == this) {
+        tJobSystem = nullptr;
+    }
+    MSG_TRACE("JobSystem: {:p} destroyed", static_cast<void*>(this));
+}
+
+void JobSystem::run(std::span<const JobDeclaration> jobs, JobCounter& counter) {
+    if (jobs.empty()) {
+        return;
+    }
+    auto& worker = *mWorkers[get_worker_index()];
+    counter.mRemaining.fetch_add(static_cast<u32>(jobs.size()), std::memory_order_relaxed);
+
+    for (const auto& declaration : jobs) {
+        ENGINE_ASSERT(declaration.function != nullptr);
+        Job* job = allocate_job(worker);
+        if (job == nullptr) {
+            // Pool full, doing the work here is still correct and relieves the pressure
+            execute(declaration, counter);
+            continue;
+        }
+        job->function = declaration.function;
+        job->userData = declaration.userData;
+        job->counter = &counter;
+        job->queued.store(true, std::memory_order_relaxed);
+        // The deque holds at most as many jobs as the pool, a free slot guarantees room
+        [[maybe_unused]] const bool pushed = worker.queue.push(job);
+        ENGINE_ASSERT(pushed);
+    }
+
+    wake_workers();
+}
+
+void JobSystem::run(const JobDeclaration& job, JobCounter& counter) {
+    run(std::span{&job, 1}, counter);
+}
+
+void JobSystem::wait(const JobCounter& counter) {
+    if (counter.is_done()) {
+        return;
+    }
+
+    const u32 workerIndex = get_worker_index();
+    if (uses_fibers()) {
+        Fiber* next = take_ready_fiber(workerIndex);
+        if (next == nullptr) {
+            next = acquire_fiber();
+        }
+        if (next != nullptr) {
+            auto& worker = *mWorkers[workerIndex];
+            const bool isThreadFiber = worker.currentFiber == worker.threadFiber.get();
+            worker.fiberToWait = {worker.currentFiber, &counter, isThreadFiber ? workerIndex : ANY_WORKER};
+            switch_to_fiber(next);
+            // Resumed, possibly on another thread, once the counter was done
+            return;
+        }
+        // Every fiber is suspended, fall back to running jobs nested on this stack
+    }
+
+    while (!counter.is_done()) {
+        if (Job* job = find_job(workerIndex)) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+JobSystem::Statistics JobSystem::get_statistics() const {
+    Statistics statistics{};
+    for (const auto& worker : mWorkers) {
+        statistics.jobsExecuted += worker->jobsExecuted.load(std::memory_order_relaxed);
+        statistics.jobsStolen += worker->jobsStolen.load(std::memory_order_relaxed);
+        statistics.fiberSwitches += worker->fiberSwitches.load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
+u32 JobSystem::get_default_worker_count() {
+    // hardware_concurrency() may report 0 when unknown
+    return std::max(std::thread::hardware_concurrency(), 2U) - 1;
+}
+
+void JobSystem::worker_main(u32 workerIndex) {
+    tJobSystem = this;
+    tWorkerIndex = workerIndex;
+    auto& worker = *mWorkers[workerIndex];
+
+    if (uses_fibers()) {
+        worker.threadFiber = std::make_unique<Fiber>();
+        worker.currentFiber = worker.threadFiber.get();
+        Fiber* fiber = acquire_fiber();
+        ENGINE_ASSERT_MESSAGE(fiber != nullptr, "Fiber pool too small for the worker threads");
+        // Only returns once the job system shuts down
+        switch_to_fiber(fiber);
+        worker.threadFiber.reset();
+        return;
+    }
+
+    while (mRunning.load(std::memory_order_acquire)) {
+        // Read the epoch before looking for work, jobs queued after the search wake us up again
+        const u32 epoch = mWorkEpoch.load(std::memory_order_acquire);
+
+        bool foundWork = false;
+        for (u32 spin = 0; spin < IDLE_SPIN_COUNT; ++spin) {
+            if (Job* job = find_job(workerIndex)) {
+                execute(job);
+                foundWork = true;
+                break;
+            }
+            std::this_thread::yield();
+        }
+
+        if (!foundWork) {
+            mWorkEpoch.wait(epoch, std::memory_order_acquire);
+        }
+    }
+}
+
+bool JobSystem::is_job_thread() const {
+    return tJobSystem == this;
+}
+
+u32 JobSystem::get_current_thread_index() const {
+    return get_worker_index();
+}
+
+u32 JobSystem::get_worker_index() const {
+    ENGINE_ASSERT_MESSAGE(tJobSystem == this, "Jobs can only be submitted and waited on from job system threads");
+    return tWorkerIndex;
+}
+
+JobSystem::Job* JobSystem::allocate_job(Worker& worker) {
+    for (size_t attempt = 0; attempt < MAX_JOBS_PER_THREAD; ++attempt) {
+        Job* job = &worker.jobs[worker.nextJob++ % MAX_JOBS_PER_THREAD];
+        if (!job->queued.load(std::memory_order_acquire)) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+JobSystem::Job* JobSystem::find_job(u32 workerIndex) {
+    auto& worker = *mWorkers[workerIndex];
+    Job* job = nullptr;
+    if (worker.queue.pop(job)) {
+        return job;
+    }
+
+    // Steal round robin, continuing from the last victim spreads the thieves over the queues
+    const auto workerCount = static_cast<u32>(mWorkers.size());
+    for (u32 attempt = 1; attempt < workerCount; ++attempt) {
+        const u32 victim = worker.nextVictim++ % workerCount;
+        if (victim == workerIndex) {
+            continue;
+        }
+        if (mWorkers[victim]->queue.steal(job)) {
+            worker.jobsStolen.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job) {
+    // Copied out so the slot can be reused by its owner as soon as the job runs
+    const JobDeclaration declaration{job->function, job->userData};
+    JobCounter& counter = *job->counter;
+    job->queued.store(false, std::memory_order_release);
+    execute(declaration, counter);
+}
+
+void JobSystem::execute(const JobDeclaration& declaration, JobCounter& counter) {
+    declaration.function(declaration.userData);
+    // Sequentially consistent with the waiter registration in finish_fiber_switch(), either the waiter sees
+    // the counter done or we see the waiter and wake the workers
+    const bool counterDone = counter.mRemaining.fetch_sub(1, std::memory_order_seq_cst) == 1;
+    if (counterDone && mWaitingFiberCount.load(std::memory_order_seq_cst) > 0) {
+        wake_workers();
+    }
+    mWorkers[get_worker_index()]->jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JobSystem::wake_workers() {
+    mWorkEpoch.fetch_add(1, std::memory_order_release);
+    mWorkEpoch.notify_all();
+}
+
+void JobSystem::fiber_main(void* userData) {
+    static_cast<JobSystem*>(userData)->scheduler_loop();
+}
+
+void JobSystem::scheduler_loop() {
+    finish_fiber_switch();
+
+    while (mRunning.load(std::memory_order_acquire)) {
+        const u32 epoch = mWorkEpoch.load(std::memory_order_acquire);
+
+        bool foundWork = false;
+        for (u32 spin = 0; spin < IDLE_SPIN_COUNT && !foundWork; ++spin) {
+            // The worker can change whenever a job suspends, look it up every time
+            const u32 workerIndex = get_worker_index();
+            // Resuming suspended jobs first finishes work that is already under way
+            if (Fiber* ready = take_ready_fiber(workerIndex)) {
+                auto& worker = *mWorkers[workerIndex];
+                worker.fiberToRelease = worker.currentFiber;
+                switch_to_fiber(ready);
+                foundWork = true;
+            } else if (Job* job = find_job(workerIndex)) {
+                execute(job);
+                foundWork = true;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        if (!foundWork) {
+            mWorkEpoch.wait(epoch, std::memory_order_acquire);
+        }
+    }
+
+    // Shutting down, no jobs are left so every fiber still running is idle in this loop
+    auto& worker = *mWorkers[get_worker_index()];
+    worker.fiberToRelease = worker.currentFiber;
+    switch_to_fiber(worker.threadFiber.get());
+    ENGINE_ASSERT_MESSAGE(false, "Released fiber resumed after shutdown");
+}
+
+Fiber* JobSystem::acquire_fiber() {
+    const std::scoped_lock lock{mFiberMutex};
+    if (mFreeFibers.empty()) {
+        return nullptr;
+    }
+    Fiber* fiber = mFreeFibers.back();
+    mFreeFibers.pop_back();
+    return fiber;
+}
+
+Fiber* JobSystem::take_ready_fiber(u32 workerIndex) {
+    if (mWaitingFiberCount.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    const std::scoped_lock lock{mFiberMutex};
+    const auto ready = std::ranges::find_if(mWaitingFibers, [workerIndex](const WaitingFiber& waiting) {
+        return waiting.counter->is_done() &&
+            (waiting.pinnedWorker == ANY_WORKER || waiting.pinnedWorker == workerIndex);
+    });
+    if (ready == mWaitingFibers.end()) {
+        return nullptr;
+    }
+    Fiber* fiber = ready->fiber;
+    *ready = mWaitingFibers.back();
+    mWaitingFibers.pop_back();
+    mWaitingFiberCount.fetch_sub(1, std::memory_order_release);
+    return fiber;
+}
+
+void JobSystem::switch_to_fiber(Fiber* fiber) {
+    auto& worker = *mWorkers[get_worker_index()];
+    Fiber* current = worker.currentFiber;
+    worker.currentFiber = fiber;
+    worker.fiberSwitches.fetch_add(1, std::memory_order_relaxed);
+    Fiber::switch_to(*current, *fiber);
+    finish_fiber_switch();
+}
+
+void JobSystem::finish_fiber_switch() {
+    // Runs on the fiber that was just resumed, the previous fiber's stack is no longer in use
+    auto& worker = *mWorkers[get_worker_index()];
+    if (worker.fiberToRelease != nullptr) {
+        const std::scoped_lock lock{mFiberMutex};
+        mFreeFibers.push_back(worker.fiberToRelease);
+        worker.fiberToRelease = nullptr;
+    }
+    if (worker.fiberToWait.fiber != nullptr) {
+        bool counterDone = false;
+        {
+            const std::scoped_lock lock{mFiberMutex};
+            mWaitingFibers.push_back(worker.fiberToWait);
+            mWaitingFiberCount.fetch_add(1, std::memory_order_seq_cst);
+            // Checked under the lock, once released the fiber may resume and its counter go out of scope
+            counterDone = worker.fiberToWait.counter->mRemaining.load(std::memory_order_seq_cst) == 0;
+        }
+        worker.fiberToWait = {};
+        // The counter may have finished before the fiber was registered, nobody else wakes the workers for it
+        if (counterDone) {
+            wake_workers();
+        }
+    }
+}
\ No newline at end of file
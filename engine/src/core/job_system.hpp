@@ -0,0 +1,155 @@
+#pragma once
+
+#include "core/work_stealing_deque.hpp"
+#include "defines.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+class Fiber;
+
+// Counts the unfinished jobs of one or more run() calls, jobs depending on them wait on the counter.
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter(JobCounter&&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+    JobCounter& operator=(JobCounter&&) = delete;
+    ~JobCounter() = default;
+
+    [[nodiscard]] bool is_done() const {
+        return mRemaining.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+    std::atomic<u32> mRemaining{0};
+};
+
+// Work-stealing job system, every worker owns a Chase-Lev deque and steals from the others when it runs dry.
+// The thread creating the system is worker 0, it runs jobs itself while waiting on a counter.
+// Jobs may only be submitted from worker threads, including from inside other jobs.
+//
+// With a fiber pool jobs run on fibers, a job waiting on a counter is suspended and its worker moves on to
+// other jobs instead of nesting them on its stack. The suspended job resumes on whichever worker finds its
+// counter done first. Without fibers a waiting job runs other jobs nested inside the wait.
+class JobSystem {
+public:
+    using JobFunction = void (*)(void* userData);
+
+    struct JobDeclaration {
+        JobFunction function{nullptr};
+        void* userData{nullptr};
+    };
+
+    struct Statistics {
+        u64 jobsExecuted{0};
+        u64 jobsStolen{0};
+        u64 fiberSwitches{0};
+    };
+
+    // Jobs are stored in a per thread pool, once a thread has this many jobs queued further jobs run inline
+    static constexpr size_t MAX_JOBS_PER_THREAD = 4096;
+    static constexpr u32 DEFAULT_FIBER_COUNT = 128;
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+    // With 0 worker threads all jobs run on the creating thread while it waits.
+    // A fiber count of 0 disables fibers, otherwise it bounds the number of suspended jobs.
+    DLL_EXPORT explicit JobSystem(u32 workerThreadCount, u32 fiberCount = 0);
+    DLL_EXPORT ~JobSystem();
+
+    DLL_EXPORT void run(std::span<const JobDeclaration> jobs, JobCounter& counter);
+    DLL_EXPORT void run(const JobDeclaration& job, JobCounter& counter);
+    // Executes queued jobs on the calling thread until the counter reaches zero,
+    // with fibers the caller is suspended instead and resumes once the counter is done
+    DLL_EXPORT void wait(const JobCounter& counter);
+
+    // Worker threads plus the creating thread
+    [[nodiscard]] u32 get_thread_count() const {
+        return static_cast<u32>(mWorkers.size());
+    }
+    // Whether the calling thread is one of this system's workers, only those may run and wait on jobs
+    [[nodiscard]] DLL_EXPORT bool is_job_thread() const;
+    // Index of the calling worker below get_thread_count(), for per thread resources.
+    // A job suspended on a fiber may resume on another worker, the index is only stable until the next wait
+    [[nodiscard]] DLL_EXPORT u32 get_current_thread_index() const;
+    [[nodiscard]] DLL_EXPORT Statistics get_statistics() const;
+    [[nodiscard]] bool uses_fibers() const {
+        return !mFibers.empty();
+    }
+
+    // One worker for every hardware thread besides the creating thread
+    [[nodiscard]] DLL_EXPORT static u32 get_default_worker_count();
+
+private:
+    struct Job {
+        JobFunction function{nullptr};
+        void* userData{nullptr};
+        JobCounter* counter{nullptr};
+        // Set while queued, cleared once a worker has taken the job so the slot can be reused
+        std::atomic<bool> queued{false};
+    };
+
+    static constexpr u32 ANY_WORKER = ~0U;
+
+    struct WaitingFiber {
+        Fiber* fiber{nullptr};
+        const JobCounter* counter{nullptr};
+        // Thread fibers can only resume on their own thread
+        u32 pinnedWorker{ANY_WORKER};
+    };
+
+    struct alignas(64) Worker {
+        WorkStealingDeque<Job*, MAX_JOBS_PER_THREAD> queue;
+        std::array<Job, MAX_JOBS_PER_THREAD> jobs{};
+        size_t nextJob{0};
+        u32 nextVictim{0};
+        std::atomic<u64> jobsExecuted{0};
+        std::atomic<u64> jobsStolen{0};
+        std::atomic<u64> fiberSwitches{0};
+
+        // Fiber mode only, the thread's own context and the fiber currently running on it
+        std::unique_ptr<Fiber> threadFiber;
+        Fiber* currentFiber{nullptr};
+        // Handed from the fiber switching away to the fiber resuming on this thread, a fiber may only be
+        // released or resumed elsewhere once its stack is no longer in use
+        Fiber* fiberToRelease{nullptr};
+        WaitingFiber fiberToWait{};
+    };
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::vector<std::thread> mThreads;
+    std::atomic<bool> mRunning{true};
+    // Bumped whenever jobs are queued or a suspended job may resume, idle workers sleep on it
+    std::atomic<u32> mWorkEpoch{0};
+
+    std::vector<std::unique_ptr<Fiber>> mFibers;
+    std::mutex mFiberMutex;
+    std::vector<Fiber*> mFreeFibers;
+    std::vector<WaitingFiber> mWaitingFibers;
+    std::atomic<u32> mWaitingFiberCount{0};
+
+    void worker_main(u32 workerIndex);
+    [[nodiscard]] ENGINE_NOINLINE u32 get_worker_index() const;
+    Job* allocate_job(Worker& worker);
+    Job* find_job(u32 workerIndex);
+    void execute(Job* job);
+    // A job may suspend and resume on another thread, so the executing worker is looked up afterwards
+    void execute(const JobDeclaration& declaration, JobCounter& counter);
+    void wake_workers();
+
+    static void fiber_main(void* userData);
+    void scheduler_loop();
+    Fiber* acquire_fiber();
+    Fiber* take_ready_fiber(u32 workerIndex);
+    void switch_to_fiber(Fiber* fiber);
+    ENGINE_NOINLINE void finish_fiber_switch();
+};
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "defines.hpp"
+#include <array>
+#include <cstddef>
+
+// Fixed capacity ring buffer, pushing into a full buffer overwrites the oldest element.
+// Index 0 always refers to the oldest element still held.
+template <typename T, size_t Capacity>
+class RingBuffer {
+public:
+    static_assert(Capacity > 0, "RingBuffer capacity must be non-zero");
+
+    void push(const T& value) {
+        mData[mHead] = value;
+        mHead = (mHead + 1) % Capacity;
+        if (mSize < Capacity) {
+            ++mSize;
+        }
+    }
+
+    void clear() {
+        mHead = 0;
+        mSize = 0;
+    }
+
+    [[nodiscard]] const T& operator[](size_t index) const {
+        return mData[(mHead + Capacity - mSize + index) % Capacity];
+    }
+    [[nodiscard]] const T& back() const {
+        return mData[(mHead + Capacity - 1) % Capacity];
+    }
+    [[nodiscard]] size_t size() const {
+        return mSize;
+    }
+    [[nodiscard]] bool empty() const {
+        return mSize == 0;
+    }
+    [[nodiscard]] static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    std::array<T, Capacity> mData{};
+    size_t mHead{0};
+    size_t mSize{0};
+};
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "defines.hpp"
+#include <atomic>
+#include <vector>
+
+// Bounded single producer, single consumer queue. Push and pop never lock, the wait functions block on the
+// indices with atomic wait/notify. Several threads may act as the producer as long as their calls never overlap.
+//
+// Elements are written and read in place, a slot keeps its previous contents so containers inside it keep
+// their capacity:
+//   if (auto* slot = queue.begin_push()) { slot->values.assign(...); queue.end_push(); }
+//   if (auto* slot = queue.front()) { consume(*slot); queue.pop(); }
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : mSlots(capacity > 0 ? capacity : 1) {}
+
+    // Producer only, the slot to fill or nullptr when the queue is full
+    [[nodiscard]] T* begin_push() {
+        const u64 tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == mSlots.size()) {
+            return nullptr;
+        }
+        return &mSlots[tail % mSlots.size()];
+    }
+    // Producer only, publishes the slot returned by begin_push()
+    void end_push() {
+        mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        mTail.notify_one();
+    }
+    // Producer only, blocks while the queue is full
+    void wait_for_space() const {
+        const u64 tail = mTail.load(std::memory_order_relaxed);
+        u64 head = mHead.load(std::memory_order_acquire);
+        while (tail - head == mSlots.size()) {
+            mHead.wait(head, std::memory_order_acquire);
+            head = mHead.load(std::memory_order_acquire);
+        }
+    }
+
+    // Consumer only, the oldest element or nullptr when the queue is empty
+    [[nodiscard]] T* front() {
+        const u64 head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &mSlots[head % mSlots.size()];
+    }
+    // Consumer only, releases the slot returned by front()
+    void pop() {
+        mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        mHead.notify_one();
+    }
+    // Consumer only, blocks while the queue is empty
+    void wait_for_element() const {
+        const u64 head = mHead.load(std::memory_order_relaxed);
+        u64 tail = mTail.load(std::memory_order_acquire);
+        while (tail == head) {
+            mTail.wait(tail, std::memory_order_acquire);
+            tail = mTail.load(std::memory_order_acquire);
+        }
+    }
+
+    // Approximate when called concurrently with push/pop
+    [[nodiscard]] size_t size() const {
+        return static_cast<size_t>(mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire));
+    }
+    [[nodiscard]] size_t capacity() const {
+        return mSlots.size();
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Monotonic counters, the slot index is the counter modulo the capacity
+    alignas(CACHE_LINE_SIZE) std::atomic<u64> mHead{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<u64> mTail{0};
+    std::vector<T> mSlots;
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "task_graph.hpp"
+#include "core/logger.hpp"
+#include <stdexcept>
+
+TaskGraph::TaskId TaskGraph::add_task(const char* name, TaskFunction function, void* userData,
+                                      std::initializer_list<TaskId> dependencies) {
+    if (mTaskCount == MAX_TASKS) {
+        MSG_FATAL("Task graph is full, cannot add task: {}", name);
+        throw std::length_error("Task graph capacity exceeded");
+    }
+
+    const auto id = static_cast<TaskId>(mTaskCount);
+    for (const TaskId dependency : dependencies) {
+        if (dependency >= id || mTasks[dependency].successorCount == MAX_SUCCESSORS) {
+            MSG_FATAL("Invalid dependency {} for task: {}", dependency, name);
+            throw std::invalid_argument("Invalid task dependency");
+        }
+        auto& predecessor = mTasks[dependency];
+        predecessor.successors[predecessor.successorCount++] = id;
+    }
+
+    auto& task = mTasks[id];
+    task.name = name;
+    task.function = function;
+    task.userData = userData;
+    task.graph = this;
+    task.successorCount = 0;
+    task.dependencyCount = static_cast<u32>(dependencies.size());
+    ++mTaskCount;
+    return id;
+}
+
+void TaskGraph::clear() {
+    mTaskCount = 0;
+}
+
+void TaskGraph::execute(JobSystem& jobSystem) {
+    mJobSystem = &jobSystem;
+    for (size_t i = 0; i < mTaskCount; ++i) {
+        mTasks[i].pendingDependencies.store(mTasks[i].dependencyCount, std::memory_order_relaxed);
+    }
+
+    std::array<JobSystem::JobDeclaration, MAX_TASKS> roots{};
+    size_t rootCount = 0;
+    for (size_t i = 0; i < mTaskCount; ++i) {
+        if (mTasks[i].dependencyCount == 0) {
+            roots[rootCount++] = {run_task, &mTasks[i]};
+        }
+    }
+    jobSystem.run(std::span{roots.data(), rootCount}, mCounter);
+    jobSystem.wait(mCounter);
+    mJobSystem = nullptr;
+}
+
+void TaskGraph::execute_serial() {
+    for (size_t i = 0; i < mTaskCount; ++i) {
+        mTasks[i].function(mTasks[i].userData);
+    }
+}
+
+void TaskGraph::run_task(void* userData) {
+    auto& task = *static_cast<Task*>(userData);
+    task.function(task.userData);
+
+    // Successors are queued before this job completes, so the graph counter cannot reach zero early
+    auto& graph = *task.graph;
+    for (u32 i = 0; i < task.successorCount; ++i) {
+        auto& successor = graph.mTasks[task.successors[i]];
+        if (successor.pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            graph.mJobSystem->run(JobSystem::JobDeclaration{run_task, &successor}, graph.mCounter);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/job_system.hpp"
+#include "defines.hpp"
+#include <array>
+#include <atomic>
+#include <initializer_list>
+
+// Fixed set of tasks with explicit dependencies, executed once per execute() call.
+// Dependencies must be added before their dependents, so insertion order is always a valid serial order
+// and the graph cannot contain cycles. Tasks are scheduled as jobs once their last dependency finished.
+class TaskGraph {
+public:
+    using TaskId = u32;
+    using TaskFunction = void (*)(void* userData);
+
+    static constexpr size_t MAX_TASKS = 32;
+    static constexpr size_t MAX_SUCCESSORS = 8;
+
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph(TaskGraph&&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+    TaskGraph& operator=(TaskGraph&&) = delete;
+    ~TaskGraph() = default;
+
+    DLL_EXPORT TaskId add_task(const char* name, TaskFunction function, void* userData,
+                               std::initializer_list<TaskId> dependencies = {});
+    DLL_EXPORT void clear();
+
+    // Runs every task, independent tasks in parallel, and returns once all of them finished
+    DLL_EXPORT void execute(JobSystem& jobSystem);
+    // Runs every task in insertion order on the calling thread
+    DLL_EXPORT void execute_serial();
+
+    [[nodiscard]] size_t get_task_count() const {
+        return mTaskCount;
+    }
+
+private:
+    struct Task {
+        const char* name{nullptr};
+        TaskFunction function{nullptr};
+        void* userData{nullptr};
+        TaskGraph* graph{nullptr};
+        std::array<TaskId, MAX_SUCCESSORS> successors{};
+        u32 successorCount{0};
+        u32 dependencyCount{0};
+        std::atomic<u32> pendingDependencies{0};
+    };
+
+    std::array<Task, MAX_TASKS> mTasks{};
+    size_t mTaskCount{0};
+
+    // Only valid during execute()
+    JobSystem* mJobSystem{nullptr};
+    JobCounter mCounter;
+
+    static void run_task(void* userData);
+};
\ No newline at end of file
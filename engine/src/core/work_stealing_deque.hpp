@@ -0,0 +1,82 @@
+#pragma once
+
+#include "defines.hpp"
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+// Fixed capacity Chase-Lev work-stealing deque.
+// The owning thread pushes and pops at the bottom, any other thread steals from the top.
+// Memory orderings follow "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013).
+template <typename T, size_t Capacity>
+class WorkStealingDeque {
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "WorkStealingDeque capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque elements are stored in atomics");
+
+    // Owner only, returns false when the deque is full
+    bool push(T value) {
+        const i64 bottom = mBottom.load(std::memory_order_relaxed);
+        const i64 top = mTop.load(std::memory_order_acquire);
+        if (bottom - top >= static_cast<i64>(Capacity)) {
+            return false;
+        }
+        mData[static_cast<size_t>(bottom) & MASK].store(value, std::memory_order_relaxed);
+        // Release store instead of the paper's fence, publishes the element to thieves acquiring the bottom
+        mBottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only
+    bool pop(T& value) {
+        const i64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(bottom, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 top = mTop.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            mBottom.store(bottom + 1, std::memory_order_release);
+            return false;
+        }
+
+        value = mData[static_cast<size_t>(bottom) & MASK].load(std::memory_order_relaxed);
+        if (top != bottom) {
+            return true;
+        }
+
+        // Last element, race the thieves for it
+        const bool won = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        mBottom.store(bottom + 1, std::memory_order_release);
+        return won;
+    }
+
+    // Any thread
+    bool steal(T& value) {
+        i64 top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const i64 bottom = mBottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return false;
+        }
+
+        value = mData[static_cast<size_t>(top) & MASK].load(std::memory_order_relaxed);
+        return mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Approximate when called concurrently with push/pop/steal
+    [[nodiscard]] bool empty() const {
+        return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Thieves contend on the top, keep it off the owner's cache line
+    alignas(CACHE_LINE_SIZE) std::atomic<i64> mTop{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<i64> mBottom{0};
+    alignas(CACHE_LINE_SIZE) std::array<std::atomic<T>, Capacity> mData{};
+};
\ No newline at end of file
@@ -1,10 +1,29 @@
+#include <cstddef>
 #include <cstdint>
 #include <climits>
 
 // Make sure sizeof(char) = 1 = 8-bits = 1-byte
 static_assert(CHAR_BIT == 8);
 
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+#define ENGINE_PLATFORM_WINDOWS 1
+#elif defined(__linux__) || defined(__gnu_linux__)
+#define ENGINE_PLATFORM_LINUX 1
+#else
+#error "Unsupported platform, only Windows and Linux are supported"
+#endif
+
+#if ENGINE_PLATFORM_WINDOWS
 #define DLL_EXPORT __declspec(dllexport)
+#else
+#define DLL_EXPORT __attribute__((visibility("default")))
+#endif
+
+#if defined(_MSC_VER)
+#define ENGINE_NOINLINE __declspec(noinline)
+#else
+#define ENGINE_NOINLINE __attribute__((noinline))
+#endif
 
 using i8 = std::int8_t;
 using i16 = std::int16_t;
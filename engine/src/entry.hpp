@@ -4,11 +4,54 @@
 #include "core/event.hpp"
 #include "core/logger.hpp"
 #include "game_types.hpp"
+#include <cstdlib>
+#include <string_view>
 
 
 extern bool create_game(Game*);
 
-int main() {
+// Command line overrides of the game configuration, used by automated runs:
+//   --headless, --input-script <path>, --frames <count>, --renderer <vulkan|null>, --workers <count>, --serial-frames,
+//   --render-queue <depth>, --frames-in-flight <count>, --no-transfer-queue
+inline bool apply_command_line(Game& game, int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument{argv[i]};
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--headless") {
+            game.mHeadless = true;
+        } else if (argument == "--input-script" && hasValue) {
+            game.mInputScriptPath = argv[++i];
+        } else if (argument == "--frames" && hasValue) {
+            game.mFrameLimit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--serial-frames") {
+            game.mSerialFrames = true;
+        } else if (argument == "--no-transfer-queue") {
+            game.mTransferQueue = false;
+        } else if (argument == "--render-queue" && hasValue) {
+            game.mRenderQueueDepth = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--frames-in-flight" && hasValue) {
+            game.mFramesInFlight = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--workers" && hasValue) {
+            game.mWorkerThreadCount = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--renderer" && hasValue) {
+            const std::string_view backend{argv[++i]};
+            if (backend == "vulkan") {
+                game.mRendererBackend = RendererBackend::BackendType::RENDERER_BACKEND_TYPE_VULKAN;
+            } else if (backend == "null") {
+                game.mRendererBackend = RendererBackend::BackendType::RENDERER_BACKEND_TYPE_NULL;
+            } else {
+                MSG_ERROR("Unknown renderer backend: {}", backend);
+                return false;
+            }
+        } else {
+            MSG_ERROR("Unknown or incomplete command line argument: {}", argument);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
     Logger::init_logging();
 
     MemoryManager memoryManager{};
@@ -40,6 +83,10 @@ int main() {
 
     MSG_TRACE("Game: {:p} created", static_cast<void*>(&game));
 
+    if (!apply_command_line(game, argc, argv)) {
+        return -4;
+    }
+
     if ((game.initialize == nullptr) || (game.update == nullptr) || (game.render == nullptr) || (game.on_resize == nullptr)) {
         MSG_FATAL("Not all game function pointers are assigned!");
         return -2;
@@ -1,7 +1,15 @@
 #pragma once
+#include "defines.hpp"
+#include "renderer/renderer_backend.hpp"
+#include "renderer/renderer_types.hpp"
 #include <string>
 #include <utility>
 
+class FrameStats;
+class InputHandler;
+class JobSystem;
+class Renderer;
+
 class Game {
 public:
     short mX{0};
@@ -11,13 +19,42 @@ public:
 
     std::string mName;
 
+    // Run without a window, rendering offscreen and replaying mInputScriptPath if set
+    bool mHeadless{false};
+    std::string mInputScriptPath;
+    // Frames to run before quitting, 0 runs until quit is requested
+    u64 mFrameLimit{0};
+    // The null backend discards all GPU work, isolating the engine CPU cost in benchmarks
+    RendererBackend::BackendType mRendererBackend{RendererBackend::BackendType::RENDERER_BACKEND_TYPE_VULKAN};
+    // Job system worker threads, 0 starts one worker for every additional hardware thread
+    u32 mWorkerThreadCount{0};
+    // Run update, render and draw_frame back to back instead of overlapping the next update with the draw
+    bool mSerialFrames{false};
+    // Frames queued for a dedicated render thread, 0 draws on the thread running the frame instead
+    u32 mRenderQueueDepth{0};
+    // Frames the CPU may record ahead of the GPU, clamped to 1..4 by the renderer. More frames hide GPU
+    // stalls at the cost of latency and per-frame memory
+    u32 mFramesInFlight{2};
+    // Pipelines compiled by the driver are saved here at shutdown and loaded by the next run, empty disables it
+    std::string mPipelineCachePath{"pipeline_cache.bin"};
+    // Copy uploads on a dedicated transfer queue when the device has one, instead of on the graphics queue
+    bool mTransferQueue{true};
+
+    // Engine owned systems, assigned by the application before initialize() is called
+    const FrameStats* mFrameStats{nullptr};
+    const InputHandler* mInputHandler{nullptr};
+    JobSystem* mJobSystem{nullptr};
+    Renderer* mRenderer{nullptr};
 
     Game() = default;
     Game(short x, short y, short width, short height, std::string name) : mX{x}, mY{y}, mWidth{width}, mHeight{height}, mName{std::move(name)} {};
 
     bool (*initialize)(){nullptr};
+    // Unless mSerialFrames is set update() and render() run on a job thread while the renderer draws the
+    // previous frame, renderer calls made from them are serialized with the draw
     bool (*update)(double deltaTime){nullptr};
-    bool (*render)(double deltaTime){nullptr};
+    // Fills the packet with this frame's dispatches and draws, the packet arrives cleared every frame
+    bool (*render)(double deltaTime, RenderPacket& packet){nullptr};
 
     void (*on_resize)(short width, short height){nullptr};
 };
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+#include "game_types.hpp"
+#include <string>
+#include <utility>
+
+// Game setup shared by the renderer tests and benchmarks. They run headless on the Vulkan backend, a software
+// driver like lavapipe works when no GPU is available. The game does nothing until its callbacks are assigned
+inline Game make_headless_game(std::string name, u64 frameCount) {
+    Game game{0, 0, 1280, 720, std::move(name)};
+    game.mHeadless = true;
+    game.mFrameLimit = frameCount;
+    game.initialize = [] { return true; };
+    game.update = [](double /*unused*/) { return true; };
+    game.render = [](double /*unused*/, RenderPacket& /*unused*/) { return true; };
+    game.on_resize = [](short /*unused*/, short /*unused*/) {};
+    return game;
+}
\ No newline at end of file
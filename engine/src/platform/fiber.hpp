@@ -0,0 +1,31 @@
+#pragma once
+
+#include "defines.hpp"
+#include <memory>
+
+// Cooperatively scheduled execution context with its own stack, only runs when explicitly switched to.
+// Implemented with ucontext on Linux and native fibers on Windows.
+class Fiber {
+public:
+    using EntryPoint = void (*)(void* userData);
+    // Platform specific context, defined by the platform implementation
+    struct State;
+
+    static constexpr size_t DEFAULT_STACK_SIZE = 256 * 1024;
+
+    Fiber(const Fiber&) = delete;
+    Fiber(Fiber&&) = delete;
+    Fiber& operator=(const Fiber&) = delete;
+    Fiber& operator=(Fiber&&) = delete;
+    // Context of the calling thread, every thread needs one to switch away from. Must be destroyed on that thread.
+    DLL_EXPORT Fiber();
+    // The entry point must never return, it switches to another fiber when done instead
+    DLL_EXPORT Fiber(EntryPoint entryPoint, void* userData, size_t stackSize = DEFAULT_STACK_SIZE);
+    DLL_EXPORT ~Fiber();
+
+    // Suspends the running fiber from, which must be the current context, and resumes to
+    DLL_EXPORT static void switch_to(Fiber& from, Fiber& to);
+
+private:
+    std::unique_ptr<State> mState;
+};
\ No newline at end of file
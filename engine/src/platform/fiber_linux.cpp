@@ -0,0 +1,69 @@
+#include "fiber.hpp"
+#if ENGINE_PLATFORM_LINUX
+#include "core/logger.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+struct Fiber::State {
+    ucontext_t context{};
+    void* stack{nullptr};
+    size_t mappedSize{0};
+    EntryPoint entryPoint{nullptr};
+    void* userData{nullptr};
+};
+
+namespace {
+    // makecontext only passes int arguments, the state pointer is split in two halves
+    void fiber_start(unsigned int high, unsigned int low) {
+        auto* state = reinterpret_cast<Fiber::State*>((static_cast<std::uintptr_t>(high) << 32U) | low);
+        state->entryPoint(state->userData);
+        MSG_FATAL("Fiber entry point returned");
+        std::abort();
+    }
+}  // namespace
+
+Fiber::Fiber() : mState{std::make_unique<State>()} {
+    // The context is captured by the first switch away from this thread
+}
+
+Fiber::Fiber(EntryPoint entryPoint, void* userData, size_t stackSize) : mState{std::make_unique<State>()} {
+    mState->entryPoint = entryPoint;
+    mState->userData = userData;
+
+    // One inaccessible guard page below the stack turns an overflow into a crash instead of corruption
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t alignedStackSize = (stackSize + pageSize - 1) / pageSize * pageSize;
+    mState->mappedSize = alignedStackSize + pageSize;
+    mState->stack = mmap(nullptr, mState->mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+                         -1, 0);
+    if (mState->stack == MAP_FAILED || mprotect(mState->stack, pageSize, PROT_NONE) != 0) {
+        MSG_FATAL("Failed to allocate a fiber stack of {} bytes", alignedStackSize);
+        throw std::runtime_error("Failed to allocate fiber stack");
+    }
+
+    if (getcontext(&mState->context) != 0) {
+        MSG_FATAL("Failed to initialize fiber context");
+        throw std::runtime_error("Failed to initialize fiber context");
+    }
+    mState->context.uc_stack.ss_sp = static_cast<char*>(mState->stack) + pageSize;
+    mState->context.uc_stack.ss_size = alignedStackSize;
+    mState->context.uc_link = nullptr;
+    const auto statePointer = reinterpret_cast<std::uintptr_t>(mState.get());
+    makecontext(&mState->context, reinterpret_cast<void (*)()>(fiber_start), 2,
+                static_cast<unsigned int>(statePointer >> 32U), static_cast<unsigned int>(statePointer));
+}
+
+Fiber::~Fiber() {
+    if (mState->stack != nullptr) {
+        munmap(mState->stack, mState->mappedSize);
+    }
+}
+
+void Fiber::switch_to(Fiber& from, Fiber& to) {
+    swapcontext(&from.mState->context, &to.mState->context);
+}
+#endif
\ No newline at end of file
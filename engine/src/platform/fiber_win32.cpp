@@ -0,0 +1,59 @@
+#include "fiber.hpp"
+#if ENGINE_PLATFORM_WINDOWS
+#define NOMINMAX
+#include "core/logger.hpp"
+#include <cstdlib>
+#include <stdexcept>
+#include <windows.h>
+
+struct Fiber::State {
+    void* handle{nullptr};
+    // Thread fibers are converted back instead of deleted
+    bool convertedThread{false};
+    EntryPoint entryPoint{nullptr};
+    void* userData{nullptr};
+};
+
+namespace {
+    VOID CALLBACK fiber_start(LPVOID parameter) {
+        auto* state = static_cast<Fiber::State*>(parameter);
+        state->entryPoint(state->userData);
+        MSG_FATAL("Fiber entry point returned");
+        std::abort();
+    }
+}  // namespace
+
+Fiber::Fiber() : mState{std::make_unique<State>()} {
+    mState->handle = ConvertThreadToFiber(nullptr);
+    if (mState->handle != nullptr) {
+        mState->convertedThread = true;
+    } else if (GetLastError() == ERROR_ALREADY_FIBER) {
+        mState->handle = GetCurrentFiber();
+    } else {
+        MSG_FATAL("Failed to convert thread to fiber");
+        throw std::runtime_error("Failed to convert thread to fiber");
+    }
+}
+
+Fiber::Fiber(EntryPoint entryPoint, void* userData, size_t stackSize) : mState{std::make_unique<State>()} {
+    mState->entryPoint = entryPoint;
+    mState->userData = userData;
+    mState->handle = CreateFiber(stackSize, fiber_start, mState.get());
+    if (mState->handle == nullptr) {
+        MSG_FATAL("Failed to create a fiber with a {} byte stack", stackSize);
+        throw std::runtime_error("Failed to create fiber");
+    }
+}
+
+Fiber::~Fiber() {
+    if (mState->convertedThread) {
+        ConvertFiberToThread();
+    } else if (mState->entryPoint != nullptr) {
+        DeleteFiber(mState->handle);
+    }
+}
+
+void Fiber::switch_to(Fiber& /*from*/, Fiber& to) {
+    SwitchToFiber(to.mState->handle);
+}
+#endif
\ No newline at end of file
@@ -1,10 +1,9 @@
 #pragma once
 
-#define ENGINE_PLATFORM_WINDOWS 1
-
 #include "defines.hpp"
 #include <memory>
 #include <string>
+#include <vector>
 
 class InputHandler;
 class EventManager;
@@ -22,28 +21,59 @@ public:
     struct EventContext {
         InputHandler* inputHandler;
         EventManager* eventManager;
+        const Platform* platform;  // Timestamps input received in the window procedure
+    };
+
+    // Input replayed by a headless platform, dispatched when pumpMessages() is called for the given frame
+    struct ScriptedInput {
+        enum class Type {
+            KEY,
+            BUTTON,
+            MOUSE_MOVE,
+            MOUSE_WHEEL,
+            QUIT
+        };
+
+        u64 frame{0};
+        Type type{Type::KEY};
+        i16 code{0};  // Key, button or wheel delta
+        i16 x{0};
+        i16 y{0};
+        bool pressed{false};
     };
 
     Platform(const Platform&) = delete;
     Platform(Platform&&) = delete;
     Platform& operator=(const Platform&) = delete;
     Platform& operator=(Platform&&) = delete;
-    Platform(InputHandler& inputHandler, EventManager& eventHandler);
+    Platform(InputHandler& inputHandler, EventManager& eventHandler, bool headless = false);
     ~Platform() = default;
 
+    // A headless platform creates no window and only produces scripted input
     bool startup(const std::string& application_name, int x, int y, int width, int height);
     void shutdown();
     bool pumpMessages();
+    bool loadInputScript(const std::string& path);
 
     DLL_EXPORT static void consoleWrite(const std::string& message, unsigned char colour);
     DLL_EXPORT static void consoleWriteError(const std::string& message, unsigned char colour);
 
     [[nodiscard]] double getAbsoluteTime() const;
     [[nodiscard]] State* getState();
+    [[nodiscard]] bool isHeadless() const {
+        return mHeadless;
+    }
     static void sleep(std::size_t ms);
 
 private:
     std::unique_ptr<State> mState;
     std::unique_ptr<EventContext> mContext;
     double mClock_frequency{};
+
+    bool mHeadless{false};
+    std::vector<ScriptedInput> mInputScript;
+    size_t mNextScriptedInput{0};
+    u64 mPumpedFrames{0};
+
+    bool pumpScriptedInput();
 };
\ No newline at end of file
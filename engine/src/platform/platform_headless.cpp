@@ -0,0 +1,123 @@
+#include "core/event.hpp"
+#include "core/input.hpp"
+#include "core/logger.hpp"
+#include "platform.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Platform independent part of the headless platform: input script loading and replay.
+//
+// Script format, one input per line, '#' starts a comment:
+//   <frame> key <virtual-key code> <down|up>
+//   <frame> button <left|right|middle> <down|up>
+//   <frame> move <x> <y>
+//   <frame> wheel <delta>
+//   <frame> quit
+
+bool Platform::loadInputScript(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        MSG_ERROR("Failed to open input script: {}", path);
+        return false;
+    }
+
+    std::vector<ScriptedInput> script;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream lineStream(line);
+
+        ScriptedInput input{};
+        std::string type;
+        if (!(lineStream >> input.frame >> type)) {
+            continue;  // Empty or comment line
+        }
+
+        std::string state;
+        bool valid = true;
+        if (type == "key") {
+            std::string code;
+            valid = static_cast<bool>(lineStream >> code >> state);
+            if (valid) {
+                // Accepts decimal or 0x prefixed hexadecimal codes
+                char* codeEnd = nullptr;
+                const long keyCode = std::strtol(code.c_str(), &codeEnd, 0);
+                valid = *codeEnd == '\0' && keyCode > 0 && keyCode < InputHandler::Key::KEYS_MAX_KEYS;
+                input.type = ScriptedInput::Type::KEY;
+                input.code = static_cast<i16>(keyCode);
+            }
+        } else if (type == "button") {
+            std::string button;
+            valid = static_cast<bool>(lineStream >> button >> state);
+            input.type = ScriptedInput::Type::BUTTON;
+            if (button == "left") {
+                input.code = InputHandler::Button::BUTTON_LEFT;
+            } else if (button == "right") {
+                input.code = InputHandler::Button::BUTTON_RIGHT;
+            } else if (button == "middle") {
+                input.code = InputHandler::Button::BUTTON_MIDDLE;
+            } else {
+                valid = false;
+            }
+        } else if (type == "move") {
+            input.type = ScriptedInput::Type::MOUSE_MOVE;
+            valid = static_cast<bool>(lineStream >> input.x >> input.y);
+        } else if (type == "wheel") {
+            input.type = ScriptedInput::Type::MOUSE_WHEEL;
+            valid = static_cast<bool>(lineStream >> input.code);
+        } else if (type == "quit") {
+            input.type = ScriptedInput::Type::QUIT;
+        } else {
+            valid = false;
+        }
+
+        if (input.type == ScriptedInput::Type::KEY || input.type == ScriptedInput::Type::BUTTON) {
+            input.pressed = state == "down";
+            valid = valid && (state == "down" || state == "up");
+        }
+
+        if (!valid) {
+            MSG_ERROR("Invalid input script entry in {} at line {}: '{}'", path, lineNumber, line);
+            return false;
+        }
+        script.push_back(input);
+    }
+
+    std::ranges::stable_sort(script, {}, &ScriptedInput::frame);
+    mInputScript = std::move(script);
+    mNextScriptedInput = 0;
+    MSG_INFO("Loaded input script: {} with {} entries", path, mInputScript.size());
+    return true;
+}
+
+bool Platform::pumpScriptedInput() {
+    const f64 timestamp = getAbsoluteTime();
+    while (mNextScriptedInput < mInputScript.size() && mInputScript[mNextScriptedInput].frame <= mPumpedFrames) {
+        const auto& input = mInputScript[mNextScriptedInput++];
+        switch (input.type) {
+            case ScriptedInput::Type::KEY:
+                mContext->inputHandler->process_key(static_cast<InputHandler::Key>(input.code), input.pressed, timestamp);
+                break;
+            case ScriptedInput::Type::BUTTON:
+                mContext->inputHandler->process_button(static_cast<InputHandler::Button>(input.code), input.pressed, timestamp);
+                break;
+            case ScriptedInput::Type::MOUSE_MOVE:
+                mContext->inputHandler->process_mouse_move(input.x, input.y, timestamp);
+                break;
+            case ScriptedInput::Type::MOUSE_WHEEL:
+                mContext->inputHandler->process_mouse_wheel(static_cast<i8>(input.code), timestamp);
+                break;
+            case ScriptedInput::Type::QUIT:
+                mContext->eventManager->fire_event(EventManager::EventCode::EVENT_CODE_APPLICATION_QUIT, this,
+                                                   EventManager::Context{});
+                break;
+        }
+    }
+    ++mPumpedFrames;
+    return true;
+}
\ No newline at end of file
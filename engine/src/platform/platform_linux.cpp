@@ -0,0 +1,381 @@
+#include "core/event.hpp"
+#include "platform.hpp"
+#include <memory>
+#if ENGINE_PLATFORM_LINUX
+#include "core/input.hpp"
+#include "core/logger.hpp"
+
+#include "platform_linux.hpp"
+#include <X11/keysym.h>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace {
+    constexpr long NANOSECONDS_PER_SECOND = 1000000000;
+    constexpr long NANOSECONDS_PER_MILLISECOND = 1000000;
+    constexpr std::size_t MILLISECONDS_PER_SECOND = 1000;
+
+    // ANSI colour codes, indexed by log level like Logger::logSeverityColours
+    constexpr std::array consoleColourCodes{"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
+
+    // X sends events with the highest bit set when they were generated by SendEvent
+    constexpr u8 EVENT_RESPONSE_TYPE_MASK = 0x7F;
+
+    void console_write(FILE* stream, const std::string& message, unsigned char colour) {
+        std::fprintf(stream, "\033[%sm%s\033[0m", consoleColourCodes.at(colour), message.c_str());
+        std::fflush(stream);
+    }
+
+    xcb_atom_t intern_atom(xcb_connection_t* connection, const char* name) {
+        xcb_intern_atom_cookie_t cookie = xcb_intern_atom(connection, 0, static_cast<u16>(strlen(name)), name);
+        xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(connection, cookie, nullptr);
+        if (reply == nullptr) {
+            MSG_ERROR("Failed to intern XCB atom: {}", name);
+            return XCB_ATOM_NONE;
+        }
+        xcb_atom_t atom = reply->atom;
+        free(reply);
+        return atom;
+    }
+
+    InputHandler::Key translate_keysym(xcb_keysym_t keysym) {
+        // Letters and digits share their values with the Virtual-Key codes
+        if (keysym >= XK_a && keysym <= XK_z) {
+            return static_cast<InputHandler::Key>(InputHandler::Key::KEY_A + (keysym - XK_a));
+        }
+        if (keysym >= XK_A && keysym <= XK_Z) {
+            return static_cast<InputHandler::Key>(InputHandler::Key::KEY_A + (keysym - XK_A));
+        }
+        if (keysym >= XK_0 && keysym <= XK_9) {
+            return static_cast<InputHandler::Key>(keysym);
+        }
+        if (keysym >= XK_KP_0 && keysym <= XK_KP_9) {
+            return static_cast<InputHandler::Key>(InputHandler::Key::KEY_NUMPAD0 + (keysym - XK_KP_0));
+        }
+        if (keysym >= XK_F1 && keysym <= XK_F24) {
+            return static_cast<InputHandler::Key>(InputHandler::Key::KEY_F1 + (keysym - XK_F1));
+        }
+
+        switch (keysym) {
+            case XK_BackSpace:
+                return InputHandler::Key::KEY_BACKSPACE;
+            case XK_Return:
+                return InputHandler::Key::KEY_ENTER;
+            case XK_Tab:
+                return InputHandler::Key::KEY_TAB;
+            case XK_Pause:
+                return InputHandler::Key::KEY_PAUSE;
+            case XK_Caps_Lock:
+                return InputHandler::Key::KEY_CAPITAL;
+            case XK_Escape:
+                return InputHandler::Key::KEY_ESCAPE;
+            case XK_Mode_switch:
+                return InputHandler::Key::KEY_MODECHANGE;
+            case XK_space:
+                return InputHandler::Key::KEY_SPACE;
+            case XK_Prior:
+                return InputHandler::Key::KEY_PRIOR;
+            case XK_Next:
+                return InputHandler::Key::KEY_NEXT;
+            case XK_End:
+                return InputHandler::Key::KEY_END;
+            case XK_Home:
+                return InputHandler::Key::KEY_HOME;
+            case XK_Left:
+                return InputHandler::Key::KEY_LEFT;
+            case XK_Up:
+                return InputHandler::Key::KEY_UP;
+            case XK_Right:
+                return InputHandler::Key::KEY_RIGHT;
+            case XK_Down:
+                return InputHandler::Key::KEY_DOWN;
+            case XK_Select:
+                return InputHandler::Key::KEY_SELECT;
+            case XK_Print:
+                return InputHandler::Key::KEY_PRINT;
+            case XK_Execute:
+                return InputHandler::Key::KEY_EXECUTE;
+            case XK_Insert:
+                return InputHandler::Key::KEY_INSERT;
+            case XK_Delete:
+                return InputHandler::Key::KEY_DELETE;
+            case XK_Help:
+                return InputHandler::Key::KEY_HELP;
+            case XK_Super_L:
+                return InputHandler::Key::KEY_LWIN;
+            case XK_Super_R:
+                return InputHandler::Key::KEY_RWIN;
+            case XK_Menu:
+                return InputHandler::Key::KEY_APPS;
+            case XK_KP_Multiply:
+                return InputHandler::Key::KEY_MULTIPLY;
+            case XK_KP_Add:
+                return InputHandler::Key::KEY_ADD;
+            case XK_KP_Separator:
+                return InputHandler::Key::KEY_SEPARATOR;
+            case XK_KP_Subtract:
+                return InputHandler::Key::KEY_SUBTRACT;
+            case XK_KP_Decimal:
+                return InputHandler::Key::KEY_DECIMAL;
+            case XK_KP_Divide:
+                return InputHandler::Key::KEY_DIVIDE;
+            case XK_KP_Equal:
+                return InputHandler::Key::KEY_NUMPAD_EQUAL;
+            case XK_Num_Lock:
+                return InputHandler::Key::KEY_NUMLOCK;
+            case XK_Scroll_Lock:
+                return InputHandler::Key::KEY_SCROLL;
+            case XK_Shift_L:
+                return InputHandler::Key::KEY_LSHIFT;
+            case XK_Shift_R:
+                return InputHandler::Key::KEY_RSHIFT;
+            case XK_Control_L:
+                return InputHandler::Key::KEY_LCONTROL;
+            case XK_Control_R:
+                return InputHandler::Key::KEY_RCONTROL;
+            case XK_Alt_L:
+                return InputHandler::Key::KEY_LMENU;
+            case XK_Alt_R:
+                return InputHandler::Key::KEY_RMENU;
+            case XK_semicolon:
+                return InputHandler::Key::KEY_SEMICOLON;
+            case XK_plus:
+            case XK_equal:
+                return InputHandler::Key::KEY_PLUS;
+            case XK_comma:
+                return InputHandler::Key::KEY_COMMA;
+            case XK_minus:
+                return InputHandler::Key::KEY_MINUS;
+            case XK_period:
+                return InputHandler::Key::KEY_PERIOD;
+            case XK_slash:
+                return InputHandler::Key::KEY_SLASH;
+            case XK_grave:
+                return InputHandler::Key::KEY_GRAVE;
+            default:
+                return InputHandler::Key::KEYS_MAX_KEYS;
+        }
+    }
+}
+
+
+Platform::Platform(InputHandler& inputHandler, EventManager& eventHandler, bool headless) : mHeadless{headless} {
+    mState = std::make_unique<LinuxState>();
+    mContext = std::make_unique<EventContext>(&inputHandler, &eventHandler, this);
+    MSG_TRACE("Platform: {:p} created", static_cast<void*>(this));
+}
+
+bool Platform::startup(const std::string& application_name, int x, int y, int width, int height) {
+    if (mHeadless) {
+        MSG_INFO("Platform: {:p} started headless, no window created", static_cast<void*>(this));
+        return true;
+    }
+
+    auto* state = dynamic_cast<LinuxState*>(mState.get());
+
+    int screenIndex = 0;
+    state->connection = xcb_connect(nullptr, &screenIndex);
+    if (xcb_connection_has_error(state->connection) != 0) {
+        MSG_FATAL("Failed to connect to X server via XCB!");
+        return false;
+    }
+
+    const xcb_setup_t* setup = xcb_get_setup(state->connection);
+    xcb_screen_iterator_t screenIterator = xcb_setup_roots_iterator(setup);
+    for (int i = 0; i < screenIndex; ++i) {
+        xcb_screen_next(&screenIterator);
+    }
+    state->screen = screenIterator.data;
+
+    // Create window
+    state->window = xcb_generate_id(state->connection);
+
+    u32 eventMask = XCB_CW_BACK_PIXEL | XCB_CW_EVENT_MASK;
+    u32 eventValues = XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE | XCB_EVENT_MASK_KEY_PRESS |
+        XCB_EVENT_MASK_KEY_RELEASE | XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_POINTER_MOTION |
+        XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+    std::array<u32, 2> valueList{state->screen->black_pixel, eventValues};
+
+    xcb_create_window(state->connection, XCB_COPY_FROM_PARENT, state->window, state->screen->root,
+                      static_cast<i16>(x), static_cast<i16>(y), static_cast<u16>(width), static_cast<u16>(height), 0,
+                      XCB_WINDOW_CLASS_INPUT_OUTPUT, state->screen->root_visual, eventMask, valueList.data());
+    state->width = static_cast<u16>(width);
+    state->height = static_cast<u16>(height);
+
+    xcb_change_property(state->connection, XCB_PROP_MODE_REPLACE, state->window, XCB_ATOM_WM_NAME, XCB_ATOM_STRING,
+                        8, static_cast<u32>(application_name.size()), application_name.c_str());
+
+    // Ask the window manager to notify us instead of destroying the window on close
+    state->wm_protocols = intern_atom(state->connection, "WM_PROTOCOLS");
+    state->wm_delete_window = intern_atom(state->connection, "WM_DELETE_WINDOW");
+    xcb_change_property(state->connection, XCB_PROP_MODE_REPLACE, state->window, state->wm_protocols,
+                        XCB_ATOM_ATOM, 32, 1, &state->wm_delete_window);
+
+    // Keysym lookup table for keyboard input translation
+    state->min_keycode = setup->min_keycode;
+    const auto keycodeCount = static_cast<u8>(setup->max_keycode - setup->min_keycode + 1);
+    xcb_get_keyboard_mapping_cookie_t mappingCookie =
+        xcb_get_keyboard_mapping(state->connection, setup->min_keycode, keycodeCount);
+    xcb_get_keyboard_mapping_reply_t* mappingReply =
+        xcb_get_keyboard_mapping_reply(state->connection, mappingCookie, nullptr);
+    if (mappingReply == nullptr) {
+        MSG_FATAL("Failed to query XCB keyboard mapping!");
+        return false;
+    }
+    const xcb_keysym_t* keysyms = xcb_get_keyboard_mapping_keysyms(mappingReply);
+    state->keysyms.resize(keycodeCount);
+    for (size_t i = 0; i < keycodeCount; ++i) {
+        state->keysyms[i] = keysyms[i * mappingReply->keysyms_per_keycode];
+    }
+    free(mappingReply);
+
+    // Show the window
+    xcb_map_window(state->connection, state->window);
+
+    if (xcb_flush(state->connection) <= 0) {
+        MSG_FATAL("Failed to flush XCB connection!");
+        return false;
+    }
+
+    MSG_TRACE("Platform: {:p} initialized", static_cast<void*>(this));
+    return true;
+}
+
+void Platform::shutdown() {
+    auto* state = dynamic_cast<LinuxState*>(mState.get());
+    if (state->connection != nullptr) {
+        if (state->window != 0) {
+            xcb_destroy_window(state->connection, state->window);
+            state->window = 0;
+        }
+        xcb_disconnect(state->connection);
+        state->connection = nullptr;
+    }
+}
+
+bool Platform::pumpMessages() {
+    if (mHeadless) {
+        return pumpScriptedInput();
+    }
+
+    auto* state = dynamic_cast<LinuxState*>(mState.get());
+
+    xcb_generic_event_t* event = nullptr;
+    while ((event = xcb_poll_for_event(state->connection)) != nullptr) {
+        // The xcb event time is in server milliseconds, stamp input with our own clock instead
+        const f64 timestamp = getAbsoluteTime();
+        const u8 responseType = event->response_type & EVENT_RESPONSE_TYPE_MASK;
+        switch (responseType) {
+            case XCB_KEY_PRESS:
+            case XCB_KEY_RELEASE: {
+                const auto* keyEvent = reinterpret_cast<xcb_key_press_event_t*>(event);
+                const bool pressed = responseType == XCB_KEY_PRESS;
+                const size_t keysymIndex = keyEvent->detail - state->min_keycode;
+                if (keysymIndex < state->keysyms.size()) {
+                    const auto key = translate_keysym(state->keysyms[keysymIndex]);
+                    if (key != InputHandler::Key::KEYS_MAX_KEYS) {
+                        mContext->inputHandler->process_key(key, pressed, timestamp);
+                    }
+                }
+            } break;
+            case XCB_BUTTON_PRESS:
+            case XCB_BUTTON_RELEASE: {
+                const auto* buttonEvent = reinterpret_cast<xcb_button_press_event_t*>(event);
+                const bool pressed = responseType == XCB_BUTTON_PRESS;
+                switch (buttonEvent->detail) {
+                    case XCB_BUTTON_INDEX_1:
+                        mContext->inputHandler->process_button(InputHandler::Button::BUTTON_LEFT, pressed, timestamp);
+                        break;
+                    case XCB_BUTTON_INDEX_2:
+                        mContext->inputHandler->process_button(InputHandler::Button::BUTTON_MIDDLE, pressed, timestamp);
+                        break;
+                    case XCB_BUTTON_INDEX_3:
+                        mContext->inputHandler->process_button(InputHandler::Button::BUTTON_RIGHT, pressed, timestamp);
+                        break;
+                    // The mouse wheel is reported as button 4 (up) and 5 (down)
+                    case XCB_BUTTON_INDEX_4:
+                        if (pressed) {
+                            mContext->inputHandler->process_mouse_wheel(1, timestamp);
+                        }
+                        break;
+                    case XCB_BUTTON_INDEX_5:
+                        if (pressed) {
+                            mContext->inputHandler->process_mouse_wheel(-1, timestamp);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            } break;
+            case XCB_MOTION_NOTIFY: {
+                const auto* motionEvent = reinterpret_cast<xcb_motion_notify_event_t*>(event);
+                mContext->inputHandler->process_mouse_move(motionEvent->event_x, motionEvent->event_y, timestamp);
+            } break;
+            case XCB_CONFIGURE_NOTIFY: {
+                // Also sent when the window is moved, only forward actual size changes
+                const auto* configureEvent = reinterpret_cast<xcb_configure_notify_event_t*>(event);
+                if (configureEvent->width != state->width || configureEvent->height != state->height) {
+                    state->width = configureEvent->width;
+                    state->height = configureEvent->height;
+                    EventManager::Context eventData{};
+                    eventData.i16[0] = static_cast<i16>(configureEvent->width);
+                    eventData.i16[1] = static_cast<i16>(configureEvent->height);
+                    mContext->eventManager->fire_event(EventManager::EventCode::EVENT_CODE_WINDOW_RESIZED, this,
+                                                       eventData);
+                }
+            } break;
+            case XCB_CLIENT_MESSAGE: {
+                const auto* clientMessage = reinterpret_cast<xcb_client_message_event_t*>(event);
+                if (clientMessage->data.data32[0] == state->wm_delete_window) {
+                    mContext->eventManager->fire_event(EventManager::EventCode::EVENT_CODE_APPLICATION_QUIT, this,
+                                                       EventManager::Context{});
+                }
+            } break;
+            default:
+                break;
+        }
+        free(event);
+    }
+
+    return true;
+}
+
+void Platform::consoleWrite(const std::string& message, unsigned char colour) {
+    console_write(stdout, message, colour);
+}
+
+void Platform::consoleWriteError(const std::string& message, unsigned char colour) {
+    console_write(stderr, message, colour);
+}
+
+double Platform::getAbsoluteTime() const {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<double>(now.tv_sec) +
+        static_cast<double>(now.tv_nsec) / static_cast<double>(NANOSECONDS_PER_SECOND);
+}
+
+Platform::State* Platform::getState() {
+    return mState.get();
+}
+
+void Platform::sleep(std::size_t ms) {
+    // Sleep until an absolute deadline so interrupted sleeps resume without drifting
+    timespec deadline{};
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += static_cast<time_t>(ms / MILLISECONDS_PER_SECOND);
+    deadline.tv_nsec += static_cast<long>(ms % MILLISECONDS_PER_SECOND) * NANOSECONDS_PER_MILLISECOND;
+    if (deadline.tv_nsec >= NANOSECONDS_PER_SECOND) {
+        ++deadline.tv_sec;
+        deadline.tv_nsec -= NANOSECONDS_PER_SECOND;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
+
+#endif
\ No newline at end of file
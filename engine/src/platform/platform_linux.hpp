@@ -0,0 +1,18 @@
+#pragma once
+#include "platform/platform.hpp"
+#include <vector>
+#include <xcb/xcb.h>
+
+struct LinuxState : Platform::State {
+    xcb_connection_t* connection{nullptr};
+    xcb_screen_t* screen{nullptr};
+    xcb_window_t window{0};
+    u16 width{0};
+    u16 height{0};
+    xcb_atom_t wm_protocols{0};
+    xcb_atom_t wm_delete_window{0};
+
+    // Unshifted keysym for every keycode in [min_keycode, max_keycode]
+    xcb_keycode_t min_keycode{0};
+    std::vector<xcb_keysym_t> keysyms;
+};
\ No newline at end of file
@@ -13,12 +13,23 @@
 #include <windowsx.h>  // param input extraction
 
 
-Platform::Platform(InputHandler& inputHandler, EventManager& eventHandler) {
+Platform::Platform(InputHandler& inputHandler, EventManager& eventHandler, bool headless) : mHeadless{headless} {
     mState = std::make_unique<WindowsState>();
-    mContext = std::make_unique<EventContext>(&inputHandler, &eventHandler);
+    mContext = std::make_unique<EventContext>(&inputHandler, &eventHandler, this);
     MSG_TRACE("Platform: {:p} created", static_cast<void*>(this));
 }
 bool Platform::startup(const std::string& application_name, int x, int y, int width, int height) {
+    // Clock setup
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    mClock_frequency = 1.0 / (double)frequency.QuadPart;
+    QueryPerformanceCounter(&dynamic_cast<WindowsState*>(mState.get())->mStart_time);
+
+    if (mHeadless) {
+        MSG_INFO("Platform: {:p} started headless, no window created", static_cast<void*>(this));
+        return true;
+    }
+
     //TODO Check if there's a better way instead of static_cast
     dynamic_cast<WindowsState*>(mState.get())->h_instance = GetModuleHandleA(0);
 
@@ -91,12 +102,6 @@ bool Platform::startup(const std::string& application_name, int x, int y, int wi
     // If initially maximized, use SW_SHOWMAXIMIZED : SW_MAXIMIZE
     ShowWindow(dynamic_cast<WindowsState*>(mState.get())->hwnd, show_window_command_flags);
 
-    // Clock setup
-    LARGE_INTEGER frequency;
-    QueryPerformanceFrequency(&frequency);
-    mClock_frequency = 1.0 / (double)frequency.QuadPart;
-    QueryPerformanceCounter(&dynamic_cast<WindowsState*>(mState.get())->mStart_time);
-
     MSG_TRACE("Platform: {:p} initialized", static_cast<void*>(this));
     return true;
 }
@@ -108,6 +113,10 @@ void Platform::shutdown() {
 }
 
 bool Platform::pumpMessages() {
+    if (mHeadless) {
+        return pumpScriptedInput();
+    }
+
     MSG message;
     while (PeekMessageA(&message, nullptr, 0, 0, PM_REMOVE) != 0) {
         TranslateMessage(&message);
@@ -189,19 +198,19 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, UINT msg, WPARAM wParam, LPARA
         case WM_SYSKEYUP: {
             bool pressed = (msg == WM_KEYDOWN) || (msg == WM_SYSKEYDOWN);
             auto key = static_cast<InputHandler::Key>(wParam);
-            eventContext->inputHandler->process_key(key, pressed);
+            eventContext->inputHandler->process_key(key, pressed, eventContext->platform->getAbsoluteTime());
         } break;
         case WM_MOUSEMOVE: {
             i16 x_position = static_cast<i16>(GET_X_LPARAM(lParam));
             i16 y_position = static_cast<i16>(GET_Y_LPARAM(lParam));
 
-            eventContext->inputHandler->process_mouse_move(x_position, y_position);
+            eventContext->inputHandler->process_mouse_move(x_position, y_position, eventContext->platform->getAbsoluteTime());
         } break;
         case WM_MOUSEWHEEL: {
             i8 z_delta = static_cast<i8>(GET_WHEEL_DELTA_WPARAM(wParam));
             if (z_delta != 0) {
                 z_delta = (z_delta < 0) ? -1 : 1;
-                eventContext->inputHandler->process_mouse_wheel(z_delta);
+                eventContext->inputHandler->process_mouse_wheel(z_delta, eventContext->platform->getAbsoluteTime());
             }
         } break;
         case WM_LBUTTONDOWN:
@@ -226,7 +235,7 @@ LRESULT CALLBACK win32_process_message(HWND hwnd, UINT msg, WPARAM wParam, LPARA
                     button = InputHandler::Button::BUTTON_MIDDLE;
                     break;
             }
-            eventContext->inputHandler->process_button(button, pressed);
+            eventContext->inputHandler->process_button(button, pressed, eventContext->platform->getAbsoluteTime());
         } break;
     }
 
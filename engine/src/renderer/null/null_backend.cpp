@@ -0,0 +1,131 @@
+#include "null_backend.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+
+NullRenderer::NullRenderer(Platform* platform, uint32_t width, uint32_t height)
+    : RendererBackend(platform, RendererBackend::BackendType::RENDERER_BACKEND_TYPE_NULL, width, height) {
+    MSG_TRACE("Null Renderer: {:p} created", static_cast<void*>(this));
+}
+
+NullRenderer::~NullRenderer() {
+    MSG_TRACE("Null Renderer: {:p} destroyed", static_cast<void*>(this));
+}
+
+void NullRenderer::resized(uint32_t width, uint32_t height) {
+    mWidth = width;
+    mHeight = height;
+}
+
+bool NullRenderer::begin_frame(f64 /*deltaTime*/) {
+    return true;
+}
+
+void NullRenderer::draw(const DrawCommand& command) {
+    if (!is_live_buffer(command.vertexBuffer) ||
+        (command.indexBuffer.is_valid() && !is_live_buffer(command.indexBuffer)) ||
+        (command.resources.is_valid() && !is_live_buffer(command.resources))) {
+        MSG_WARN("Null Renderer: draw with an invalid buffer handle ignored");
+        return;
+    }
+    if (command.pipeline.id > mPipelines.size()) {
+        MSG_WARN("Null Renderer: draw with an invalid pipeline handle ignored");
+        return;
+    }
+    ++mStatistics.drawCalls;
+}
+
+void NullRenderer::dispatch_batch(std::span<const DispatchCommand> commands) {
+    for (const auto& command : commands) {
+        const auto& pipeline = command.pipeline;
+        const bool livePipeline = pipeline.is_valid() && pipeline.id <= mComputePipelines.size() &&
+            mComputePipelines[pipeline.id - 1].has_value();
+        if (!livePipeline || mComputePipelines[pipeline.id - 1] != command.bufferCount ||
+            !std::ranges::all_of(std::span{command.buffers}.first(command.bufferCount),
+                                 [this](BufferHandle buffer) { return is_live_buffer(buffer); })) {
+            MSG_WARN("Null Renderer: dispatch with an invalid pipeline or buffer handle ignored");
+            continue;
+        }
+        ++mStatistics.dispatches;
+    }
+}
+
+bool NullRenderer::end_frame(f64 /*deltaTime*/) {
+    mFrameTimings.presentedTime = mPlatform->getAbsoluteTime();
+    ++mStatistics.frameCount;
+    return true;
+}
+
+BufferHandle NullRenderer::create_buffer(BufferUsage /*usage*/, u64 size) {
+    if (size == 0) {
+        MSG_ERROR("Null Renderer: cannot create an empty buffer");
+        return {};
+    }
+    auto freeSlot = std::ranges::find(mBufferSizes, u64{0});
+    if (freeSlot == mBufferSizes.end()) {
+        freeSlot = mBufferSizes.insert(mBufferSizes.end(), 0);
+    }
+    *freeSlot = size;
+    return BufferHandle{static_cast<u32>(freeSlot - mBufferSizes.begin()) + 1};
+}
+
+bool NullRenderer::upload_buffer(BufferHandle buffer, const void* data, u64 size, u64 offset) {
+    if (!is_live_buffer(buffer) || data == nullptr || size > mBufferSizes[buffer.id - 1] ||
+        offset > mBufferSizes[buffer.id - 1] - size) {
+        MSG_ERROR("Null Renderer: invalid upload of {} bytes at offset {} to buffer {}", size, offset, buffer.id);
+        return false;
+    }
+    mStatistics.bytesUploaded += size;
+    return true;
+}
+
+void NullRenderer::destroy_buffer(BufferHandle buffer) {
+    if (is_live_buffer(buffer)) {
+        mBufferSizes[buffer.id - 1] = 0;
+    }
+}
+
+ComputePipelineHandle NullRenderer::create_compute_pipeline(const std::string& /*unused*/, u32 bufferCount,
+                                                           u32 pushConstantSize) {
+    if (bufferCount > DispatchCommand::MAX_BUFFERS || pushConstantSize > DispatchCommand::MAX_PUSH_CONSTANT_SIZE) {
+        MSG_ERROR("Null Renderer: compute pipeline exceeds the dispatch limits");
+        return {};
+    }
+    auto freeSlot = std::ranges::find_if(mComputePipelines, [](const auto& slot) { return !slot.has_value(); });
+    if (freeSlot == mComputePipelines.end()) {
+        freeSlot = mComputePipelines.insert(mComputePipelines.end(), std::nullopt);
+    }
+    *freeSlot = bufferCount;
+    return ComputePipelineHandle{static_cast<u32>(freeSlot - mComputePipelines.begin()) + 1};
+}
+
+void NullRenderer::destroy_compute_pipeline(ComputePipelineHandle pipeline) {
+    if (pipeline.is_valid() && pipeline.id <= mComputePipelines.size()) {
+        mComputePipelines[pipeline.id - 1].reset();
+    }
+}
+
+PipelineHandle NullRenderer::create_pipeline(const PipelineDescription& description) {
+    auto pipeline = std::ranges::find(mPipelines, description);
+    if (pipeline == mPipelines.end()) {
+        pipeline = mPipelines.insert(mPipelines.end(), description);
+    }
+    return PipelineHandle{static_cast<u32>(pipeline - mPipelines.begin()) + 1};
+}
+
+bool NullRenderer::is_pipeline_ready(PipelineHandle pipeline) const {
+    return pipeline.is_valid() && pipeline.id <= mPipelines.size();
+}
+
+// No pipeline ever reads the bindless set, benchmarks fall back to their descriptor set path
+bool NullRenderer::supports_bindless() const {
+    return false;
+}
+
+// Uploads cost nothing but their bookkeeping, there are no copies to move anywhere
+bool NullRenderer::uses_transfer_queue() const {
+    return false;
+}
+
+bool NullRenderer::is_live_buffer(BufferHandle buffer) const {
+    return buffer.is_valid() && buffer.id <= mBufferSizes.size() && mBufferSizes[buffer.id - 1] != 0;
+}
\ No newline at end of file
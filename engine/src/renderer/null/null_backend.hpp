@@ -0,0 +1,49 @@
+#pragma once
+
+#include "defines.hpp"
+#include "renderer/renderer_backend.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+// Accepts all frontend work and discards it, only counting what was submitted.
+// Used to measure engine CPU cost without any GPU or driver work.
+class NullRenderer : public RendererBackend {
+public:
+    NullRenderer(const NullRenderer&) = delete;
+    NullRenderer(NullRenderer&&) = delete;
+    NullRenderer& operator=(const NullRenderer&) = delete;
+    NullRenderer& operator=(NullRenderer&&) = delete;
+    NullRenderer(Platform* platform, uint32_t width, uint32_t height);
+    ~NullRenderer() override;
+
+    void resized(uint32_t width, uint32_t height) override;
+
+    bool begin_frame(f64 deltaTime) override;
+    void draw(const DrawCommand& command) override;
+    void dispatch_batch(std::span<const DispatchCommand> commands) override;
+    bool end_frame(f64 deltaTime) override;
+
+    BufferHandle create_buffer(BufferUsage usage, u64 size) override;
+    bool upload_buffer(BufferHandle buffer, const void* data, u64 size, u64 offset) override;
+    void destroy_buffer(BufferHandle buffer) override;
+
+    ComputePipelineHandle create_compute_pipeline(const std::string& shaderPath, u32 bufferCount,
+                                                  u32 pushConstantSize) override;
+    void destroy_compute_pipeline(ComputePipelineHandle pipeline) override;
+
+    PipelineHandle create_pipeline(const PipelineDescription& description) override;
+    [[nodiscard]] bool is_pipeline_ready(PipelineHandle pipeline) const override;
+    [[nodiscard]] bool supports_bindless() const override;
+    [[nodiscard]] bool uses_transfer_queue() const override;
+
+private:
+    // Size of every live buffer indexed by handle id - 1, destroyed buffers leave a 0 sized slot for reuse
+    std::vector<u64> mBufferSizes;
+    // Buffer count of every live compute pipeline indexed by handle id - 1, destroyed pipelines leave an empty slot
+    std::vector<std::optional<u32>> mComputePipelines;
+    // Indexed by handle id - 1, pipelines are ready as soon as they are created
+    std::vector<PipelineDescription> mPipelines;
+
+    [[nodiscard]] bool is_live_buffer(BufferHandle buffer) const;
+};
\ No newline at end of file
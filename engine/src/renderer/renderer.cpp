@@ -1,31 +1,200 @@
 #include "renderer.hpp"
 #include "core/logger.hpp"
+#include "null/null_backend.hpp"
 #include "renderer_backend.hpp"
 #include "vulkan/vulkan_backend.hpp"
+#include <stdexcept>
+#include <utility>
 
+namespace {
+    // Results are polled once per frame, the slack covers frames finishing while the game is between polls
+    constexpr size_t FRAME_RESULT_SLACK = 4;
+}  // namespace
 
-Renderer::Renderer(std::string applicationName, Platform* platform, i16 width, i16 height) {
-    //TODO: make renderer configurable
-    mRenderer = std::make_unique<VulkanRenderer>(applicationName, platform, width, height);
+Renderer::Renderer(std::string applicationName, Platform* platform, RendererBackend::BackendType backendType,
+                   i16 width, i16 height, bool headless, JobSystem* jobSystem, u32 renderQueueDepth,
+                   u32 framesInFlight, std::string pipelineCachePath, bool transferQueue)
+    : mCommands{renderQueueDepth}, mResults{renderQueueDepth + FRAME_RESULT_SLACK} {
+    switch (backendType) {
+        case RendererBackend::BackendType::RENDERER_BACKEND_TYPE_VULKAN:
+            mRenderer = std::make_unique<VulkanRenderer>(applicationName, platform, width, height, headless,
+                                                          framesInFlight, jobSystem, &mBackendMutex,
+                                                          std::move(pipelineCachePath), transferQueue);
+            break;
+        case RendererBackend::BackendType::RENDERER_BACKEND_TYPE_NULL:
+            mRenderer = std::make_unique<NullRenderer>(platform, width, height);
+            break;
+        default:
+            MSG_FATAL("Unsupported renderer backend requested!");
+            throw std::runtime_error("Unsupported renderer backend");
+    }
+    if (renderQueueDepth > 0) {
+        mRenderThread = std::thread{&Renderer::render_thread_main, this};
+        MSG_INFO("Render thread started with a queue depth of {}", renderQueueDepth);
+    }
     MSG_TRACE("Renderer: {:p} created", static_cast<void*>(this));
 }
 
-Renderer::~Renderer() = default;
+Renderer::~Renderer() {
+    stop_render_thread();
+}
 
 void Renderer::on_resize(i16 width, i16 height) {
+    // Queued in order with the frames, the swapchain is only ever recreated between two frames on the render thread
+    if (has_render_thread()) {
+        push_command(RenderCommand::Type::RESIZE, width, height, nullptr);
+        return;
+    }
+    const std::scoped_lock lock{mBackendMutex};
     if (mRenderer != nullptr) {
         mRenderer->resized(width, height);
     }
 }
 
 bool Renderer::draw_frame(const RenderPacket& renderPacket) {
+    if (has_render_thread()) {
+        push_command(RenderCommand::Type::DRAW, 0, 0, &renderPacket);
+        return true;
+    }
+    const bool presented = draw_packet(renderPacket);
+    push_result(FrameResult{presented, renderPacket.inputTime, mRenderer->get_frame_timings()});
+    return presented;
+}
+
+bool Renderer::poll_frame_result(FrameResult& result) {
+    auto* front = mResults.front();
+    if (front == nullptr) {
+        return false;
+    }
+    result = *front;
+    mResults.pop();
+    return true;
+}
+
+void Renderer::stop_render_thread() {
+    if (!has_render_thread()) {
+        return;
+    }
+    push_command(RenderCommand::Type::STOP, 0, 0, nullptr);
+    mRenderThread.join();
+    if (mDroppedResults > 0) {
+        MSG_WARN("Render thread dropped {} frame results that were never polled", mDroppedResults);
+    }
+    MSG_TRACE("Render thread stopped");
+}
+
+BufferHandle Renderer::create_buffer(BufferUsage usage, u64 size) {
+    const std::scoped_lock lock{mBackendMutex};
+    return mRenderer->create_buffer(usage, size);
+}
+
+bool Renderer::upload_buffer(BufferHandle buffer, const void* data, u64 size, u64 offset) {
+    const std::scoped_lock lock{mBackendMutex};
+    return mRenderer->upload_buffer(buffer, data, size, offset);
+}
+
+void Renderer::destroy_buffer(BufferHandle buffer) {
+    const std::scoped_lock lock{mBackendMutex};
+    mRenderer->destroy_buffer(buffer);
+}
+
+ComputePipelineHandle Renderer::create_compute_pipeline(const std::string& shaderPath, u32 bufferCount,
+                                                       u32 pushConstantSize) {
+    const std::scoped_lock lock{mBackendMutex};
+    return mRenderer->create_compute_pipeline(shaderPath, bufferCount, pushConstantSize);
+}
+
+void Renderer::destroy_compute_pipeline(ComputePipelineHandle pipeline) {
+    const std::scoped_lock lock{mBackendMutex};
+    mRenderer->destroy_compute_pipeline(pipeline);
+}
+
+PipelineHandle Renderer::create_pipeline(const PipelineDescription& description) {
+    const std::scoped_lock lock{mBackendMutex};
+    return mRenderer->create_pipeline(description);
+}
+
+bool Renderer::is_pipeline_ready(PipelineHandle pipeline) {
+    const std::scoped_lock lock{mBackendMutex};
+    return mRenderer->is_pipeline_ready(pipeline);
+}
+
+bool Renderer::supports_bindless() const {
+    // Fixed when the backend is created, no lock needed
+    return mRenderer->supports_bindless();
+}
+
+bool Renderer::uses_transfer_queue() const {
+    // Fixed when the backend is created, no lock needed
+    return mRenderer->uses_transfer_queue();
+}
+
+const RendererBackend::Statistics& Renderer::get_statistics() const {
+    return mRenderer->get_statistics();
+}
+
+bool Renderer::draw_packet(const RenderPacket& renderPacket) {
+    const std::scoped_lock lock{mBackendMutex};
     if (!mRenderer->begin_frame(renderPacket.deltaTime)) {
         MSG_WARN("Frame failed to start rendering");
         return false;
     };
+    if (!renderPacket.dispatchCommands.empty()) {
+        mRenderer->dispatch_batch(renderPacket.dispatchCommands);
+    }
+    mRenderer->draw_batch(renderPacket.drawCommands);
     if (!mRenderer->end_frame(renderPacket.deltaTime)) {
         MSG_WARN("Frame failed to finish rendering");
         return false;
     }
     return true;
 }
+
+void Renderer::push_command(RenderCommand::Type type, i16 width, i16 height, const RenderPacket* packet) {
+    mCommands.wait_for_space();
+    auto* command = mCommands.begin_push();
+    command->type = type;
+    command->width = width;
+    command->height = height;
+    if (packet != nullptr) {
+        // Copied into the slot's own packet, its draw list keeps its capacity between frames
+        command->packet.deltaTime = packet->deltaTime;
+        command->packet.inputTime = packet->inputTime;
+        command->packet.dispatchCommands.assign(packet->dispatchCommands.begin(), packet->dispatchCommands.end());
+        command->packet.drawCommands.assign(packet->drawCommands.begin(), packet->drawCommands.end());
+    }
+    mCommands.end_push();
+}
+
+void Renderer::push_result(const FrameResult& result) {
+    auto* slot = mResults.begin_push();
+    if (slot == nullptr) {
+        ++mDroppedResults;
+        return;
+    }
+    *slot = result;
+    mResults.end_push();
+}
+
+void Renderer::render_thread_main() {
+    while (true) {
+        mCommands.wait_for_element();
+        auto& command = *mCommands.front();
+        switch (command.type) {
+            case RenderCommand::Type::DRAW: {
+                const bool presented = draw_packet(command.packet);
+                push_result(FrameResult{presented, command.packet.inputTime, mRenderer->get_frame_timings()});
+                break;
+            }
+            case RenderCommand::Type::RESIZE: {
+                const std::scoped_lock lock{mBackendMutex};
+                mRenderer->resized(command.width, command.height);
+                break;
+            }
+            case RenderCommand::Type::STOP:
+                mCommands.pop();
+                return;
+        }
+        mCommands.pop();
+    }
+}
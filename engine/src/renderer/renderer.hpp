@@ -1,27 +1,104 @@
 #pragma once
 
+#include "core/spsc_queue.hpp"
 #include "defines.hpp"
+#include "renderer/renderer_backend.hpp"
+#include "renderer/renderer_types.hpp"
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
-class RendererBackend;
+class JobSystem;
 class Platform;
 
+// Buffer calls may come from job threads while a frame is drawn, the backend is only ever entered by one
+// thread at a time. A frame recording in parallel releases the lock while it waits on its jobs, the wait runs
+// other jobs which may call back into the renderer on the same thread. Any other re-entry deadlocks.
+//
+// With a render queue depth above 0 frames are drawn on a dedicated render thread. draw_frame() and on_resize()
+// only queue work, blocking while the queue is full, so waiting on the GPU no longer stalls the game. A deeper
+// queue lets the game run further ahead at the cost of input latency. Buffers referenced by queued packets must
+// stay alive until the frame results for them have been polled, as must compute pipelines.
 class Renderer {
 public:
-    struct RenderPacket {
-        f64 deltaTime;
+    // Outcome of one draw_frame() call
+    struct FrameResult {
+        bool presented{false};
+        f64 inputTime{0};
+        RendererBackend::FrameTimings timings{};
     };
+
     Renderer(const Renderer&) = delete;
     Renderer(Renderer&&) = delete;
     Renderer& operator=(const Renderer&) = delete;
     Renderer& operator=(Renderer&&) = delete;
-    Renderer(std::string applicationName, Platform* platform, i16 width, i16 height);
+    // A headless renderer draws into offscreen images instead of a window surface.
+    // Frames drawn on a job system thread record their draws in parallel when a job system is given.
+    // Frames in flight bounds how many frames the CPU may record ahead of the GPU.
+    // Compiled pipelines persist in the pipeline cache file between runs, an empty path disables it.
+    // Uploads are copied on a dedicated transfer queue if the device has one and transferQueue is set
+    Renderer(std::string applicationName, Platform* platform, RendererBackend::BackendType backendType, i16 width,
+             i16 height, bool headless, JobSystem* jobSystem = nullptr, u32 renderQueueDepth = 0,
+             u32 framesInFlight = 2, std::string pipelineCachePath = {}, bool transferQueue = true);
     ~Renderer();
 
     void on_resize(i16 width, i16 height);
+    // Draws the packet, or queues a copy of it for the render thread and returns true
     bool draw_frame(const RenderPacket& renderPacket);
+    // Frame results in submission order, only the thread running the frame loop may poll
+    bool poll_frame_result(FrameResult& result);
+    // Draws everything still queued and joins the render thread, later frames are drawn on the calling thread
+    void stop_render_thread();
+
+    [[nodiscard]] DLL_EXPORT BufferHandle create_buffer(BufferUsage usage, u64 size);
+    DLL_EXPORT bool upload_buffer(BufferHandle buffer, const void* data, u64 size, u64 offset = 0);
+    DLL_EXPORT void destroy_buffer(BufferHandle buffer);
+
+    // Relative shader paths are looked up in the engine shader directory.
+    // Returns an invalid handle when the shader cannot be loaded or exceeds the DispatchCommand limits
+    [[nodiscard]] DLL_EXPORT ComputePipelineHandle create_compute_pipeline(const std::string& shaderPath,
+                                                                           u32 bufferCount, u32 pushConstantSize);
+    DLL_EXPORT void destroy_compute_pipeline(ComputePipelineHandle pipeline);
+
+    // Equal descriptions return the same handle, pipelines live as long as the renderer. Returns right away,
+    // draws using the pipeline are drawn with the builtin pipeline until it finished compiling.
+    // Returns an invalid handle when a shader does not exist
+    [[nodiscard]] DLL_EXPORT PipelineHandle create_pipeline(const PipelineDescription& description);
+    [[nodiscard]] DLL_EXPORT bool is_pipeline_ready(PipelineHandle pipeline);
+    // Pipelines may read storage buffers through the bindless set, see DrawCommand::resources
+    [[nodiscard]] DLL_EXPORT bool supports_bindless() const;
+    [[nodiscard]] DLL_EXPORT bool uses_transfer_queue() const;
+
+    [[nodiscard]] DLL_EXPORT const RendererBackend::Statistics& get_statistics() const;
+    [[nodiscard]] bool has_render_thread() const {
+        return mRenderThread.joinable();
+    }
 
 private:
+    struct RenderCommand {
+        enum class Type {
+            DRAW,
+            RESIZE,
+            STOP
+        };
+
+        Type type{Type::DRAW};
+        i16 width{0};
+        i16 height{0};
+        RenderPacket packet;
+    };
+
     std::unique_ptr<RendererBackend> mRenderer;
+    std::mutex mBackendMutex;
+
+    std::thread mRenderThread;
+    SpscQueue<RenderCommand> mCommands;
+    SpscQueue<FrameResult> mResults;
+    u64 mDroppedResults{0};
+
+    bool draw_packet(const RenderPacket& renderPacket);
+    void push_command(RenderCommand::Type type, i16 width, i16 height, const RenderPacket* packet);
+    void push_result(const FrameResult& result);
+    void render_thread_main();
 };
\ No newline at end of file
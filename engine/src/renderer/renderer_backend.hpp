@@ -1,6 +1,9 @@
 #pragma once
 
 #include "defines.hpp"
+#include "renderer/renderer_types.hpp"
+#include <span>
+#include <string>
 
 class Platform;
 
@@ -9,7 +12,33 @@ public:
     enum class BackendType {
         RENDERER_BACKEND_TYPE_VULKAN,
         RENDERER_BACKEND_TYPE_OPENGL,
-        RENDERER_BACKEND_TYPE_DIRECTX
+        RENDERER_BACKEND_TYPE_DIRECTX,
+        RENDERER_BACKEND_TYPE_NULL
+    };
+
+    // Host side timings of the last frame, in seconds
+    struct FrameTimings {
+        f64 gpuWaitTime{0};
+        f64 presentTime{0};
+        f64 presentedTime{0};  // Platform time the frame was handed to the display
+        f64 recordTime{0};     // Recording the frame's draws into command buffers
+    };
+
+    // Work accepted from the frontend since startup
+    struct Statistics {
+        u64 frameCount{0};
+        u64 drawCalls{0};
+        u64 dispatches{0};
+        // Draws made with the builtin pipeline since theirs was still compiling
+        u64 fallbackDraws{0};
+        u64 bytesUploaded{0};
+        // Uploads that had to wait for the GPU to free staging space
+        u64 uploadStalls{0};
+        // GPU memory reserved by the backend's allocator and the part of it resources use
+        u64 gpuBytesReserved{0};
+        u64 gpuBytesUsed{0};
+        // Pipeline cache data found on disk at startup, 0 on a cold start
+        u64 pipelineCacheBytesLoaded{0};
     };
 
     RendererBackend(const RendererBackend&) = default;
@@ -23,11 +52,50 @@ public:
     virtual void resized(uint32_t width, uint32_t height) = 0;
 
     virtual bool begin_frame(f64 deltaTime) = 0;
+    // Only valid between a successful begin_frame and end_frame
+    virtual void draw(const DrawCommand& command) = 0;
+    // Backends able to record draws in parallel override this, by default each draw is recorded in turn
+    virtual void draw_batch(std::span<const DrawCommand> commands) {
+        for (const auto& command : commands) {
+            draw(command);
+        }
+    }
+    // Only valid between a successful begin_frame and the frame's first draw
+    virtual void dispatch_batch(std::span<const DispatchCommand> commands) = 0;
     virtual bool end_frame(f64 deltaTime) = 0;
 
+    virtual BufferHandle create_buffer(BufferUsage usage, u64 size) = 0;
+    virtual bool upload_buffer(BufferHandle buffer, const void* data, u64 size, u64 offset) = 0;
+    virtual void destroy_buffer(BufferHandle buffer) = 0;
+
+    // The shader binds bufferCount storage buffers and takes up to pushConstantSize bytes of push constants
+    virtual ComputePipelineHandle create_compute_pipeline(const std::string& shaderPath, u32 bufferCount,
+                                                          u32 pushConstantSize) = 0;
+    virtual void destroy_compute_pipeline(ComputePipelineHandle pipeline) = 0;
+
+    // Equal descriptions share one pipeline, which lives as long as the backend. Never blocks on compilation
+    virtual PipelineHandle create_pipeline(const PipelineDescription& description) = 0;
+    [[nodiscard]] virtual bool is_pipeline_ready(PipelineHandle pipeline) const = 0;
+    // Whether pipelines may index the bindless set, which holds every storage buffer. Fixed at creation
+    [[nodiscard]] virtual bool supports_bindless() const = 0;
+    // Whether uploads are copied on a queue of their own, overlapping the frames drawn meanwhile. Fixed at creation
+    [[nodiscard]] virtual bool uses_transfer_queue() const = 0;
+
+    [[nodiscard]] const FrameTimings& get_frame_timings() const {
+        return mFrameTimings;
+    }
+    [[nodiscard]] const Statistics& get_statistics() const {
+        return mStatistics;
+    }
+    [[nodiscard]] BackendType get_backend_type() const {
+        return mBackendType;
+    }
+
 protected:
     Platform* mPlatform;
     BackendType mBackendType;
     uint32_t mWidth{0};
     uint32_t mHeight{0};
+    FrameTimings mFrameTimings{};
+    Statistics mStatistics{};
 };
\ No newline at end of file
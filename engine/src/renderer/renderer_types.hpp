@@ -0,0 +1,123 @@
+#pragma once
+
+#include "defines.hpp"
+#include <array>
+#include <string>
+#include <vector>
+
+// Opaque handle to a buffer owned by the renderer backend, id 0 is never a valid buffer
+struct BufferHandle {
+    u32 id{0};
+
+    [[nodiscard]] bool is_valid() const {
+        return id != 0;
+    }
+};
+
+// Opaque handle to a compute pipeline owned by the renderer backend, id 0 is never a valid pipeline
+struct ComputePipelineHandle {
+    u32 id{0};
+
+    [[nodiscard]] bool is_valid() const {
+        return id != 0;
+    }
+};
+
+// Opaque handle to a graphics pipeline owned by the renderer backend, id 0 draws with the builtin pipeline
+struct PipelineHandle {
+    u32 id{0};
+
+    [[nodiscard]] bool is_valid() const {
+        return id != 0;
+    }
+};
+
+enum class BufferUsage {
+    BUFFER_USAGE_VERTEX,
+    BUFFER_USAGE_INDEX,
+    BUFFER_USAGE_UNIFORM,
+    // Read and written by compute dispatches, and drawable as vertices or indices
+    BUFFER_USAGE_STORAGE
+};
+
+// Vertex layout of the builtin shaders
+struct Vertex {
+    f32 position[3];
+    f32 color[4];
+};
+
+enum class VertexLayout : u8 {
+    VERTEX_LAYOUT_POSITION_COLOR  // Vertex
+};
+
+enum class PrimitiveTopology : u8 {
+    PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+    PRIMITIVE_TOPOLOGY_LINE_LIST,
+    PRIMITIVE_TOPOLOGY_POINT_LIST
+};
+
+enum class CullMode : u8 {
+    CULL_MODE_NONE,
+    CULL_MODE_BACK,
+    CULL_MODE_FRONT
+};
+
+enum class BlendMode : u8 {
+    BLEND_MODE_OPAQUE,
+    BLEND_MODE_ALPHA,
+    BLEND_MODE_ADDITIVE
+};
+
+// Fixed state of a graphics pipeline, the render target formats are the backend's.
+// Relative shader paths are looked up in the engine shader directory
+struct PipelineDescription {
+    std::string vertexShader{"builtin.vert.spv"};
+    std::string fragmentShader{"builtin.frag.spv"};
+    VertexLayout vertexLayout{VertexLayout::VERTEX_LAYOUT_POSITION_COLOR};
+    PrimitiveTopology topology{PrimitiveTopology::PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+    CullMode cullMode{CullMode::CULL_MODE_NONE};
+    BlendMode blendMode{BlendMode::BLEND_MODE_OPAQUE};
+    bool depthTest{true};
+    bool depthWrite{true};
+
+    bool operator==(const PipelineDescription&) const = default;
+};
+
+// Index buffers always hold u32 indices, a draw without an index buffer is non-indexed.
+// Pipelines whose shaders read a storage buffer take it from resources, bound with a descriptor set per draw or
+// indexed in the bindless set, whichever the shaders declare
+struct DrawCommand {
+    BufferHandle vertexBuffer;
+    BufferHandle indexBuffer;
+    u32 elementCount{0};  // Vertices, or indices when indexBuffer is valid
+    u32 firstElement{0};
+    u32 instanceCount{1};
+    // Draws with the builtin pipeline while the pipeline is still compiling
+    PipelineHandle pipeline{};
+    // Storage buffer, ignored by pipelines reading none
+    BufferHandle resources{};
+};
+
+// Binds the buffers as storage buffers 0..bufferCount - 1 of set 0, in the order given.
+// Only storage buffers can be bound, dispatches of a frame run in order and see each other's writes
+struct DispatchCommand {
+    static constexpr u32 MAX_BUFFERS = 4;
+    static constexpr u32 MAX_PUSH_CONSTANT_SIZE = 128;
+
+    ComputePipelineHandle pipeline;
+    std::array<BufferHandle, MAX_BUFFERS> buffers{};
+    u32 bufferCount{0};
+    u32 groupCountX{1};
+    u32 groupCountY{1};
+    u32 groupCountZ{1};
+    std::array<u8, MAX_PUSH_CONSTANT_SIZE> pushConstants{};
+    u32 pushConstantSize{0};
+};
+
+struct RenderPacket {
+    f64 deltaTime{0};
+    f64 inputTime{0};  // Platform time of the oldest input this frame consumed, 0 when there was none
+    // Run before the frame's draws, which see their results
+    std::vector<DispatchCommand> dispatchCommands;
+    std::vector<DrawCommand> drawCommands;
+};
\ No newline at end of file
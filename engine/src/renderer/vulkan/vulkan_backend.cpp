@@ -1,23 +1,78 @@
 #include "vulkan_backend.hpp"
+#include "core/job_system.hpp"
 #include "core/logger.hpp"
+#include "platform/platform.hpp"
+#include "vulkan_bindless_set.hpp"
+#include "vulkan_buffer.hpp"
 #include "vulkan_command_buffer.hpp"
+#include "vulkan_command_pool.hpp"
+#include "vulkan_compute_pipeline.hpp"
 #include "vulkan_defines.inl"
+#include "vulkan_descriptor_allocator.hpp"
+#include "vulkan_descriptor_set_cache.hpp"
 #include "vulkan_device.hpp"
-#include "vulkan_fence.hpp"
+#include "vulkan_dynamic_rendering.hpp"
 #include "vulkan_framebuffer.hpp"
+#include "vulkan_layout_cache.hpp"
+#include "vulkan_memory_allocator.hpp"
+#include "vulkan_pipeline.hpp"
+#include "vulkan_pipeline_cache.hpp"
+#include "vulkan_pipeline_manager.hpp"
 #include "vulkan_platform.hpp"
 #include "vulkan_renderpass.hpp"
+#include "vulkan_staging_ring.hpp"
 #include "vulkan_swapchain.hpp"
+#include "vulkan_timeline_semaphore.hpp"
 
 
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <exception>
+#include <filesystem>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vulkan/vulkan_core.h>
 
-
-VulkanRenderer::VulkanRenderer(std::string applicationName, Platform* platform, uint32_t width, uint32_t height)
-    : RendererBackend(platform, RendererBackend::BackendType::RENDERER_BACKEND_TYPE_VULKAN, width, height) {
+namespace {
+    // Below this many draws a frame is recorded inline, splitting it costs more than it saves
+    constexpr size_t PARALLEL_RECORDING_MIN_DRAWS = 512;
+    constexpr size_t MIN_DRAWS_PER_CHUNK = 128;
+    // A few chunks per thread even out chunks that take longer to record
+    constexpr size_t CHUNKS_PER_THREAD = 2;
+    constexpr VkDeviceSize STAGING_BYTES_PER_FRAME = 8ULL * 1024 * 1024;
+    // Pipelines are requested in bursts, typically while loading. A couple of threads keep up with them
+    // without competing with the job system for the remaining cores
+    constexpr u32 PIPELINE_COMPILE_THREADS = 2;
+    // Sets of the first pool of each frame's descriptor allocator, it grows from there
+    constexpr u32 FRAME_DESCRIPTOR_SETS_PER_POOL = 64;
+    // Dispatch sets written once and reused every frame, sets beyond are written again each frame
+    constexpr u32 MAX_CACHED_DESCRIPTOR_SETS = 1024;
+    // Compute writes read by the frame's draws, as vertices, indices or draw resources
+    constexpr VkPipelineStageFlags DRAW_READ_STAGES = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    constexpr VkAccessFlags DRAW_READ_ACCESS = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+        VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+    VulkanDynamicRendering::Attachments get_attachments(const VulkanSwapchain& swapchain, u32 imageIndex) {
+        return VulkanDynamicRendering::Attachments{swapchain.get_image(imageIndex), swapchain.get_image_view(imageIndex),
+                                                   swapchain.get_depth_image(), swapchain.get_depth_view()};
+    }
+}  // namespace
+
+VulkanRenderer::VulkanRenderer(std::string applicationName, Platform* platform, uint32_t width, uint32_t height,
+                               bool headless, uint32_t framesInFlight, JobSystem* jobSystem,
+                               std::mutex* backendMutex, std::string pipelineCachePath, bool transferQueue)
+    : RendererBackend(platform, RendererBackend::BackendType::RENDERER_BACKEND_TYPE_VULKAN, width, height),
+      mJobSystem{jobSystem}, mBackendMutex{backendMutex}, mHeadless{headless},
+      mFramesInFlight{std::clamp(framesInFlight, MIN_FRAMES_IN_FLIGHT, MAX_FRAMES_IN_FLIGHT)} {
+    if (mFramesInFlight != framesInFlight) {
+        MSG_WARN("[Vulkan] {} frames in flight requested, using {}", framesInFlight, mFramesInFlight);
+    }
 #if defined(_DEBUG)
     mEnableValidationLayers = true;
 #endif
@@ -69,9 +124,18 @@ VulkanRenderer::VulkanRenderer(std::string applicationName, Platform* platform,
     }
     setup_debug_messenger();
 
-    mSurface = vulkanplatform::create_platform_surface(*mPlatform, mInstance);
+    if (!mHeadless) {
+        mSurface = vulkanplatform::create_platform_surface(*mPlatform, mInstance);
+    }
     mDevice = std::make_unique<VulkanDevice>(mInstance, mSurface, mValidationLayers);
     mSwapchain = std::make_unique<VulkanSwapchain>(*mDevice, mWidth, mHeight);
+    mGraphicsTimeline = std::make_unique<VulkanTimelineSemaphore>(mDevice->get_logical_device());
+    if (transferQueue && mDevice->has_dedicated_transfer_queue()) {
+        mTransferTimeline = std::make_unique<VulkanTimelineSemaphore>(mDevice->get_logical_device());
+    }
+    if (mDevice->has_dedicated_compute_queue()) {
+        mComputeTimeline = std::make_unique<VulkanTimelineSemaphore>(mDevice->get_logical_device());
+    }
 
 
     // TODO: Temp values
@@ -80,14 +144,45 @@ VulkanRenderer::VulkanRenderer(std::string applicationName, Platform* platform,
     VkClearColorValue clearColor{.float32{1.0F, 0.0F, 0.0F, 1.0F}};
     VkClearDepthStencilValue depthStencil{.depth = 1.0F, .stencil = 0};
 
-    mRenderpass =
-        std::make_unique<RenderPass>(mDevice->get_logical_device(), *mSwapchain, renderArea, clearColor, depthStencil);
+    if (mDevice->supports_dynamic_rendering()) {
+        const VkImageLayout finalColorLayout =
+            mSwapchain->is_offscreen() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        mDynamicRendering = std::make_unique<VulkanDynamicRendering>(
+            renderArea, clearColor, depthStencil, mSwapchain->get_image_depth_format(), finalColorLayout);
+    } else {
+        mRenderpass = std::make_unique<RenderPass>(mDevice->get_logical_device(), *mSwapchain, renderArea, clearColor,
+                                                   depthStencil);
+    }
+
+    mPipelineCache = std::make_unique<VulkanPipelineCache>(*mDevice, std::move(pipelineCachePath));
+    mStatistics.pipelineCacheBytesLoaded = mPipelineCache->get_loaded_size();
+    mLayoutCache = std::make_unique<VulkanLayoutCache>(mDevice->get_logical_device());
+    mDescriptorSetCache =
+        std::make_unique<VulkanDescriptorSetCache>(mDevice->get_logical_device(), MAX_CACHED_DESCRIPTOR_SETS);
+    // Before any pipeline is created, bindless shaders are rejected without it
+    if (mDevice->supports_descriptor_indexing()) {
+        mBindlessSet = std::make_unique<VulkanBindlessSet>(*mDevice);
+        mLayoutCache->set_bindless_layout(mBindlessSet->get_layout(), mBindlessSet->get_bindings());
+    }
+    const std::string shaderDirectory{ENGINE_SHADER_DIR};
+    PipelineDescription builtinDescription{};
+    builtinDescription.vertexShader = shaderDirectory + "/" + builtinDescription.vertexShader;
+    builtinDescription.fragmentShader = shaderDirectory + "/" + builtinDescription.fragmentShader;
+    const VulkanPipeline::RenderTarget renderTarget{
+        mRenderpass != nullptr ? mRenderpass->get_handle() : VK_NULL_HANDLE, mSwapchain->get_image_color_format(),
+        mSwapchain->get_image_depth_format()};
+    // Before the pipeline manager starts its compile threads, nothing else uses the cache yet
+    mPipeline = std::make_unique<VulkanPipeline>(mDevice->get_logical_device(), mPipelineCache->get_handle(),
+                                                 *mLayoutCache, renderTarget, builtinDescription);
+    mPipelineManager = std::make_unique<VulkanPipelineManager>(
+        mDevice->get_logical_device(), *mPipelineCache, *mLayoutCache, renderTarget, PIPELINE_COMPILE_THREADS);
 
     create_framebuffers();
 
-    create_command_buffers();
+    create_frame_resources();
+    mStagingRing = std::make_unique<VulkanStagingRing>(*mDevice, mFramesInFlight * STAGING_BYTES_PER_FRAME);
 
-    create_sync_objects();
+    create_image_sync_objects();
 
     MSG_TRACE("[Vulkan] Vulkan Renderer: {:p} initialized", static_cast<void*>(this));
 };
@@ -95,11 +190,28 @@ VulkanRenderer::VulkanRenderer(std::string applicationName, Platform* platform,
 VulkanRenderer::~VulkanRenderer() {
     MSG_DEBUG("Vulkan renderer: {:p} destructor called", static_cast<void*>(this));
     vkDeviceWaitIdle(mDevice->get_logical_device());
+    MSG_INFO("{}", mDevice->get_allocator().get_usage());
+    // Compilations still running finish before the cache is saved
+    mPipelineManager.reset();
+    mPipelineCache->save();
     // Reset pointer to members here since otherwise the destructors will be called in the wrong order (as expected by Vulkan)
-    destroy_sync_objects();
-    destroy_command_buffers();
+    destroy_image_sync_objects();
+    destroy_frame_resources();
     destroy_framebuffers();
+    mStagingRing.reset();
+    mDeferredResources.clear();
+    mDescriptorSetCache.reset();
+    mBuffers.clear();
+    mComputePipelines.clear();
+    mComputeTimeline.reset();
+    mTransferTimeline.reset();
+    mGraphicsTimeline.reset();
+    mPipeline.reset();
+    mLayoutCache.reset();
+    mBindlessSet.reset();
+    mPipelineCache.reset();
     mRenderpass.reset();
+    mDynamicRendering.reset();
     mSwapchain.reset();
     mDevice.reset();
     if (mEnableValidationLayers) {
@@ -109,7 +221,9 @@ VulkanRenderer::~VulkanRenderer() {
             func(mInstance, mDebugMessenger, nullptr);
         }
     }
-    vkDestroySurfaceKHR(mInstance, mSurface, nullptr);
+    if (mSurface != VK_NULL_HANDLE) {
+        vkDestroySurfaceKHR(mInstance, mSurface, nullptr);
+    }
     vkDestroyInstance(mInstance, nullptr);
 }
 
@@ -127,10 +241,11 @@ void VulkanRenderer::recreate_swapchain_resources() {
     vkDeviceWaitIdle(mDevice->get_logical_device());
     mRecreatingSwapChain = true;
     mSwapchain->recreate(mWidth, mHeight);
-    destroy_command_buffers();
     destroy_framebuffers();
     create_framebuffers();
-    create_command_buffers();
+    // The image count may change, nothing is in flight after the idle wait
+    destroy_image_sync_objects();
+    create_image_sync_objects();
     mRecreatingSwapChain = false;
 }
 
@@ -141,29 +256,77 @@ bool VulkanRenderer::begin_frame(f64 /*deltaTime*/) {
     }
     constexpr auto timeout = UINT64_MAX;
 
-    auto& currentInFlightFence = mInFlightFences[mCurrentFrame];
-    auto& currentImageAvailableSemaphore = mImageAvailableSemaphore[mCurrentFrame];
-
+    auto& frame = mFrames[mCurrentFrame];
 
-    if (!currentInFlightFence.wait(timeout)) {
-        MSG_WARN("[Vulkan] In-flight fence wait failure!");
+    // The frame's last submission, image acquisition and the image's previous frame may all block on the GPU
+    const f64 waitStartTime = mPlatform->getAbsoluteTime();
+    if (!mGraphicsTimeline->wait(frame.submitValue, timeout)) {
+        MSG_WARN("[Vulkan] In-flight frame wait failure!");
         return false;
     }
 
-    if (!mSwapchain->acquire_next_image_index(timeout, currentImageAvailableSemaphore, VK_NULL_HANDLE, mImageIndex)) {
+    if (!mSwapchain->acquire_next_image_index(timeout, frame.imageAvailableSemaphore, VK_NULL_HANDLE, mImageIndex)) {
         MSG_WARN("[Vulkan] Failed to acquire next image index!");
         return false;
     }
+    // With fewer frames in flight than images, or images returned out of order, the image may still be
+    // rendered to by another frame
+    if (!mGraphicsTimeline->wait(mImageSubmitValues[mImageIndex], timeout)) {
+        MSG_WARN("[Vulkan] Image in-flight wait failure!");
+        return false;
+    }
+    // Uploads are submitted a frame ahead of the draws reading them, this only blocks when the transfer
+    // queue falls behind by a whole cycle of frames in flight
+    if (mTransferTimeline != nullptr && !mTransferTimeline->wait(frame.transferSubmitValue, timeout)) {
+        MSG_WARN("[Vulkan] In-flight upload wait failure!");
+        return false;
+    }
+    if (mComputeTimeline != nullptr && !mComputeTimeline->wait(frame.computeSubmitValue, timeout)) {
+        MSG_WARN("[Vulkan] In-flight dispatch wait failure!");
+        return false;
+    }
+    mFrameTimings.gpuWaitTime = mPlatform->getAbsoluteTime() - waitStartTime;
 
-    currentInFlightFence.reset();
+    collect_deferred_deletions();
 
-    auto& currentCommandBuffer = mCommandBuffers[mImageIndex];
-    currentCommandBuffer.reset_state();
-    currentCommandBuffer.begin_multiple_use();
+    // The submit value covers every command buffer of this frame's last submission, its pools are reset wholesale
+    frame.commandPool->reset();
+    for (auto& pool : frame.recordingPools) {
+        pool->reset();
+    }
+    if (frame.transferPool != nullptr) {
+        frame.transferPool->reset();
+    }
+    if (frame.computePool != nullptr) {
+        frame.computePool->reset();
+    }
+    frame.descriptorAllocator->reset();
+
+    mFrameCommandBuffer = &frame.commandPool->acquire(true);
+    mFrameCommandBuffer->begin_single_use();
+
+    // Uploads staged since the last submission land before any of this frame's draws
+    mStagingRing->reclaim(get_upload_timeline());
+    mFrameStagingHead = 0;
+    if (mTransferTimeline != nullptr) {
+        // The transfer queue copies while the graphics queue still renders the frames before, this frame's
+        // submission waits for the copies
+        submit_transfers();
+    } else if (mComputeTimeline != nullptr) {
+        // This frame's dispatches are submitted before the frame itself, the copies have to go ahead of them
+        flush_uploads();
+    } else {
+        mFrameStagingHead = mStagingRing->record_copies(mFrameCommandBuffer->get_handle());
+    }
 
-    auto& currentFrameBuffer = mFrameBuffers[mImageIndex];
+    // The render pass begins with the first draws, once it is known how they are recorded
+    mRenderPassContents = RenderPassContents::RENDER_PASS_CONTENTS_NONE;
+    mFrameTimings.recordTime = 0;
+    return true;
+}
 
-    const auto viewPortExtent = currentFrameBuffer.get_image_extent();
+void VulkanRenderer::record_frame_state(VkCommandBuffer commandBuffer) const {
+    const auto viewPortExtent = mSwapchain->get_image_extent();
     const auto viewPortWidth = static_cast<float>(viewPortExtent.width);
     const auto viewPortHeight = static_cast<float>(viewPortExtent.height);
 
@@ -181,66 +344,798 @@ bool VulkanRenderer::begin_frame(f64 /*deltaTime*/) {
     scissor.offset.y = 0;
     scissor.extent = viewPortExtent;
 
-    vkCmdSetViewport(currentCommandBuffer.get_handle(), 0, 1, &viewport);
-    vkCmdSetScissor(currentCommandBuffer.get_handle(), 0, 1, &scissor);
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+void VulkanRenderer::begin_render_pass(RenderPassContents contents) {
+    const auto& commandBuffer = mFrameCommandBuffer->get_handle();
+    const bool secondary = contents == RenderPassContents::RENDER_PASS_CONTENTS_SECONDARY;
+    if (mDynamicRendering != nullptr) {
+        mDynamicRendering->set_render_area_extent(mSwapchain->get_image_extent());
+        mDynamicRendering->begin(commandBuffer, get_attachments(*mSwapchain, mImageIndex),
+                                 secondary ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0);
+    } else {
+        const auto& frameBuffer = mFrameBuffers[mImageIndex];
+        mRenderpass->set_render_area_extent(frameBuffer.get_image_extent());
+        mRenderpass->begin(frameBuffer.get_handle(), commandBuffer,
+                           secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+    }
+    if (!secondary) {
+        record_frame_state(commandBuffer);
+    }
+    mRenderPassContents = contents;
+}
+
+void VulkanRenderer::draw(const DrawCommand& command) {
+    draw_batch(std::span{&command, 1});
+}
 
-    const auto renderExtent = viewPortExtent;
-    mRenderpass->set_render_area_extent(renderExtent);
+void VulkanRenderer::draw_batch(std::span<const DrawCommand> commands) {
+    const f64 recordStartTime = mPlatform->getAbsoluteTime();
+    // Uploads to the drawn buffers wait for this value, with a dedicated transfer queue the frame's submission
+    // is the next graphics submission
+    const u64 frameValue = mGraphicsTimeline->get_pending_value() + 1;
+    mResolvedDraws.clear();
+    for (const auto& command : commands) {
+        const VulkanBuffer* vertexBuffer = get_buffer(command.vertexBuffer);
+        const VulkanBuffer* indexBuffer = get_buffer(command.indexBuffer);
+        if (vertexBuffer == nullptr || (command.indexBuffer.is_valid() && indexBuffer == nullptr)) {
+            MSG_WARN("[Vulkan] Draw with an invalid buffer handle ignored");
+            continue;
+        }
+        mBufferUses[command.vertexBuffer.id - 1].graphicsValue = frameValue;
+        if (indexBuffer != nullptr) {
+            mBufferUses[command.indexBuffer.id - 1].graphicsValue = frameValue;
+        }
+        const VulkanPipeline* pipeline = mPipeline.get();
+        if (command.pipeline.is_valid()) {
+            const VulkanPipeline* requested = mPipelineManager->get(command.pipeline);
+            if (requested != nullptr) {
+                pipeline = requested;
+            } else {
+                ++mStatistics.fallbackDraws;
+            }
+        }
+        ResolvedDraw draw{pipeline->get_handle(), vertexBuffer->get_handle(),
+                          indexBuffer != nullptr ? indexBuffer->get_handle() : VK_NULL_HANDLE,
+                          command.elementCount, command.firstElement, command.instanceCount};
+        if (!resolve_draw_resources(command, *pipeline, draw)) {
+            MSG_WARN("[Vulkan] Draw with resources its pipeline cannot read ignored");
+            continue;
+        }
+        mResolvedDraws.push_back(draw);
+    }
+    if (mResolvedDraws.empty()) {
+        return;
+    }
 
-    mRenderpass->begin(currentFrameBuffer.get_handle(), currentCommandBuffer.get_handle());
+    if (mRenderPassContents == RenderPassContents::RENDER_PASS_CONTENTS_NONE) {
+        const bool parallel = can_record_in_parallel() && mResolvedDraws.size() >= PARALLEL_RECORDING_MIN_DRAWS;
+        begin_render_pass(parallel ? RenderPassContents::RENDER_PASS_CONTENTS_SECONDARY
+                                   : RenderPassContents::RENDER_PASS_CONTENTS_INLINE);
+    }
+    if (mRenderPassContents == RenderPassContents::RENDER_PASS_CONTENTS_INLINE) {
+        record_draws(mFrameCommandBuffer->get_handle(), mResolvedDraws);
+    } else {
+        record_in_parallel();
+    }
+    mStatistics.drawCalls += mResolvedDraws.size();
+    mFrameTimings.recordTime += mPlatform->getAbsoluteTime() - recordStartTime;
+}
 
-    return true;
+bool VulkanRenderer::can_record_in_parallel() const {
+    // A wait suspended on a fiber could resume the frame on another thread, it has to run the jobs nested on
+    // this one. Threads outside the job system, like the render thread, cannot run jobs at all
+    return mJobSystem != nullptr && mJobSystem->get_thread_count() > 1 && !mJobSystem->uses_fibers() &&
+        mJobSystem->is_job_thread();
+}
+
+void VulkanRenderer::record_draws(VkCommandBuffer commandBuffer, std::span<const ResolvedDraw> draws) {
+    const VkDeviceSize vertexOffset = 0;
+    VkPipeline boundPipeline{VK_NULL_HANDLE};
+    VkPipelineLayout boundLayout{VK_NULL_HANDLE};
+    VkDescriptorSet boundSet{VK_NULL_HANDLE};
+    for (const auto& draw : draws) {
+        // Draws are usually grouped by pipeline, binding only on changes keeps the rebinds few
+        if (draw.pipeline != boundPipeline) {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+            boundPipeline = draw.pipeline;
+        }
+        // Bindless draws share one set, only their slot changes from draw to draw
+        if (draw.descriptorSet != VK_NULL_HANDLE && (draw.descriptorSet != boundSet || draw.layout != boundLayout)) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.layout, 0, 1,
+                                    &draw.descriptorSet, 0, nullptr);
+            boundSet = draw.descriptorSet;
+            boundLayout = draw.layout;
+        }
+        if (draw.pushConstantStages != 0) {
+            vkCmdPushConstants(commandBuffer, draw.layout, draw.pushConstantStages, 0, sizeof(draw.bindlessSlot),
+                               &draw.bindlessSlot);
+        }
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &draw.vertexBuffer, &vertexOffset);
+        if (draw.indexBuffer != VK_NULL_HANDLE) {
+            vkCmdBindIndexBuffer(commandBuffer, draw.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(commandBuffer, draw.elementCount, draw.instanceCount, draw.firstElement, 0, 0);
+        } else {
+            vkCmdDraw(commandBuffer, draw.elementCount, draw.instanceCount, draw.firstElement, 0);
+        }
+    }
+}
+
+void VulkanRenderer::record_in_parallel() {
+    // Chunks are executed in submission order, so draw order is kept
+    const size_t drawCount = mResolvedDraws.size();
+    const size_t chunkCount =
+        std::clamp<size_t>(drawCount / MIN_DRAWS_PER_CHUNK, 1, mJobSystem->get_thread_count() * CHUNKS_PER_THREAD);
+    const size_t chunkSize = (drawCount + chunkCount - 1) / chunkCount;
+
+    mRecordingChunks.clear();
+    for (size_t first = 0; first < drawCount; first += chunkSize) {
+        mRecordingChunks.push_back(RecordingChunk{this, first, std::min(chunkSize, drawCount - first)});
+    }
+    std::vector<JobSystem::JobDeclaration> jobs;
+    jobs.reserve(mRecordingChunks.size());
+    for (auto& chunk : mRecordingChunks) {
+        jobs.push_back(JobSystem::JobDeclaration{record_chunk, &chunk});
+    }
+    JobCounter counter;
+    mJobSystem->run(jobs, counter);
+    // The wait runs other queued jobs on this thread, they may call into the renderer. Draws are resolved and the
+    // chunks only read their own state, buffer and pipeline calls in between leave them intact
+    if (mBackendMutex != nullptr) {
+        mBackendMutex->unlock();
+    }
+    mJobSystem->wait(counter);
+    if (mBackendMutex != nullptr) {
+        mBackendMutex->lock();
+    }
+
+    mSecondaryCommandBuffers.clear();
+    for (const auto& chunk : mRecordingChunks) {
+        mSecondaryCommandBuffers.push_back(chunk.commandBuffer);
+    }
+    vkCmdExecuteCommands(mFrameCommandBuffer->get_handle(),
+                         static_cast<uint32_t>(mSecondaryCommandBuffers.size()), mSecondaryCommandBuffers.data());
 }
+
+void VulkanRenderer::record_chunk(void* userData) {
+    auto& chunk = *static_cast<RecordingChunk*>(userData);
+    auto& renderer = *chunk.renderer;
+    // Each thread records into its own pool, pools are not thread safe
+    auto& frame = renderer.mFrames[renderer.mCurrentFrame];
+    auto& pool = *frame.recordingPools[renderer.mJobSystem->get_current_thread_index()];
+    auto& commandBuffer = pool.acquire(false);
+
+    if (renderer.mDynamicRendering != nullptr) {
+        commandBuffer.begin_secondary_rendering(renderer.mSwapchain->get_image_color_format(),
+                                                renderer.mSwapchain->get_image_depth_format());
+    } else {
+        commandBuffer.begin_secondary(renderer.mRenderpass->get_handle(),
+                                      renderer.mFrameBuffers[renderer.mImageIndex].get_handle());
+    }
+    renderer.record_frame_state(commandBuffer.get_handle());
+    record_draws(commandBuffer.get_handle(),
+                 std::span{renderer.mResolvedDraws}.subspan(chunk.firstDraw, chunk.drawCount));
+    commandBuffer.end();
+    chunk.commandBuffer = commandBuffer.get_handle();
+}
+
 bool VulkanRenderer::end_frame(f64 /*deltaTime*/) {
     MSG_TRACE("[Vulkan] end frame called");
-    auto& currentInFlightFence = mInFlightFences[mCurrentFrame];
-    auto& currentImageAvailableSemaphore = mImageAvailableSemaphore[mCurrentFrame];
-    auto& currentRenderFinishedSemaphore = mRenderFinishedSemaphore[mCurrentFrame];
-    auto& currentCommandBuffer = mCommandBuffers[mImageIndex];
+    auto& frame = mFrames[mCurrentFrame];
+    auto& currentRenderFinishedSemaphore = mRenderFinishedSemaphores[mImageIndex];
+    auto& currentCommandBuffer = *mFrameCommandBuffer;
 
-    mRenderpass->end(currentCommandBuffer.get_handle());
+    // A frame without draws still clears its image
+    if (mRenderPassContents == RenderPassContents::RENDER_PASS_CONTENTS_NONE) {
+        begin_render_pass(RenderPassContents::RENDER_PASS_CONTENTS_INLINE);
+    }
+    if (mDynamicRendering != nullptr) {
+        mDynamicRendering->end(currentCommandBuffer.get_handle(), get_attachments(*mSwapchain, mImageIndex));
+    } else {
+        mRenderpass->end(currentCommandBuffer.get_handle());
+    }
     currentCommandBuffer.end();
 
+    // The binary semaphores' values are ignored, they are only used for presentation
+    const u64 submitValue = mGraphicsTimeline->advance();
+    const std::array<VkSemaphore, 2> signalSemaphores{mGraphicsTimeline->get_handle(), currentRenderFinishedSemaphore};
+    const std::array<u64, 2> signalValues{submitValue, 0};
+    std::array<VkSemaphore, 3> waitSemaphores{};
+    std::array<u64, 3> waitValues{};
+    std::array<VkPipelineStageFlags, 3> waitStages{};
+    uint32_t waitCount = 0;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
     VkSubmitInfo submit_info{};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.pNext = &timelineInfo;
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &currentCommandBuffer.get_handle();
     submit_info.signalSemaphoreCount = 1;
-    submit_info.pSignalSemaphores = &currentRenderFinishedSemaphore;
-    submit_info.waitSemaphoreCount = 1;
-    submit_info.pWaitSemaphores = &currentImageAvailableSemaphore;
-
-    VkPipelineStageFlags waitStages[1] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submit_info.pWaitDstStageMask = waitStages;
+    submit_info.pSignalSemaphores = signalSemaphores.data();
+
+    // Offscreen images are neither acquired nor presented, the timeline is the only synchronization needed
+    if (!mSwapchain->is_offscreen()) {
+        timelineInfo.signalSemaphoreValueCount = 2;
+        submit_info.signalSemaphoreCount = 2;
+        waitSemaphores[waitCount] = frame.imageAvailableSemaphore;
+        waitStages[waitCount++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    }
+    // Every upload submitted so far, including this frame's, is done before vertex input reads it.
+    // Frames on the graphics queue are not ordered against each other, so each frame waits for itself. Without a
+    // dedicated compute queue the frame's dispatches read the uploads too
+    if (mTransferTimeline != nullptr && mTransferTimeline->get_pending_value() > 0) {
+        waitSemaphores[waitCount] = mTransferTimeline->get_handle();
+        waitValues[waitCount] = mTransferTimeline->get_pending_value();
+        waitStages[waitCount++] =
+            mComputeTimeline == nullptr ? DRAW_READ_STAGES | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : DRAW_READ_STAGES;
+    }
+    // Likewise every dispatch, this frame's included
+    if (mComputeTimeline != nullptr && mComputeTimeline->get_pending_value() > 0) {
+        waitSemaphores[waitCount] = mComputeTimeline->get_handle();
+        waitValues[waitCount] = mComputeTimeline->get_pending_value();
+        waitStages[waitCount++] = DRAW_READ_STAGES;
+    }
+    timelineInfo.waitSemaphoreValueCount = waitCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    submit_info.waitSemaphoreCount = waitCount;
+    submit_info.pWaitSemaphores = waitSemaphores.data();
+    submit_info.pWaitDstStageMask = waitStages.data();
 
-    VkResult result = vkQueueSubmit(mDevice->get_graphics_queue(), 1, &submit_info, currentInFlightFence.get_handle());
+    VkResult result = vkQueueSubmit(mDevice->get_graphics_queue(), 1, &submit_info, VK_NULL_HANDLE);
     if (result != VK_SUCCESS) {
         MSG_ERROR("[Vulkan] vkQueueSubmit failed with result");
         return false;
     }
     currentCommandBuffer.update_submitted();
+    frame.submitValue = submitValue;
+    mImageSubmitValues[mImageIndex] = submitValue;
+    // Uploads staged during the frame are not in its command buffer, their space is kept until they are copied
+    if (mFrameStagingHead != 0) {
+        mStagingRing->retire(mFrameStagingHead, submitValue);
+    }
 
+    const f64 presentStartTime = mPlatform->getAbsoluteTime();
     VkResult resultImageAcquire =
         mSwapchain->present(mDevice->get_present_queue(), mImageIndex, currentRenderFinishedSemaphore);
+    mFrameTimings.presentedTime = mPlatform->getAbsoluteTime();
+    mFrameTimings.presentTime = mFrameTimings.presentedTime - presentStartTime;
     if (resultImageAcquire == VK_ERROR_OUT_OF_DATE_KHR || resultImageAcquire == VK_SUBOPTIMAL_KHR) {
         recreate_swapchain_resources();
     } else if (resultImageAcquire != VK_SUCCESS) {
         throw std::runtime_error("failed to present swap chain image!");
     }
 
-    mCurrentFrame = (mCurrentFrame + 1) % mSwapchain->get_max_frames_inflight();
+    mCurrentFrame = (mCurrentFrame + 1) % mFramesInFlight;
+    ++mStatistics.frameCount;
+    const auto memoryStatistics = mDevice->get_allocator().get_statistics();
+    mStatistics.gpuBytesReserved = memoryStatistics.bytesReserved;
+    mStatistics.gpuBytesUsed = memoryStatistics.bytesUsed;
+    return true;
+}
+
+BufferHandle VulkanRenderer::create_buffer(BufferUsage usage, u64 size) {
+    if (size == 0) {
+        MSG_ERROR("[Vulkan] Cannot create an empty buffer");
+        return {};
+    }
+    VkBufferUsageFlags usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    // Every queue writes or reads buffers, often from different families. Sharing them concurrently avoids an
+    // ownership transfer for each upload, which partial uploads to a buffer in use would otherwise need both ways
+    const auto& families = mDevice->get_queue_families();
+    std::vector<uint32_t> queueFamilies{families.graphicsFamily.value(), families.computeFamily.value(),
+                                        families.transferFamily.value()};
+    std::ranges::sort(queueFamilies);
+    queueFamilies.erase(std::ranges::unique(queueFamilies).begin(), queueFamilies.end());
+    switch (usage) {
+        case BufferUsage::BUFFER_USAGE_VERTEX:
+            usageFlags |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+            break;
+        case BufferUsage::BUFFER_USAGE_INDEX:
+            usageFlags |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+            break;
+        case BufferUsage::BUFFER_USAGE_UNIFORM:
+            usageFlags |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+            break;
+        case BufferUsage::BUFFER_USAGE_STORAGE:
+            usageFlags |=
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+            break;
+    }
+
+    auto freeSlot = std::ranges::find_if(mBuffers, [](const auto& slot) { return slot == nullptr; });
+    if (freeSlot == mBuffers.end()) {
+        freeSlot = mBuffers.insert(mBuffers.end(), nullptr);
+    }
+    *freeSlot = std::make_unique<VulkanBuffer>(*mDevice, size, usageFlags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                               queueFamilies);
+    const auto slotIndex = static_cast<size_t>(freeSlot - mBuffers.begin());
+    mBufferUses.resize(mBuffers.size());
+    mBufferUses[slotIndex] = BufferUse{};
+    mBindlessSlots.resize(mBuffers.size(), VulkanBindlessSet::INVALID_SLOT);
+    mBindlessSlots[slotIndex] = VulkanBindlessSet::INVALID_SLOT;
+    if (usage == BufferUsage::BUFFER_USAGE_STORAGE && mBindlessSet != nullptr) {
+        mBindlessSlots[slotIndex] = mBindlessSet->add_buffer((*freeSlot)->get_handle());
+        if (mBindlessSlots[slotIndex] == VulkanBindlessSet::INVALID_SLOT) {
+            MSG_WARN("[Vulkan] Bindless set full, buffer {} can only be drawn with descriptor sets", slotIndex + 1);
+        }
+    }
+    return BufferHandle{static_cast<u32>(slotIndex) + 1};
+}
+
+bool VulkanRenderer::upload_buffer(BufferHandle buffer, const void* data, u64 size, u64 offset) {
+    VulkanBuffer* destination = get_buffer(buffer);
+    // Written so that offset + size cannot wrap around
+    if (destination == nullptr || data == nullptr || size > destination->get_size() ||
+        offset > destination->get_size() - size) {
+        MSG_ERROR("[Vulkan] Invalid upload of {} bytes at offset {} to buffer {}", size, offset, buffer.id);
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+
+    // The copies run with the next submission, after the reads of the frames in flight on the same queue.
+    // On a dedicated transfer queue they wait for the last frame drawing the buffer and its last dispatch instead
+    auto& use = mBufferUses[buffer.id - 1];
+    if (mTransferTimeline != nullptr) {
+        mUploadWaitValue = std::max(mUploadWaitValue, use.graphicsValue);
+        mUploadComputeWaitValue = std::max(mUploadComputeWaitValue, use.computeValue);
+    } else {
+        // Dispatches on a dedicated compute queue reading the buffer wait for the submission carrying the copies
+        use.graphicsValue = std::max(use.graphicsValue, mGraphicsTimeline->get_pending_value() + 1);
+    }
+    const auto* bytes = static_cast<const u8*>(data);
+    auto& uploadTimeline = get_upload_timeline();
+    mStagingRing->reclaim(uploadTimeline);
+    for (u64 staged = 0; staged < size;) {
+        const u64 pieceSize = std::min(size - staged, mStagingRing->get_max_upload_size());
+        while (!mStagingRing->stage(*destination, offset + staged, bytes + staged, pieceSize)) {
+            // The ring is taken by copies in flight or by copies not submitted yet
+            if (mStagingRing->wait_for_space(uploadTimeline, UINT64_MAX)) {
+                ++mStatistics.uploadStalls;
+            } else if (!flush_uploads()) {
+                MSG_ERROR("[Vulkan] No staging space for an upload of {} bytes to buffer {}", pieceSize, buffer.id);
+                return false;
+            }
+        }
+        staged += pieceSize;
+    }
+
+    mStatistics.bytesUploaded += size;
     return true;
 }
 
+void VulkanRenderer::destroy_buffer(BufferHandle buffer) {
+    if (get_buffer(buffer) == nullptr) {
+        return;
+    }
+    // Frames in flight and the next submission may still read the buffer, its handle is free for reuse right away.
+    // Copies into it staged before are submitted with the next transfer submission at the latest, dispatches
+    // are submitted right away
+    DeferredResource deferred{};
+    deferred.buffer = std::move(mBuffers[buffer.id - 1]);
+    deferred.bindlessSlot = std::exchange(mBindlessSlots[buffer.id - 1], VulkanBindlessSet::INVALID_SLOT);
+    deferred.retireValue = mGraphicsTimeline->get_pending_value() + 1;
+    if (mTransferTimeline != nullptr) {
+        deferred.transferRetireValue =
+            mTransferTimeline->get_pending_value() + (mStagingRing->has_pending_copies() ? 1 : 0);
+    }
+    if (mComputeTimeline != nullptr) {
+        deferred.computeRetireValue = mComputeTimeline->get_pending_value();
+    }
+    mDeferredResources.push_back(std::move(deferred));
+}
+
+ComputePipelineHandle VulkanRenderer::create_compute_pipeline(const std::string& shaderPath, u32 bufferCount,
+                                                              u32 pushConstantSize) {
+    if (bufferCount > DispatchCommand::MAX_BUFFERS || pushConstantSize > DispatchCommand::MAX_PUSH_CONSTANT_SIZE ||
+        pushConstantSize % 4 != 0) {
+        MSG_ERROR("[Vulkan] Compute pipeline with {} buffers and {} bytes of push constants exceeds the limits",
+                  bufferCount, pushConstantSize);
+        return {};
+    }
+    std::filesystem::path path{shaderPath};
+    if (path.is_relative()) {
+        path = std::filesystem::path{ENGINE_SHADER_DIR} / path;
+    }
+    if (!std::filesystem::is_regular_file(path)) {
+        MSG_ERROR("[Vulkan] Compute shader not found: {}", path.string());
+        return {};
+    }
+
+    auto freeSlot = std::ranges::find_if(mComputePipelines, [](const auto& slot) { return slot == nullptr; });
+    if (freeSlot == mComputePipelines.end()) {
+        freeSlot = mComputePipelines.insert(mComputePipelines.end(), nullptr);
+    }
+    try {
+        *freeSlot = std::make_unique<VulkanComputePipeline>(mDevice->get_logical_device(),
+                                                            mPipelineCache->get_handle(), *mLayoutCache,
+                                                            path.string(), bufferCount, pushConstantSize);
+    } catch (const std::exception& exception) {
+        MSG_ERROR("[Vulkan] Compute pipeline for {} failed to compile: {}", path.string(), exception.what());
+        return {};
+    }
+    return ComputePipelineHandle{static_cast<u32>(freeSlot - mComputePipelines.begin()) + 1};
+}
+
+void VulkanRenderer::destroy_compute_pipeline(ComputePipelineHandle pipeline) {
+    if (get_compute_pipeline(pipeline) == nullptr) {
+        return;
+    }
+    // Without a dedicated compute queue the dispatches are part of the frame being recorded
+    DeferredResource deferred{};
+    deferred.computePipeline = std::move(mComputePipelines[pipeline.id - 1]);
+    deferred.retireValue = mGraphicsTimeline->get_pending_value() + 1;
+    if (mComputeTimeline != nullptr) {
+        deferred.computeRetireValue = mComputeTimeline->get_pending_value();
+    }
+    mDeferredResources.push_back(std::move(deferred));
+}
+
+PipelineHandle VulkanRenderer::create_pipeline(const PipelineDescription& description) {
+    return mPipelineManager->request(description);
+}
+
+bool VulkanRenderer::is_pipeline_ready(PipelineHandle pipeline) const {
+    return mPipelineManager->get(pipeline) != nullptr;
+}
+
+bool VulkanRenderer::supports_bindless() const {
+    return mBindlessSet != nullptr;
+}
+
+bool VulkanRenderer::uses_transfer_queue() const {
+    return mTransferTimeline != nullptr;
+}
+
+void VulkanRenderer::dispatch_batch(std::span<const DispatchCommand> commands) {
+    if (mRenderPassContents != RenderPassContents::RENDER_PASS_CONTENTS_NONE) {
+        MSG_WARN("[Vulkan] {} dispatches after the frame's first draw ignored", commands.size());
+        return;
+    }
+    auto& frame = mFrames[mCurrentFrame];
+    const bool dedicatedQueue = mComputeTimeline != nullptr;
+    VulkanCommandBuffer* commandBuffer = mFrameCommandBuffer;
+    if (dedicatedQueue) {
+        commandBuffer = &frame.computePool->acquire(true);
+        commandBuffer->begin_single_use();
+    }
+    const VkCommandBuffer handle = commandBuffer->get_handle();
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    if (!dedicatedQueue) {
+        // On the graphics queue the frame's uploads and the draws of earlier frames finish first
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(handle, VK_PIPELINE_STAGE_TRANSFER_BIT | DRAW_READ_STAGES,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    u64 graphicsWaitValue = 0;
+    u32 dispatchCount = 0;
+    const u64 computeValue = dedicatedQueue ? mComputeTimeline->get_pending_value() + 1 : 0;
+    const u64 frameValue = mGraphicsTimeline->get_pending_value() + 1;
+    for (const auto& command : commands) {
+        const VulkanComputePipeline* pipeline = get_compute_pipeline(command.pipeline);
+        const VkDescriptorSet descriptorSet =
+            pipeline != nullptr ? prepare_dispatch(command, *pipeline) : VK_NULL_HANDLE;
+        if (descriptorSet == VK_NULL_HANDLE) {
+            MSG_WARN("[Vulkan] Dispatch with an invalid pipeline or buffer ignored");
+            continue;
+        }
+        // Dispatches of a batch usually feed each other, like culling followed by compaction
+        if (dispatchCount > 0) {
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(handle, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+        pipeline->bind(handle);
+        vkCmdBindDescriptorSets(handle, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->get_layout(), 0, 1, &descriptorSet,
+                                0, nullptr);
+        if (command.pushConstantSize > 0) {
+            vkCmdPushConstants(handle, pipeline->get_layout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, command.pushConstantSize,
+                               command.pushConstants.data());
+        }
+        vkCmdDispatch(handle, command.groupCountX, command.groupCountY, command.groupCountZ);
+
+        for (const auto& buffer : std::span{command.buffers}.first(command.bufferCount)) {
+            auto& use = mBufferUses[buffer.id - 1];
+            graphicsWaitValue = std::max(graphicsWaitValue, use.graphicsValue);
+            use.computeValue = computeValue;
+            // Dispatches on the graphics queue are part of the frame, uploads overwriting the buffer wait for it
+            if (!dedicatedQueue) {
+                use.graphicsValue = frameValue;
+            }
+        }
+        ++dispatchCount;
+    }
+    mStatistics.dispatches += dispatchCount;
+
+    if (!dedicatedQueue) {
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = DRAW_READ_ACCESS;
+        vkCmdPipelineBarrier(handle, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, DRAW_READ_STAGES, 0, 1, &barrier, 0,
+                             nullptr, 0, nullptr);
+        return;
+    }
+    commandBuffer->end();
+    if (dispatchCount > 0) {
+        submit_dispatches(*commandBuffer, graphicsWaitValue);
+    }
+}
+
+VkDescriptorSet VulkanRenderer::prepare_dispatch(const DispatchCommand& command,
+                                                 const VulkanComputePipeline& pipeline) {
+    if (command.bufferCount != pipeline.get_buffer_count() ||
+        command.pushConstantSize > pipeline.get_push_constant_size()) {
+        return VK_NULL_HANDLE;
+    }
+    std::array<VulkanDescriptorSetCache::BufferBinding, DispatchCommand::MAX_BUFFERS> bindings{};
+    for (u32 binding = 0; binding < command.bufferCount; ++binding) {
+        const VulkanBuffer* buffer = get_buffer(command.buffers[binding]);
+        if (buffer == nullptr) {
+            return VK_NULL_HANDLE;
+        }
+        bindings[binding].binding = binding;
+        bindings[binding].buffer = buffer->get_handle();
+    }
+
+    // Dispatches keep binding the same buffers frame after frame, their sets are written once
+    const std::span<const VulkanDescriptorSetCache::BufferBinding> used{bindings.data(), command.bufferCount};
+    VkDescriptorSet descriptorSet = mDescriptorSetCache->get(pipeline.get_set_layout(), used);
+    if (descriptorSet == VK_NULL_HANDLE) {
+        descriptorSet = mFrames[mCurrentFrame].descriptorAllocator->allocate(pipeline.get_set_layout());
+        if (descriptorSet != VK_NULL_HANDLE) {
+            VulkanDescriptorSetCache::write(mDevice->get_logical_device(), descriptorSet, used);
+        }
+    }
+    return descriptorSet;
+}
+
+bool VulkanRenderer::resolve_draw_resources(const DrawCommand& command, const VulkanPipeline& pipeline,
+                                            ResolvedDraw& draw) {
+    if (pipeline.get_draw_resources() == VulkanPipeline::DrawResources::DRAW_RESOURCES_NONE) {
+        return true;
+    }
+    const VulkanBuffer* buffer = get_buffer(command.resources);
+    if (buffer == nullptr) {
+        return false;
+    }
+    draw.layout = pipeline.get_layout();
+    if (pipeline.get_draw_resources() == VulkanPipeline::DrawResources::DRAW_RESOURCES_BINDLESS) {
+        draw.bindlessSlot = mBindlessSlots[command.resources.id - 1];
+        if (draw.bindlessSlot == VulkanBindlessSet::INVALID_SLOT) {
+            return false;
+        }
+        draw.descriptorSet = mBindlessSet->get_handle();
+        draw.pushConstantStages = pipeline.get_push_constant_stages();
+    } else {
+        // Like dispatches, draws keep binding the same buffers frame after frame
+        const VulkanDescriptorSetCache::BufferBinding binding{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                              buffer->get_handle()};
+        const VkDescriptorSetLayout setLayout = pipeline.get_set_layouts().front();
+        draw.descriptorSet = mDescriptorSetCache->get(setLayout, std::span{&binding, 1});
+        if (draw.descriptorSet == VK_NULL_HANDLE) {
+            draw.descriptorSet = mFrames[mCurrentFrame].descriptorAllocator->allocate(setLayout);
+            if (draw.descriptorSet == VK_NULL_HANDLE) {
+                return false;
+            }
+            VulkanDescriptorSetCache::write(mDevice->get_logical_device(), draw.descriptorSet, std::span{&binding, 1});
+        }
+    }
+    mBufferUses[command.resources.id - 1].graphicsValue = mGraphicsTimeline->get_pending_value() + 1;
+    return true;
+}
+
+bool VulkanRenderer::submit_dispatches(VulkanCommandBuffer& commandBuffer, u64 graphicsWaitValue) {
+    // Frames still drawing a written buffer and uploads into the buffers finish before the dispatches start.
+    // Graphics values of buffers drawn by the frame being recorded cannot be waited on, its draws come after
+    std::array<VkSemaphore, 2> waitSemaphores{};
+    std::array<u64, 2> waitValues{};
+    const std::array<VkPipelineStageFlags, 2> waitStages{VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT};
+    uint32_t waitCount = 0;
+    if (graphicsWaitValue > 0) {
+        waitSemaphores[waitCount] = mGraphicsTimeline->get_handle();
+        waitValues[waitCount++] = std::min(graphicsWaitValue, mGraphicsTimeline->get_pending_value());
+    }
+    if (mTransferTimeline != nullptr && mTransferTimeline->get_pending_value() > 0) {
+        waitSemaphores[waitCount] = mTransferTimeline->get_handle();
+        waitValues[waitCount++] = mTransferTimeline->get_pending_value();
+    }
+
+    const u64 submitValue = mComputeTimeline->advance();
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = waitCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &submitValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer.get_handle();
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &mComputeTimeline->get_handle();
+    if (vkQueueSubmit(mDevice->get_compute_queue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        MSG_ERROR("[Vulkan] vkQueueSubmit of dispatches to the compute queue failed");
+        return false;
+    }
+    commandBuffer.update_submitted();
+    mFrames[mCurrentFrame].computeSubmitValue = submitValue;
+    return true;
+}
+
+bool VulkanRenderer::flush_uploads() {
+    if (!mStagingRing->has_pending_copies()) {
+        return false;
+    }
+    if (mTransferTimeline != nullptr) {
+        // Space is only waited for on the CPU, a transfer waiting on the frame still being recorded never finishes
+        if (mUploadWaitValue > mGraphicsTimeline->get_pending_value()) {
+            MSG_WARN("[Vulkan] Staged uploads overwrite buffers drawn this frame, they wait for the next frame");
+            return false;
+        }
+        return submit_transfers();
+    }
+    // The current frame's pool is only reset by its next begin_frame, which waits for this submission as well
+    auto& frame = mFrames[mCurrentFrame];
+    auto& commandBuffer = frame.commandPool->acquire(true);
+    commandBuffer.begin_single_use();
+    const u64 stagingHead = mStagingRing->record_copies(commandBuffer.get_handle());
+    commandBuffer.end();
+
+    // Dispatches on a dedicated compute queue may still read the destinations
+    const u64 computeWaitValue = mComputeTimeline != nullptr ? mComputeTimeline->get_pending_value() : 0;
+    const VkPipelineStageFlags computeWaitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    const uint32_t waitCount = computeWaitValue > 0 ? 1 : 0;
+
+    const u64 submitValue = mGraphicsTimeline->advance();
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = waitCount;
+    timelineInfo.pWaitSemaphoreValues = &computeWaitValue;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &submitValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.pWaitSemaphores = waitCount > 0 ? &mComputeTimeline->get_handle() : nullptr;
+    submitInfo.pWaitDstStageMask = &computeWaitStage;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer.get_handle();
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &mGraphicsTimeline->get_handle();
+    if (vkQueueSubmit(mDevice->get_graphics_queue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        MSG_ERROR("[Vulkan] vkQueueSubmit of staged uploads failed");
+        return false;
+    }
+    commandBuffer.update_submitted();
+    frame.submitValue = submitValue;
+    mStagingRing->retire(stagingHead, submitValue);
+    return true;
+}
+
+bool VulkanRenderer::submit_transfers() {
+    if (!mStagingRing->has_pending_copies()) {
+        return false;
+    }
+    // Reset by the current frame's next begin_frame, which waits for the transfer timeline to pass this submission
+    auto& frame = mFrames[mCurrentFrame];
+    auto& commandBuffer = frame.transferPool->acquire(true);
+    commandBuffer.begin_single_use();
+    const u64 stagingHead = mStagingRing->record_copies_for_queue(commandBuffer.get_handle());
+    commandBuffer.end();
+
+    // Frames and dispatches still reading a destination finish before the copies overwrite it, new buffers need
+    // no wait at all
+    std::array<VkSemaphore, 2> waitSemaphores{};
+    std::array<u64, 2> waitValues{};
+    const std::array<VkPipelineStageFlags, 2> waitStages{VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                         VK_PIPELINE_STAGE_TRANSFER_BIT};
+    uint32_t waitCount = 0;
+    if (mUploadWaitValue > 0) {
+        waitSemaphores[waitCount] = mGraphicsTimeline->get_handle();
+        waitValues[waitCount++] = mUploadWaitValue;
+    }
+    if (mUploadComputeWaitValue > 0) {
+        waitSemaphores[waitCount] = mComputeTimeline->get_handle();
+        waitValues[waitCount++] = mUploadComputeWaitValue;
+    }
+
+    const u64 submitValue = mTransferTimeline->advance();
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = waitCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &submitValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer.get_handle();
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &mTransferTimeline->get_handle();
+    if (vkQueueSubmit(mDevice->get_transfer_queue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        MSG_ERROR("[Vulkan] vkQueueSubmit of staged uploads to the transfer queue failed");
+        return false;
+    }
+    commandBuffer.update_submitted();
+    frame.transferSubmitValue = submitValue;
+    mStagingRing->retire(stagingHead, submitValue);
+    mUploadWaitValue = 0;
+    mUploadComputeWaitValue = 0;
+    return true;
+}
+
+VulkanTimelineSemaphore& VulkanRenderer::get_upload_timeline() const {
+    return mTransferTimeline != nullptr ? *mTransferTimeline : *mGraphicsTimeline;
+}
+
+void VulkanRenderer::collect_deferred_deletions() {
+    const auto isRetired = [this](const DeferredResource& deferred) {
+        return mGraphicsTimeline->is_complete(deferred.retireValue) &&
+            (mTransferTimeline == nullptr || mTransferTimeline->is_complete(deferred.transferRetireValue)) &&
+            (mComputeTimeline == nullptr || mComputeTimeline->is_complete(deferred.computeRetireValue));
+    };
+    while (!mDeferredResources.empty() && isRetired(mDeferredResources.front())) {
+        const auto& deferred = mDeferredResources.front();
+        if (deferred.buffer != nullptr) {
+            mDescriptorSetCache->evict(deferred.buffer->get_handle());
+        }
+        if (deferred.bindlessSlot != VulkanBindlessSet::INVALID_SLOT) {
+            mBindlessSet->remove_buffer(deferred.bindlessSlot);
+        }
+        mDeferredResources.pop_front();
+    }
+}
+
+VulkanBuffer* VulkanRenderer::get_buffer(BufferHandle buffer) const {
+    if (!buffer.is_valid() || buffer.id > mBuffers.size()) {
+        return nullptr;
+    }
+    return mBuffers[buffer.id - 1].get();
+}
+
+VulkanComputePipeline* VulkanRenderer::get_compute_pipeline(ComputePipelineHandle pipeline) const {
+    if (!pipeline.is_valid() || pipeline.id > mComputePipelines.size()) {
+        return nullptr;
+    }
+    return mComputePipelines[pipeline.id - 1].get();
+}
+
 std::vector<const char*> VulkanRenderer::get_required_extensions() {
     std::vector<const char*> extensions{};
 
-    extensions.emplace_back(VK_KHR_SURFACE_EXTENSION_NAME);  // Generic surface
+    if (!mHeadless) {
+        extensions.emplace_back(VK_KHR_SURFACE_EXTENSION_NAME);  // Generic surface
 
-    std::vector<const char*> requiredPlatformExtensions = vulkanplatform::get_platform_extensions();
+        std::vector<const char*> requiredPlatformExtensions = vulkanplatform::get_platform_extensions();
 
-    for (const auto& extension : requiredPlatformExtensions) {
-        extensions.emplace_back(extension);
+        for (const auto& extension : requiredPlatformExtensions) {
+            extensions.emplace_back(extension);
+        }
     }
 
     if (mEnableValidationLayers) {
@@ -304,22 +1199,11 @@ void VulkanRenderer::setup_debug_messenger() {
     MSG_DEBUG("[Vulkan] Debug messenger created");
 }
 
-void VulkanRenderer::create_command_buffers() {
-    size_t swapChainImageCount = mSwapchain->get_image_count();
-    mCommandBuffers.reserve(swapChainImageCount);
-
-    for (size_t i = 0; i < swapChainImageCount; ++i) {
-        mCommandBuffers.emplace_back(mDevice->get_logical_device(), mDevice->get_graphics_commandpool(), true);
-    }
-    MSG_INFO("[Vulkan] All command buffers successfully created by: {:p}", static_cast<void*>(this));
-}
-
-void VulkanRenderer::destroy_command_buffers() {
-    mCommandBuffers.clear();
-    MSG_INFO("[Vulkan] All command buffers successfully destroyed by: {:p}", static_cast<void*>(this));
-}
-
 void VulkanRenderer::create_framebuffers() {
+    // Dynamic rendering instances reference the image views directly, nothing to recreate with the swapchain
+    if (mDynamicRendering != nullptr) {
+        return;
+    }
     MSG_INFO("[Vulkan] Create framebuffers called by: {:p}", static_cast<void*>(this));
     size_t swapChainImageCount = mSwapchain->get_image_count();
     mFrameBuffers.reserve(swapChainImageCount);
@@ -339,33 +1223,64 @@ void VulkanRenderer::destroy_framebuffers() {
     MSG_INFO("[Vulkan] All framebuffers successfully destroyed by: {:p}", static_cast<void*>(this));
 }
 
-void VulkanRenderer::create_sync_objects() {
-    const auto maxFramesInFlight = mSwapchain->get_max_frames_inflight();
+void VulkanRenderer::create_frame_resources() {
     const auto logicalDevice = mDevice->get_logical_device();
-    mImageAvailableSemaphore.resize(maxFramesInFlight);
-    mRenderFinishedSemaphore.resize(maxFramesInFlight);
-
-    mInFlightFences.reserve(maxFramesInFlight);
+    const auto graphicsFamily = mDevice->get_queue_families().graphicsFamily.value();
+    const u32 threadCount = mJobSystem != nullptr ? mJobSystem->get_thread_count() : 0;
 
     VkSemaphoreCreateInfo semaphoreCreateInfo{};
     semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    for (size_t i = 0; i < maxFramesInFlight; ++i) {
+    mFrames.resize(mFramesInFlight);
+    for (auto& frame : mFrames) {
+        frame.commandPool = std::make_unique<VulkanCommandPool>(logicalDevice, graphicsFamily);
+        for (u32 thread = 0; thread < threadCount; ++thread) {
+            frame.recordingPools.push_back(std::make_unique<VulkanCommandPool>(logicalDevice, graphicsFamily));
+        }
+        if (mTransferTimeline != nullptr) {
+            frame.transferPool = std::make_unique<VulkanCommandPool>(
+                logicalDevice, mDevice->get_queue_families().transferFamily.value());
+        }
+        if (mDevice->has_dedicated_compute_queue()) {
+            frame.computePool = std::make_unique<VulkanCommandPool>(
+                logicalDevice, mDevice->get_queue_families().computeFamily.value());
+        }
+        frame.descriptorAllocator =
+            std::make_unique<VulkanDescriptorAllocator>(logicalDevice, FRAME_DESCRIPTOR_SETS_PER_POOL, false);
         // TODO: Extract semaphores into class
-        VK_CHECK(vkCreateSemaphore(logicalDevice, &semaphoreCreateInfo, nullptr, &mImageAvailableSemaphore[i]));
-        VK_CHECK(vkCreateSemaphore(logicalDevice, &semaphoreCreateInfo, nullptr, &mRenderFinishedSemaphore[i]));
+        VK_CHECK(vkCreateSemaphore(logicalDevice, &semaphoreCreateInfo, nullptr, &frame.imageAvailableSemaphore));
+    }
+    mCurrentFrame = 0;
+    MSG_INFO("[Vulkan] Resources for {} frames in flight created, recording on {} threads", mFramesInFlight,
+             threadCount);
+}
+
+void VulkanRenderer::destroy_frame_resources() {
+    mFrameCommandBuffer = nullptr;
+    for (auto& frame : mFrames) {
+        vkDestroySemaphore(mDevice->get_logical_device(), frame.imageAvailableSemaphore, nullptr);
+    }
+    mFrames.clear();
+}
+
+void VulkanRenderer::create_image_sync_objects() {
+    const auto imageCount = mSwapchain->get_image_count();
+    VkSemaphoreCreateInfo semaphoreCreateInfo{};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        mInFlightFences.emplace_back(logicalDevice, true);
+    mRenderFinishedSemaphores.resize(imageCount);
+    for (auto& semaphore : mRenderFinishedSemaphores) {
+        VK_CHECK(vkCreateSemaphore(mDevice->get_logical_device(), &semaphoreCreateInfo, nullptr, &semaphore));
     }
+    mImageSubmitValues.assign(imageCount, 0);
 }
 
-void VulkanRenderer::destroy_sync_objects() {
-    const auto& maxFramesInFlight = mSwapchain->get_max_frames_inflight();
-    for (size_t i = 0; i < maxFramesInFlight; ++i) {
-        vkDestroySemaphore(mDevice->get_logical_device(), mImageAvailableSemaphore[i], nullptr);
-        vkDestroySemaphore(mDevice->get_logical_device(), mRenderFinishedSemaphore[i], nullptr);
+void VulkanRenderer::destroy_image_sync_objects() {
+    for (auto& semaphore : mRenderFinishedSemaphores) {
+        vkDestroySemaphore(mDevice->get_logical_device(), semaphore, nullptr);
     }
-    mInFlightFences.clear();
+    mRenderFinishedSemaphores.clear();
+    mImageSubmitValues.clear();
 }
 
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanRenderer::debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
@@ -3,7 +3,10 @@
 #include "defines.hpp"
 #include "renderer/renderer_backend.hpp"
 
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan.h>
@@ -11,9 +14,22 @@
 class VulkanDevice;
 class VulkanSwapchain;
 class RenderPass;
+class VulkanDynamicRendering;
 class VulkanCommandBuffer;
 class VulkanFramebuffer;
-class VulkanFence;
+class VulkanTimelineSemaphore;
+class VulkanBuffer;
+class VulkanPipeline;
+class VulkanCommandPool;
+class VulkanStagingRing;
+class VulkanComputePipeline;
+class VulkanPipelineCache;
+class VulkanLayoutCache;
+class VulkanDescriptorAllocator;
+class VulkanDescriptorSetCache;
+class VulkanBindlessSet;
+class VulkanPipelineManager;
+class JobSystem;
 
 class VulkanRenderer : public RendererBackend {
 public:
@@ -21,32 +37,180 @@ public:
     VulkanRenderer(VulkanRenderer&&) = delete;
     VulkanRenderer& operator=(const VulkanRenderer&) = delete;
     VulkanRenderer& operator=(VulkanRenderer&&) = delete;
-    VulkanRenderer(std::string applicationName, Platform* platform, uint32_t width, uint32_t height);
+    static constexpr uint32_t MIN_FRAMES_IN_FLIGHT = 1;
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
+    // Headless renderers create no surface and render into offscreen images.
+    // More frames in flight let the CPU run further ahead of the GPU, at the cost of latency.
+    // With a job system large batches drawn from a job system thread are recorded in parallel. The backend mutex,
+    // when given, is held by the caller around every call and released while recording waits on its jobs.
+    // Pipelines compiled by the driver are loaded from and saved to the pipeline cache file, unless the path is empty.
+    // Without transferQueue uploads are copied on the graphics queue even when the device has a transfer queue
+    VulkanRenderer(std::string applicationName, Platform* platform, uint32_t width, uint32_t height, bool headless,
+                   uint32_t framesInFlight, JobSystem* jobSystem = nullptr, std::mutex* backendMutex = nullptr,
+                   std::string pipelineCachePath = {}, bool transferQueue = true);
     ~VulkanRenderer() override;
 
     void resized(uint32_t width, uint32_t height) override;
 
     bool begin_frame(f64 deltaTime) override;
+    void draw(const DrawCommand& command) override;
+    void draw_batch(std::span<const DrawCommand> commands) override;
+    // With a dedicated compute queue the batch is submitted right away and overlaps the rasterization of the
+    // frames before, dispatches writing buffers those frames still draw wait for them
+    void dispatch_batch(std::span<const DispatchCommand> commands) override;
     bool end_frame(f64 deltaTime) override;
 
+    BufferHandle create_buffer(BufferUsage usage, u64 size) override;
+    bool upload_buffer(BufferHandle buffer, const void* data, u64 size, u64 offset) override;
+    void destroy_buffer(BufferHandle buffer) override;
+
+    ComputePipelineHandle create_compute_pipeline(const std::string& shaderPath, u32 bufferCount,
+                                                  u32 pushConstantSize) override;
+    void destroy_compute_pipeline(ComputePipelineHandle pipeline) override;
+
+    // Compiles on the pipeline manager's threads, draws use the builtin pipeline until it is ready
+    PipelineHandle create_pipeline(const PipelineDescription& description) override;
+    [[nodiscard]] bool is_pipeline_ready(PipelineHandle pipeline) const override;
+    // Storage buffers are registered in the bindless set when the device supports descriptor indexing
+    [[nodiscard]] bool supports_bindless() const override;
+    [[nodiscard]] bool uses_transfer_queue() const override;
+
 private:
+    // A render pass instance either records draws inline or only executes secondary command buffers
+    enum class RenderPassContents {
+        RENDER_PASS_CONTENTS_NONE,
+        RENDER_PASS_CONTENTS_INLINE,
+        RENDER_PASS_CONTENTS_SECONDARY
+    };
+
+    // Draws have their handles resolved before recording, recording jobs never touch the buffer table
+    struct ResolvedDraw {
+        VkPipeline pipeline{VK_NULL_HANDLE};
+        VkBuffer vertexBuffer{VK_NULL_HANDLE};
+        VkBuffer indexBuffer{VK_NULL_HANDLE};
+        u32 elementCount{0};
+        u32 firstElement{0};
+        u32 instanceCount{0};
+        // Set 0, VK_NULL_HANDLE when the pipeline reads no resources
+        VkPipelineLayout layout{VK_NULL_HANDLE};
+        VkDescriptorSet descriptorSet{VK_NULL_HANDLE};
+        // Bindless pipelines only, the resources' slot is pushed to these stages
+        VkShaderStageFlags pushConstantStages{0};
+        u32 bindlessSlot{0};
+    };
+
+    // Everything a frame in flight records into, reused once the graphics timeline reached its submit value
+    struct FrameResources {
+        std::unique_ptr<VulkanCommandPool> commandPool;
+        // Secondary command buffers, one pool per job system thread
+        std::vector<std::unique_ptr<VulkanCommandPool>> recordingPools;
+        VkSemaphore imageAvailableSemaphore{VK_NULL_HANDLE};
+        // Graphics timeline value signaled by the frame's last submission, 0 before the first
+        u64 submitValue{0};
+        // Dedicated transfer queue only, upload submissions made while the frame is current
+        std::unique_ptr<VulkanCommandPool> transferPool;
+        u64 transferSubmitValue{0};
+        // Dedicated compute queue only, the frame's dispatches
+        std::unique_ptr<VulkanCommandPool> computePool;
+        u64 computeSubmitValue{0};
+        // Descriptor sets written for this frame only, reset in bulk with the command pools
+        std::unique_ptr<VulkanDescriptorAllocator> descriptorAllocator;
+    };
+
+    // Destroyed once every timeline reaches its value, no submission up to them may still use it
+    struct DeferredResource {
+        std::unique_ptr<VulkanBuffer> buffer;
+        // Released with the buffer, VulkanBindlessSet::INVALID_SLOT when it has none
+        u32 bindlessSlot{~0U};
+        std::unique_ptr<VulkanComputePipeline> computePipeline;
+        u64 retireValue{0};
+        u64 transferRetireValue{0};
+        u64 computeRetireValue{0};
+    };
+
+    // Last submissions using a buffer, work overwriting it on another queue waits for them
+    struct BufferUse {
+        u64 graphicsValue{0};
+        u64 computeValue{0};
+    };
+
+    struct RecordingChunk {
+        VulkanRenderer* renderer{nullptr};
+        size_t firstDraw{0};
+        size_t drawCount{0};
+        VkCommandBuffer commandBuffer{VK_NULL_HANDLE};
+    };
+
     VkInstance mInstance{nullptr};
     VkSurfaceKHR mSurface{nullptr};
     VkDebugUtilsMessengerEXT mDebugMessenger{nullptr};
     std::unique_ptr<VulkanDevice> mDevice;
     std::unique_ptr<VulkanSwapchain> mSwapchain;
+    // Exactly one of the two is set, dynamic rendering is used whenever the device supports it
     std::unique_ptr<RenderPass> mRenderpass;
+    std::unique_ptr<VulkanDynamicRendering> mDynamicRendering;
+    // Every pipeline is created through it, saved at shutdown
+    std::unique_ptr<VulkanPipelineCache> mPipelineCache;
+    // Descriptor set and pipeline layouts of every pipeline, outlives them
+    std::unique_ptr<VulkanLayoutCache> mLayoutCache;
+    // Dispatch and draw sets reused across frames, evicted with the buffers they reference
+    std::unique_ptr<VulkanDescriptorSetCache> mDescriptorSetCache;
+    // Every storage buffer, bound once per command buffer by bindless draws. Null without descriptor indexing
+    std::unique_ptr<VulkanBindlessSet> mBindlessSet;
+    // Builtin pipeline, also drawn with while a draw's own pipeline is compiling
+    std::unique_ptr<VulkanPipeline> mPipeline;
+    std::unique_ptr<VulkanPipelineManager> mPipelineManager;
+    // Empty with dynamic rendering
     std::vector<VulkanFramebuffer> mFrameBuffers;
-    std::vector<VulkanCommandBuffer> mCommandBuffers;
+    // Signaled by every graphics queue submission of a frame
+    std::unique_ptr<VulkanTimelineSemaphore> mGraphicsTimeline;
+    // Signaled by every upload submission when the device has a dedicated transfer queue, null otherwise
+    std::unique_ptr<VulkanTimelineSemaphore> mTransferTimeline;
+    // Signaled by every dispatch submission when the device has a dedicated compute queue, null otherwise
+    std::unique_ptr<VulkanTimelineSemaphore> mComputeTimeline;
+
+    // Indexed by mCurrentFrame
+    std::vector<FrameResources> mFrames;
+    VulkanCommandBuffer* mFrameCommandBuffer{nullptr};
+    // Staging ring head covered by the copies recorded into the frame command buffer, zero when none were
+    u64 mFrameStagingHead{0};
+    // Indexed by swapchain image. Presentation only takes binary semaphores, and a presented image is only
+    // released once its presentation is done, so the semaphore belongs to the image, not to the frame
+    std::vector<VkSemaphore> mRenderFinishedSemaphores;
+    // Graphics timeline value of the frame last rendering each image, images may be acquired out of order
+    std::vector<u64> mImageSubmitValues;
 
-    std::vector<VkSemaphore> mImageAvailableSemaphore;
-    std::vector<VkSemaphore> mRenderFinishedSemaphore;
-    std::vector<VulkanFence> mInFlightFences;
+    JobSystem* mJobSystem{nullptr};
+    std::mutex* mBackendMutex{nullptr};
+    std::vector<ResolvedDraw> mResolvedDraws;
+    std::vector<RecordingChunk> mRecordingChunks;
+    std::vector<VkCommandBuffer> mSecondaryCommandBuffers;
+    RenderPassContents mRenderPassContents{RenderPassContents::RENDER_PASS_CONTENTS_NONE};
 
+    // Indexed by handle id - 1, destroyed buffers leave an empty slot for reuse
+    std::vector<std::unique_ptr<VulkanBuffer>> mBuffers;
+    // Indexed like mBuffers
+    std::vector<BufferUse> mBufferUses;
+    // Indexed like mBuffers, VulkanBindlessSet::INVALID_SLOT for buffers outside the bindless set
+    std::vector<u32> mBindlessSlots;
+    // Values the next transfer submission waits for, its copies may overwrite buffers used until then
+    u64 mUploadWaitValue{0};
+    u64 mUploadComputeWaitValue{0};
+    // Indexed by handle id - 1, destroyed pipelines leave an empty slot for reuse
+    std::vector<std::unique_ptr<VulkanComputePipeline>> mComputePipelines;
+    // Ordered by retire value
+    std::deque<DeferredResource> mDeferredResources;
+    // Upload space for every frame in flight, copies are recorded at the start of the next frame, or submitted
+    // to the dedicated transfer queue right before it
+    std::unique_ptr<VulkanStagingRing> mStagingRing;
+
+    bool mHeadless{false};
     bool mEnableValidationLayers{false};
     bool mRecreatingSwapChain{false};
     std::vector<const char*> mValidationLayers;
 
+    uint32_t mFramesInFlight{2};
     uint32_t mCurrentFrame{0};
     uint32_t mImageIndex{0};
 
@@ -54,14 +218,40 @@ private:
     bool check_validation_layer_support();
     static void populate_debug_messenger_create_info(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
     void setup_debug_messenger();
-    void create_command_buffers();
-    void destroy_command_buffers();
     void create_framebuffers();
     void destroy_framebuffers();
-    void create_sync_objects();
-    void destroy_sync_objects();
+    void create_frame_resources();
+    void destroy_frame_resources();
+    void create_image_sync_objects();
+    void destroy_image_sync_objects();
 
     void recreate_swapchain_resources();
+    // Destroys deferred resources the GPU is done with
+    void collect_deferred_deletions();
+    // Submits the staged copies ahead of the next frame when the ring runs full, false when none are staged
+    bool flush_uploads();
+    // Submits the staged copies to the dedicated transfer queue, false when none are staged
+    bool submit_transfers();
+    // The timeline of the queue running the staged copies, staging space is reclaimed against it
+    [[nodiscard]] VulkanTimelineSemaphore& get_upload_timeline() const;
+
+    [[nodiscard]] bool can_record_in_parallel() const;
+    void begin_render_pass(RenderPassContents contents);
+    // Dynamic state and pipeline, every secondary command buffer starts without them
+    void record_frame_state(VkCommandBuffer commandBuffer) const;
+    static void record_draws(VkCommandBuffer commandBuffer, std::span<const ResolvedDraw> draws);
+    void record_in_parallel();
+    static void record_chunk(void* userData);
+
+    [[nodiscard]] VulkanBuffer* get_buffer(BufferHandle buffer) const;
+    [[nodiscard]] VulkanComputePipeline* get_compute_pipeline(ComputePipelineHandle pipeline) const;
+    // The dispatch's descriptor set from the cache or the frame's allocator, VK_NULL_HANDLE when the command is
+    // invalid
+    [[nodiscard]] VkDescriptorSet prepare_dispatch(const DispatchCommand& command,
+                                                   const VulkanComputePipeline& pipeline);
+    // Binds the command's resources buffer the way the pipeline reads it, false when it cannot be bound
+    bool resolve_draw_resources(const DrawCommand& command, const VulkanPipeline& pipeline, ResolvedDraw& draw);
+    bool submit_dispatches(VulkanCommandBuffer& commandBuffer, u64 graphicsWaitValue);
 
     static VkResult CreateDebugUtilsMessengerEXT(VkInstance instance,
                                                  const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
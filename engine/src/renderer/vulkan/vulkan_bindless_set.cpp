@@ -0,0 +1,150 @@
+#include "vulkan_bindless_set.hpp"
+#include "core/logger.hpp"
+#include "vulkan_defines.inl"
+#include "vulkan_device.hpp"
+#include <algorithm>
+
+namespace {
+    // Upper bounds, devices with lower update after bind limits get smaller arrays
+    constexpr u32 MAX_BINDLESS_BUFFERS = 16384;
+    constexpr u32 MAX_BINDLESS_IMAGES = 16384;
+    constexpr u32 MAX_BINDLESS_SAMPLERS = 1024;
+    // Every stage may read the set, draws and dispatches bind the same one
+    constexpr VkShaderStageFlags BINDLESS_STAGES = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT;
+}  // namespace
+
+u32 VulkanBindlessSet::Slots::acquire() {
+    if (!freed.empty()) {
+        const u32 slot = freed.back();
+        freed.pop_back();
+        return slot;
+    }
+    return next < capacity ? next++ : INVALID_SLOT;
+}
+
+void VulkanBindlessSet::Slots::release(u32 slot) {
+    if (slot < next) {
+        freed.push_back(slot);
+    }
+}
+
+VulkanBindlessSet::VulkanBindlessSet(const VulkanDevice& device) : mDevice{device.get_logical_device()} {
+    const auto& limits = device.get_vulkan12_properties();
+    mBufferSlots.capacity =
+        std::min({MAX_BINDLESS_BUFFERS, limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                  limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+    mImageSlots.capacity = std::min({MAX_BINDLESS_IMAGES, limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                                     limits.maxPerStageDescriptorUpdateAfterBindSampledImages});
+    mSamplerSlots.capacity = std::min({MAX_BINDLESS_SAMPLERS, limits.maxDescriptorSetUpdateAfterBindSamplers,
+                                       limits.maxPerStageDescriptorUpdateAfterBindSamplers});
+    // The per stage resource limit covers all three arrays together
+    while (mBufferSlots.capacity + mImageSlots.capacity + mSamplerSlots.capacity >
+           limits.maxPerStageUpdateAfterBindResources) {
+        mBufferSlots.capacity /= 2;
+        mImageSlots.capacity /= 2;
+    }
+
+    mBindings[STORAGE_BUFFER_BINDING] = VkDescriptorSetLayoutBinding{
+        STORAGE_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, mBufferSlots.capacity, BINDLESS_STAGES, nullptr};
+    mBindings[SAMPLED_IMAGE_BINDING] = VkDescriptorSetLayoutBinding{
+        SAMPLED_IMAGE_BINDING, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, mImageSlots.capacity, BINDLESS_STAGES, nullptr};
+    mBindings[SAMPLER_BINDING] = VkDescriptorSetLayoutBinding{
+        SAMPLER_BINDING, VK_DESCRIPTOR_TYPE_SAMPLER, mSamplerSlots.capacity, BINDLESS_STAGES, nullptr};
+
+    // Slots are written while the set is bound, and only the written ones are ever read
+    const VkDescriptorBindingFlags bindingFlag = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    const std::array<VkDescriptorBindingFlags, 3> bindingFlags{bindingFlag, bindingFlag, bindingFlag};
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = static_cast<u32>(bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = static_cast<u32>(mBindings.size());
+    layoutInfo.pBindings = mBindings.data();
+    VK_CHECK(vkCreateDescriptorSetLayout(mDevice, &layoutInfo, nullptr, &mLayout));
+
+    const std::array poolSizes{VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, mBufferSlots.capacity},
+                               VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, mImageSlots.capacity},
+                               VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, mSamplerSlots.capacity}};
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<u32>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    VK_CHECK(vkCreateDescriptorPool(mDevice, &poolInfo, nullptr, &mPool));
+
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = mPool;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &mLayout;
+    VK_CHECK(vkAllocateDescriptorSets(mDevice, &allocateInfo, &mSet));
+    MSG_DEBUG("[Vulkan] Bindless set: {:p} created for {} buffers, {} images and {} samplers",
+              static_cast<void*>(this), mBufferSlots.capacity, mImageSlots.capacity, mSamplerSlots.capacity);
+}
+
+VulkanBindlessSet::~VulkanBindlessSet() {
+    vkDestroyDescriptorPool(mDevice, mPool, nullptr);
+    vkDestroyDescriptorSetLayout(mDevice, mLayout, nullptr);
+    MSG_TRACE("[Vulkan] Bindless set: {:p} destroyed", static_cast<void*>(this));
+}
+
+u32 VulkanBindlessSet::add_buffer(VkBuffer buffer) {
+    const u32 slot = mBufferSlots.acquire();
+    if (slot != INVALID_SLOT) {
+        const VkDescriptorBufferInfo bufferInfo{buffer, 0, VK_WHOLE_SIZE};
+        write(STORAGE_BUFFER_BINDING, slot, &bufferInfo, nullptr);
+    }
+    return slot;
+}
+
+u32 VulkanBindlessSet::add_image(VkImageView imageView, VkImageLayout imageLayout) {
+    const u32 slot = mImageSlots.acquire();
+    if (slot != INVALID_SLOT) {
+        const VkDescriptorImageInfo imageInfo{VK_NULL_HANDLE, imageView, imageLayout};
+        write(SAMPLED_IMAGE_BINDING, slot, nullptr, &imageInfo);
+    }
+    return slot;
+}
+
+u32 VulkanBindlessSet::add_sampler(VkSampler sampler) {
+    const u32 slot = mSamplerSlots.acquire();
+    if (slot != INVALID_SLOT) {
+        const VkDescriptorImageInfo imageInfo{sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED};
+        write(SAMPLER_BINDING, slot, nullptr, &imageInfo);
+    }
+    return slot;
+}
+
+// Partially bound slots need not hold valid descriptors, freed ones keep the stale descriptor until reused
+void VulkanBindlessSet::remove_buffer(u32 slot) {
+    mBufferSlots.release(slot);
+}
+
+void VulkanBindlessSet::remove_image(u32 slot) {
+    mImageSlots.release(slot);
+}
+
+void VulkanBindlessSet::remove_sampler(u32 slot) {
+    mSamplerSlots.release(slot);
+}
+
+void VulkanBindlessSet::write(u32 binding, u32 slot, const VkDescriptorBufferInfo* bufferInfo,
+                              const VkDescriptorImageInfo* imageInfo) {
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = mSet;
+    write.dstBinding = binding;
+    write.dstArrayElement = slot;
+    write.descriptorCount = 1;
+    write.descriptorType = mBindings[binding].descriptorType;
+    write.pBufferInfo = bufferInfo;
+    write.pImageInfo = imageInfo;
+    vkUpdateDescriptorSets(mDevice, 1, &write, 0, nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <array>
+#include <vector>
+
+class VulkanDevice;
+
+// One large descriptor set holding every storage buffer, sampled image and sampler shaders may read, each as a
+// runtime array. Shaders index the arrays with slots passed in push constants, so the set is bound once per
+// command buffer instead of a set per draw.
+//
+// The bindings are partially bound and update after bind, slots are written while frames using the set are
+// in flight. Needs descriptor indexing. Not thread safe.
+class VulkanBindlessSet {
+public:
+    static constexpr u32 STORAGE_BUFFER_BINDING = 0;
+    static constexpr u32 SAMPLED_IMAGE_BINDING = 1;
+    static constexpr u32 SAMPLER_BINDING = 2;
+    static constexpr u32 INVALID_SLOT = ~0U;
+
+    VulkanBindlessSet(const VulkanBindlessSet&) = delete;
+    VulkanBindlessSet(VulkanBindlessSet&&) = delete;
+    VulkanBindlessSet& operator=(const VulkanBindlessSet&) = delete;
+    VulkanBindlessSet& operator=(VulkanBindlessSet&&) = delete;
+    // The arrays are sized to the device's update after bind limits
+    explicit VulkanBindlessSet(const VulkanDevice& device);
+    ~VulkanBindlessSet();
+
+    // INVALID_SLOT when the array is full
+    [[nodiscard]] u32 add_buffer(VkBuffer buffer);
+    [[nodiscard]] u32 add_image(VkImageView imageView, VkImageLayout imageLayout);
+    [[nodiscard]] u32 add_sampler(VkSampler sampler);
+    // The slot is reused by the next add, no pending work may read it anymore
+    void remove_buffer(u32 slot);
+    void remove_image(u32 slot);
+    void remove_sampler(u32 slot);
+
+    [[nodiscard]] VkDescriptorSet get_handle() const {
+        return mSet;
+    }
+    [[nodiscard]] VkDescriptorSetLayout get_layout() const {
+        return mLayout;
+    }
+    [[nodiscard]] const std::array<VkDescriptorSetLayoutBinding, 3>& get_bindings() const {
+        return mBindings;
+    }
+
+private:
+    // Slots of one binding, freed slots are reused first
+    struct Slots {
+        u32 capacity{0};
+        u32 next{0};
+        std::vector<u32> freed;
+
+        [[nodiscard]] u32 acquire();
+        void release(u32 slot);
+    };
+
+    VkDevice mDevice{nullptr};
+    std::array<VkDescriptorSetLayoutBinding, 3> mBindings{};
+    VkDescriptorSetLayout mLayout{VK_NULL_HANDLE};
+    VkDescriptorPool mPool{VK_NULL_HANDLE};
+    VkDescriptorSet mSet{VK_NULL_HANDLE};
+    Slots mBufferSlots;
+    Slots mImageSlots;
+    Slots mSamplerSlots;
+
+    void write(u32 binding, u32 slot, const VkDescriptorBufferInfo* bufferInfo, const VkDescriptorImageInfo* imageInfo);
+};
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "vulkan_buffer.hpp"
+#include "core/logger.hpp"
+#include "vulkan/vulkan_core.h"
+#include "vulkan_defines.inl"
+#include "vulkan_device.hpp"
+#include <cstring>
+
+VulkanBuffer::VulkanBuffer(VulkanDevice& device, VkDeviceSize size, VkBufferUsageFlags usageFlags,
+                           VkMemoryPropertyFlags memoryProperties, std::span<const uint32_t> queueFamilies)
+    : mDevice{&device}, mSize{size}, mConcurrent{queueFamilies.size() > 1} {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = mSize;
+    bufferInfo.usage = usageFlags;
+    bufferInfo.sharingMode = mConcurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    if (mConcurrent) {
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+        bufferInfo.pQueueFamilyIndices = queueFamilies.data();
+    }
+
+    VK_CHECK(vkCreateBuffer(mDevice->get_logical_device(), &bufferInfo, nullptr, &mHandle));
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(mDevice->get_logical_device(), mHandle, &memRequirements);
+
+    mAllocation = mDevice->get_allocator().allocate(memRequirements, memoryProperties,
+                                                    VulkanMemoryAllocator::ResourceKind::RESOURCE_KIND_LINEAR);
+
+    VK_CHECK(vkBindBufferMemory(mDevice->get_logical_device(), mHandle, mAllocation.memory, mAllocation.offset));
+    MSG_TRACE("[Vulkan] Buffer: {:p} created with {} bytes", static_cast<void*>(this), mSize);
+}
+
+VulkanBuffer::~VulkanBuffer() {
+    if (mHandle != nullptr) {
+        vkDestroyBuffer(mDevice->get_logical_device(), mHandle, nullptr);
+    }
+    mDevice->get_allocator().free(mAllocation);
+    MSG_TRACE("[Vulkan] Buffer: {:p} destroyed", static_cast<void*>(this));
+}
+
+void VulkanBuffer::load_data(const void* data, VkDeviceSize offset, VkDeviceSize size) {
+    if (mAllocation.mapped == nullptr) {
+        MSG_ERROR("[Vulkan] Buffer: {:p} is not host visible, cannot load data", static_cast<void*>(this));
+        return;
+    }
+    std::memcpy(static_cast<u8*>(mAllocation.mapped) + offset, data, size);
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include "vulkan_memory_allocator.hpp"
+#include <span>
+
+class VulkanDevice;
+
+class VulkanBuffer {
+public:
+    // With more than one queue family given the buffer is used by all of them concurrently, without queue
+    // family ownership transfers
+    VulkanBuffer(VulkanDevice& device, VkDeviceSize size, VkBufferUsageFlags usageFlags,
+                 VkMemoryPropertyFlags memoryProperties, std::span<const uint32_t> queueFamilies = {});
+    ~VulkanBuffer();
+
+    VulkanBuffer(const VulkanBuffer&) = delete;
+    VulkanBuffer(VulkanBuffer&&) = delete;
+    VulkanBuffer& operator=(const VulkanBuffer&) = delete;
+    VulkanBuffer& operator=(VulkanBuffer&&) = delete;
+
+    // Requires host visible and host coherent memory, which stays mapped
+    void load_data(const void* data, VkDeviceSize offset, VkDeviceSize size);
+
+    [[nodiscard]] const VkBuffer& get_handle() const {
+        return mHandle;
+    }
+    [[nodiscard]] VkDeviceSize get_size() const {
+        return mSize;
+    }
+    [[nodiscard]] bool is_concurrent() const {
+        return mConcurrent;
+    }
+    // Host visible buffers only, nullptr otherwise
+    [[nodiscard]] void* get_mapped() const {
+        return mAllocation.mapped;
+    }
+
+private:
+    VulkanDevice* mDevice;
+    VkDeviceSize mSize{0};
+    bool mConcurrent{false};
+
+    VkBuffer mHandle{nullptr};
+    VulkanMemoryAllocator::Allocation mAllocation{};
+};
\ No newline at end of file
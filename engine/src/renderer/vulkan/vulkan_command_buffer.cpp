@@ -21,11 +21,13 @@ VulkanCommandBuffer::~VulkanCommandBuffer() {
     MSG_INFO("[Vulkan] Command buffer: {:p} destroyed", static_cast<void*>(this));
 }
 
-void VulkanCommandBuffer::begin(bool singleUse, bool continueRenderpass, bool simultaneous) {
+void VulkanCommandBuffer::begin(bool singleUse, bool continueRenderpass, bool simultaneous,
+                                const VkCommandBufferInheritanceInfo* inheritanceInfo) {
     MSG_TRACE("[Vulkan] Command buffer: {:p} begin called", static_cast<void*>(this));
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags = 0;
+    beginInfo.pInheritanceInfo = inheritanceInfo;
     if (singleUse) {
         beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     }
@@ -58,6 +60,10 @@ void VulkanCommandBuffer::reset_state() {
     mState = State::COMMAND_BUFFER_STATE_READY;
     MSG_TRACE("[Vulkan] Command buffer: {:p} reset", static_cast<void*>(this));
 }
+
+void VulkanCommandBuffer::set_pool_reset() {
+    mState = State::COMMAND_BUFFER_STATE_READY;
+}
 // END TODO
 void VulkanCommandBuffer::begin_single_use() {
     begin(true, false, false);
@@ -67,10 +73,33 @@ void VulkanCommandBuffer::begin_multiple_use() {
     begin(false, false, false);
 }
 
+void VulkanCommandBuffer::begin_secondary(VkRenderPass renderPass, VkFramebuffer framebuffer) {
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = renderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = framebuffer;
+    begin(true, true, false, &inheritanceInfo);
+}
+
+void VulkanCommandBuffer::begin_secondary_rendering(VkFormat colorFormat, VkFormat depthFormat) {
+    VkCommandBufferInheritanceRenderingInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &colorFormat;
+    renderingInfo.depthAttachmentFormat = depthFormat;
+    renderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.pNext = &renderingInfo;
+    begin(true, true, false, &inheritanceInfo);
+}
+
 void VulkanCommandBuffer::end_single_use(VkQueue queue) {
     end();
 
-    VkSubmitInfo submitInfo;
+    VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &mHandle;
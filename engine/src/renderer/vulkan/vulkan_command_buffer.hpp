@@ -16,8 +16,14 @@ public:
 
     void update_submitted();
     void reset_state();
+    // The owning pool was reset, which already reset the buffer itself
+    void set_pool_reset();
     void begin_single_use();
     void begin_multiple_use();
+    // Secondary buffers only, records draws continuing the given render pass instance
+    void begin_secondary(VkRenderPass renderPass, VkFramebuffer framebuffer);
+    // Secondary buffers only, records draws continuing a dynamic rendering instance with these attachments
+    void begin_secondary_rendering(VkFormat colorFormat, VkFormat depthFormat);
     void end_single_use(VkQueue queue);
     void end();
 
@@ -32,5 +38,6 @@ private:
     State mState;
     bool mPrimary;
 
-    void begin(bool singleUse, bool continueRenderpass, bool simultaneous);
+    void begin(bool singleUse, bool continueRenderpass, bool simultaneous,
+               const VkCommandBufferInheritanceInfo* inheritanceInfo = nullptr);
 };
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "vulkan_command_pool.hpp"
+#include "core/logger.hpp"
+#include "vulkan_command_buffer.hpp"
+#include "vulkan_defines.inl"
+
+VulkanCommandPool::VulkanCommandPool(VkDevice device, uint32_t queueFamilyIndex) : mDevice{device} {
+    VkCommandPoolCreateInfo poolCreateInfo{};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+    // Buffers are rerecorded every time the pool is reset
+    poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    VK_CHECK(vkCreateCommandPool(mDevice, &poolCreateInfo, nullptr, &mHandle));
+    MSG_TRACE("[Vulkan] Command pool: {:p} created", static_cast<void*>(this));
+}
+
+VulkanCommandPool::~VulkanCommandPool() {
+    // Buffers are freed before the pool they were allocated from
+    mPrimaryBuffers.buffers.clear();
+    mSecondaryBuffers.buffers.clear();
+    vkDestroyCommandPool(mDevice, mHandle, nullptr);
+    MSG_TRACE("[Vulkan] Command pool: {:p} destroyed", static_cast<void*>(this));
+}
+
+void VulkanCommandPool::reset() {
+    if (mPrimaryBuffers.inUse == 0 && mSecondaryBuffers.inUse == 0) {
+        return;
+    }
+    VK_CHECK(vkResetCommandPool(mDevice, mHandle, 0));
+    for (auto* list : {&mPrimaryBuffers, &mSecondaryBuffers}) {
+        for (size_t i = 0; i < list->inUse; ++i) {
+            list->buffers[i]->set_pool_reset();
+        }
+        list->inUse = 0;
+    }
+}
+
+VulkanCommandBuffer& VulkanCommandPool::acquire(bool isPrimary) {
+    auto& list = isPrimary ? mPrimaryBuffers : mSecondaryBuffers;
+    if (list.inUse == list.buffers.size()) {
+        list.buffers.push_back(std::make_unique<VulkanCommandBuffer>(mDevice, mHandle, isPrimary));
+    }
+    return *list.buffers[list.inUse++];
+}
\ No newline at end of file
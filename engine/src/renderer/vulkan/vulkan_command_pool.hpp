@@ -0,0 +1,39 @@
+#pragma once
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <memory>
+#include <vector>
+
+class VulkanCommandBuffer;
+
+// Command pool used by a single thread, command buffers are recycled instead of freed.
+// reset() returns every buffer acquired since the previous reset to the pool at once.
+class VulkanCommandPool {
+public:
+    VulkanCommandPool(const VulkanCommandPool&) = delete;
+    VulkanCommandPool(VulkanCommandPool&&) = delete;
+    VulkanCommandPool& operator=(const VulkanCommandPool&) = delete;
+    VulkanCommandPool& operator=(VulkanCommandPool&&) = delete;
+    VulkanCommandPool(VkDevice device, uint32_t queueFamilyIndex);
+    ~VulkanCommandPool();
+
+    // Buffers acquired since the last reset must no longer be pending on the GPU
+    void reset();
+    // Valid until the next reset, allocates only when every buffer of that level is in use
+    [[nodiscard]] VulkanCommandBuffer& acquire(bool isPrimary);
+
+    [[nodiscard]] const VkCommandPool& get_handle() const {
+        return mHandle;
+    };
+
+private:
+    struct BufferList {
+        std::vector<std::unique_ptr<VulkanCommandBuffer>> buffers;
+        size_t inUse{0};
+    };
+
+    VkDevice mDevice{nullptr};
+    VkCommandPool mHandle{nullptr};
+    BufferList mPrimaryBuffers;
+    BufferList mSecondaryBuffers;
+};
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "vulkan_compute_pipeline.hpp"
+#include "core/logger.hpp"
+#include "vulkan_defines.inl"
+#include "vulkan_layout_cache.hpp"
+#include "vulkan_pipeline.hpp"
+#include "vulkan_shader_reflection.hpp"
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+VulkanComputePipeline::VulkanComputePipeline(VkDevice device, VkPipelineCache pipelineCache,
+                                             VulkanLayoutCache& layoutCache, const std::string& shaderPath,
+                                             u32 bufferCount, u32 pushConstantSize)
+    : mDevice{device}, mBufferCount{bufferCount}, mPushConstantSize{pushConstantSize} {
+    const std::vector<char> code = VulkanPipeline::read_shader_file(shaderPath);
+    const VulkanShaderReflection reflection{code};
+    if (reflection.get_stage() != VK_SHADER_STAGE_COMPUTE_BIT) {
+        MSG_ERROR("[Vulkan] {} is not a compute shader", shaderPath);
+        throw std::runtime_error("Compute pipeline shader has the wrong stage");
+    }
+    // Dispatches bind exactly the buffers the caller declared, anything else in the shader would be left unbound
+    const auto& bindings = reflection.get_bindings();
+    bool matches = bindings.size() == mBufferCount && mPushConstantSize <= reflection.get_push_constant_size();
+    for (u32 binding = 0; matches && binding < bindings.size(); ++binding) {
+        matches = bindings[binding].set == 0 && bindings[binding].binding == binding &&
+                  bindings[binding].type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER && bindings[binding].count == 1;
+    }
+    if (!matches) {
+        MSG_ERROR("[Vulkan] {} declares {} bindings and {} push constant bytes, expected {} storage buffers in set 0 "
+                  "and at least {} bytes",
+                  shaderPath, bindings.size(), reflection.get_push_constant_size(), mBufferCount,
+                  mPushConstantSize);
+        throw std::runtime_error("Compute shader resources do not match the pipeline");
+    }
+
+    const VulkanLayoutCache::PipelineLayout layout = layoutCache.get_pipeline_layout(std::span{&reflection, 1});
+    mLayout = layout.handle;
+    // Set 0 always exists for dispatches, even without buffers
+    mSetLayout = layout.setLayouts.empty() ? layoutCache.get_set_layout({}) : layout.setLayouts[0];
+
+    VkShaderModule computeShader = VulkanPipeline::create_shader_module(mDevice, code);
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = computeShader;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = mLayout;
+    VK_CHECK(vkCreateComputePipelines(mDevice, pipelineCache, 1, &pipelineInfo, nullptr, &mHandle));
+
+    // Modules are only needed during pipeline creation
+    vkDestroyShaderModule(mDevice, computeShader, nullptr);
+    MSG_INFO("[Vulkan] Compute pipeline: {:p} successfully created from {}", static_cast<void*>(this), shaderPath);
+}
+
+VulkanComputePipeline::~VulkanComputePipeline() {
+    vkDestroyPipeline(mDevice, mHandle, nullptr);
+    MSG_INFO("[Vulkan] Compute pipeline: {:p} destroyed", static_cast<void*>(this));
+}
+
+void VulkanComputePipeline::bind(VkCommandBuffer commandBuffer) const {
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mHandle);
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <string>
+
+class VulkanLayoutCache;
+
+// Compute pipeline binding its storage buffers to bindings 0..bufferCount - 1 of set 0, with an optional
+// push constant range. Its layout comes from the layout cache, generated from what the shader declares.
+class VulkanComputePipeline {
+public:
+    // Throws when the shader cannot be opened or declares other resources than the buffers and push constants
+    // the caller passes
+    VulkanComputePipeline(VkDevice device, VkPipelineCache pipelineCache, VulkanLayoutCache& layoutCache,
+                          const std::string& shaderPath, u32 bufferCount, u32 pushConstantSize);
+    ~VulkanComputePipeline();
+
+    VulkanComputePipeline(const VulkanComputePipeline&) = delete;
+    VulkanComputePipeline(VulkanComputePipeline&&) = delete;
+    VulkanComputePipeline& operator=(const VulkanComputePipeline&) = delete;
+    VulkanComputePipeline& operator=(VulkanComputePipeline&&) = delete;
+
+    void bind(VkCommandBuffer commandBuffer) const;
+
+    [[nodiscard]] const VkPipeline& get_handle() const {
+        return mHandle;
+    }
+    // Both owned by the layout cache
+    [[nodiscard]] const VkPipelineLayout& get_layout() const {
+        return mLayout;
+    }
+    [[nodiscard]] const VkDescriptorSetLayout& get_set_layout() const {
+        return mSetLayout;
+    }
+    [[nodiscard]] u32 get_buffer_count() const {
+        return mBufferCount;
+    }
+    [[nodiscard]] u32 get_push_constant_size() const {
+        return mPushConstantSize;
+    }
+
+private:
+    VkDevice mDevice{nullptr};
+    VkPipeline mHandle{nullptr};
+    VkPipelineLayout mLayout{nullptr};
+    VkDescriptorSetLayout mSetLayout{nullptr};
+    u32 mBufferCount{0};
+    u32 mPushConstantSize{0};
+};
\ No newline at end of file
@@ -3,5 +3,5 @@
 
 #define VK_CHECK(expr)                     \
     {                                      \
-        ENGINE_ASSERT(expr == VK_SUCCESS); \
-    }
\ No newline at end of file
+        ENGINE_ASSERT((expr) == VK_SUCCESS); \
+    }
@@ -0,0 +1,105 @@
+#include "vulkan_descriptor_allocator.hpp"
+#include "core/logger.hpp"
+#include "vulkan_defines.inl"
+#include <algorithm>
+#include <array>
+
+namespace {
+    // Descriptors of each type per set in a pool, a set of the layouts the engine creates fits in any pool
+    struct PoolRatio {
+        VkDescriptorType type;
+        u32 perSet;
+    };
+    constexpr std::array POOL_RATIOS{PoolRatio{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4},
+                                     PoolRatio{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+                                     PoolRatio{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+                                     PoolRatio{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2},
+                                     PoolRatio{VK_DESCRIPTOR_TYPE_SAMPLER, 1},
+                                     PoolRatio{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1}};
+    // Growth stops here, a frame needing more adds pools of this size
+    constexpr u32 MAX_SETS_PER_POOL = 4096;
+}  // namespace
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator(VkDevice device, u32 initialSetsPerPool, bool persistent)
+    : mDevice{device}, mNextSetsPerPool{std::max(initialSetsPerPool, 1U)}, mPersistent{persistent} {
+    mUsedPools.push_back(acquire_pool());
+    MSG_TRACE("[Vulkan] Descriptor allocator: {:p} created", static_cast<void*>(this));
+}
+
+VulkanDescriptorAllocator::~VulkanDescriptorAllocator() {
+    for (const auto pool : mUsedPools) {
+        vkDestroyDescriptorPool(mDevice, pool, nullptr);
+    }
+    for (const auto pool : mFreePools) {
+        vkDestroyDescriptorPool(mDevice, pool, nullptr);
+    }
+    MSG_TRACE("[Vulkan] Descriptor allocator: {:p} destroyed with {} pools", static_cast<void*>(this),
+              get_pool_count());
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::allocate(VkDescriptorSetLayout layout, VkDescriptorPool* pool) {
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &layout;
+
+    VkDescriptorSet set{VK_NULL_HANDLE};
+    // Full pools wait for the next reset, a fresh one failing as well means the set can never fit
+    for (u32 attempt = 0; attempt < 2; ++attempt) {
+        allocateInfo.descriptorPool = mUsedPools.back();
+        const VkResult result = vkAllocateDescriptorSets(mDevice, &allocateInfo, &set);
+        if (result == VK_SUCCESS) {
+            if (pool != nullptr) {
+                *pool = allocateInfo.descriptorPool;
+            }
+            return set;
+        }
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+            VK_CHECK(result);
+            return VK_NULL_HANDLE;
+        }
+        if (attempt == 0) {
+            mUsedPools.push_back(acquire_pool());
+        }
+    }
+    MSG_ERROR("[Vulkan] Descriptor set does not fit into an empty pool");
+    return VK_NULL_HANDLE;
+}
+
+void VulkanDescriptorAllocator::free(VkDescriptorPool pool, VkDescriptorSet set) {
+    VK_CHECK(vkFreeDescriptorSets(mDevice, pool, 1, &set));
+}
+
+void VulkanDescriptorAllocator::reset() {
+    for (const auto pool : mUsedPools) {
+        VK_CHECK(vkResetDescriptorPool(mDevice, pool, 0));
+    }
+    // Keeps the largest pool current, the smaller ones are reused when it runs out
+    mFreePools.insert(mFreePools.end(), mUsedPools.rbegin() + 1, mUsedPools.rend());
+    mUsedPools.erase(mUsedPools.begin(), mUsedPools.end() - 1);
+}
+
+VkDescriptorPool VulkanDescriptorAllocator::acquire_pool() {
+    if (!mFreePools.empty()) {
+        const VkDescriptorPool pool = mFreePools.back();
+        mFreePools.pop_back();
+        return pool;
+    }
+
+    const u32 setCount = mNextSetsPerPool;
+    mNextSetsPerPool = std::min(mNextSetsPerPool * 2, MAX_SETS_PER_POOL);
+    std::array<VkDescriptorPoolSize, POOL_RATIOS.size()> poolSizes{};
+    for (size_t i = 0; i < POOL_RATIOS.size(); ++i) {
+        poolSizes[i] = VkDescriptorPoolSize{POOL_RATIOS[i].type, POOL_RATIOS[i].perSet * setCount};
+    }
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = mPersistent ? VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT : 0;
+    poolInfo.maxSets = setCount;
+    poolInfo.poolSizeCount = static_cast<u32>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    VkDescriptorPool pool{VK_NULL_HANDLE};
+    VK_CHECK(vkCreateDescriptorPool(mDevice, &poolInfo, nullptr, &pool));
+    MSG_DEBUG("[Vulkan] Descriptor allocator: pool for {} sets created", setCount);
+    return pool;
+}
\ No newline at end of file
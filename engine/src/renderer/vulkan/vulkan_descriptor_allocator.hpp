@@ -0,0 +1,43 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <vector>
+
+// Descriptor sets from a growing list of pools. When the current pool runs out the next one is taken, or created
+// with twice the sets of the last, so no caller has to size its pools up front.
+//
+// Transient allocators hand out sets for one frame and are reset in bulk once the frame's work is complete,
+// persistent ones free single sets instead. Not thread safe.
+class VulkanDescriptorAllocator {
+public:
+    VulkanDescriptorAllocator(const VulkanDescriptorAllocator&) = delete;
+    VulkanDescriptorAllocator(VulkanDescriptorAllocator&&) = delete;
+    VulkanDescriptorAllocator& operator=(const VulkanDescriptorAllocator&) = delete;
+    VulkanDescriptorAllocator& operator=(VulkanDescriptorAllocator&&) = delete;
+    // Persistent allocators create their pools with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+    VulkanDescriptorAllocator(VkDevice device, u32 initialSetsPerPool, bool persistent);
+    ~VulkanDescriptorAllocator();
+
+    // VK_NULL_HANDLE only when even a new pool cannot hold the set. The pool is returned for free()
+    [[nodiscard]] VkDescriptorSet allocate(VkDescriptorSetLayout layout, VkDescriptorPool* pool = nullptr);
+    // Persistent allocators only, the set may no longer be used by pending work
+    void free(VkDescriptorPool pool, VkDescriptorSet set);
+    // Invalidates every set, the pools are kept for the next allocations. No set may be used by pending work
+    void reset();
+
+    [[nodiscard]] size_t get_pool_count() const {
+        return mUsedPools.size() + mFreePools.size();
+    }
+
+private:
+    VkDevice mDevice{nullptr};
+    u32 mNextSetsPerPool{0};
+    bool mPersistent{false};
+    // The last one is allocated from
+    std::vector<VkDescriptorPool> mUsedPools;
+    // Reset pools, reused before new ones are created
+    std::vector<VkDescriptorPool> mFreePools;
+
+    [[nodiscard]] VkDescriptorPool acquire_pool();
+};
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "vulkan_descriptor_set_cache.hpp"
+#include "core/hash.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+    // Cached sets are few and long lived, the pools start small
+    constexpr u32 CACHE_SETS_PER_POOL = 64;
+}  // namespace
+
+VulkanDescriptorSetCache::VulkanDescriptorSetCache(VkDevice device, u32 capacity)
+    : mDevice{device}, mCapacity{capacity}, mAllocator{device, CACHE_SETS_PER_POOL, true} {
+}
+
+VkDescriptorSet VulkanDescriptorSetCache::get(VkDescriptorSetLayout layout,
+                                              std::span<const BufferBinding> bindings) {
+    u64 key = hash::fnv1a_value(layout);
+    for (const auto& binding : bindings) {
+        key = hash::fnv1a_value(binding.binding, key);
+        key = hash::fnv1a_value(binding.type, key);
+        key = hash::fnv1a_value(binding.buffer, key);
+        key = hash::fnv1a_value(binding.offset, key);
+        key = hash::fnv1a_value(binding.range, key);
+    }
+    const auto [first, last] = mLookup.equal_range(key);
+    for (auto match = first; match != last; ++match) {
+        if (match->second.layout == layout && std::ranges::equal(match->second.bindings, bindings)) {
+            return match->second.set;
+        }
+    }
+    if (mLookup.size() >= mCapacity) {
+        return VK_NULL_HANDLE;
+    }
+
+    Entry entry{};
+    entry.layout = layout;
+    entry.bindings.assign(bindings.begin(), bindings.end());
+    entry.set = mAllocator.allocate(layout, &entry.pool);
+    if (entry.set == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+    write(mDevice, entry.set, bindings);
+    return mLookup.emplace(key, std::move(entry))->second.set;
+}
+
+void VulkanDescriptorSetCache::evict(VkBuffer buffer) {
+    const size_t evicted = std::erase_if(mLookup, [this, buffer](const auto& item) {
+        const auto& entry = item.second;
+        if (std::ranges::none_of(entry.bindings, [buffer](const auto& binding) { return binding.buffer == buffer; })) {
+            return false;
+        }
+        mAllocator.free(entry.pool, entry.set);
+        return true;
+    });
+    if (evicted > 0) {
+        MSG_TRACE("[Vulkan] Descriptor set cache: {} sets evicted", evicted);
+    }
+}
+
+void VulkanDescriptorSetCache::write(VkDevice device, VkDescriptorSet set, std::span<const BufferBinding> bindings) {
+    std::vector<VkDescriptorBufferInfo> bufferInfos(bindings.size());
+    std::vector<VkWriteDescriptorSet> writes(bindings.size());
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        bufferInfos[i] = VkDescriptorBufferInfo{bindings[i].buffer, bindings[i].offset, bindings[i].range};
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = bindings[i].binding;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = bindings[i].type;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(device, static_cast<u32>(writes.size()), writes.data(), 0, nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include "vulkan_descriptor_allocator.hpp"
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Descriptor sets that never change once written, keyed by a hash of their layout and bindings. Binding the
+// same resources again returns the set written the first time, without allocating or updating anything.
+//
+// Sets referencing a buffer are evicted when the buffer is destroyed. Not thread safe.
+class VulkanDescriptorSetCache {
+public:
+    struct BufferBinding {
+        u32 binding{0};
+        VkDescriptorType type{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkDeviceSize offset{0};
+        VkDeviceSize range{VK_WHOLE_SIZE};
+
+        bool operator==(const BufferBinding&) const = default;
+    };
+
+    VulkanDescriptorSetCache(const VulkanDescriptorSetCache&) = delete;
+    VulkanDescriptorSetCache(VulkanDescriptorSetCache&&) = delete;
+    VulkanDescriptorSetCache& operator=(const VulkanDescriptorSetCache&) = delete;
+    VulkanDescriptorSetCache& operator=(VulkanDescriptorSetCache&&) = delete;
+    VulkanDescriptorSetCache(VkDevice device, u32 capacity);
+    ~VulkanDescriptorSetCache() = default;
+
+    // VK_NULL_HANDLE when the set is not cached yet and the cache is full, or the allocation failed
+    [[nodiscard]] VkDescriptorSet get(VkDescriptorSetLayout layout, std::span<const BufferBinding> bindings);
+    // Frees the sets referencing the buffer, no pending work may use them anymore
+    void evict(VkBuffer buffer);
+
+    [[nodiscard]] size_t get_size() const {
+        return mLookup.size();
+    }
+
+    // Shared with sets that are not cached
+    static void write(VkDevice device, VkDescriptorSet set, std::span<const BufferBinding> bindings);
+
+private:
+    struct Entry {
+        VkDescriptorSetLayout layout{VK_NULL_HANDLE};
+        std::vector<BufferBinding> bindings;
+        VkDescriptorSet set{VK_NULL_HANDLE};
+        VkDescriptorPool pool{VK_NULL_HANDLE};
+    };
+
+    VkDevice mDevice{nullptr};
+    u32 mCapacity{0};
+    VulkanDescriptorAllocator mAllocator;
+    // Colliding layouts and bindings share a hash
+    std::unordered_multimap<u64, Entry> mLookup;
+};
\ No newline at end of file
@@ -2,18 +2,29 @@
 #include "core/logger.hpp"
 #include "vulkan/vulkan_core.h"
 #include "vulkan_defines.inl"
+#include "vulkan_memory_allocator.hpp"
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <map>
 #include <set>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 VulkanDevice::VulkanDevice(VkInstance instance, VkSurfaceKHR surface, const std::vector<const char*>& validationLayers)
     : mInstance{instance}, mSurface{surface}, mValidationLayers{validationLayers} {
+    if (!is_headless()) {
+        mDeviceExtensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
     pick_physical_device();
     create_logical_device();
+    mAllocator = std::make_unique<VulkanMemoryAllocator>(*this);
     MSG_INFO("[Vulkan] Device: {:p} initialized", static_cast<void*>(this));
 }
 
 VulkanDevice::~VulkanDevice() {
+    mAllocator.reset();
     vkDestroyCommandPool(mDevice, mGraphicsCommandPool, nullptr);
     vkDestroyDevice(mDevice, nullptr);
     MSG_INFO("[Vulkan] Device: {:p} destroyed", static_cast<void*>(this));
@@ -30,6 +41,25 @@ void VulkanDevice::pick_physical_device() {
     std::vector<VkPhysicalDevice> devices(deviceCount);
     VK_CHECK(vkEnumeratePhysicalDevices(mInstance, &deviceCount, devices.data()));
 
+    // Prefer hardware, software implementations (e.g. lavapipe) are only picked when no GPU is suitable
+    const auto deviceTypeRank = [](VkPhysicalDevice physicalDevice) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        switch (properties.deviceType) {
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+                return 0;
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+                return 1;
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+                return 2;
+            case VK_PHYSICAL_DEVICE_TYPE_CPU:
+                return 3;
+            default:
+                return 4;
+        }
+    };
+    std::ranges::stable_sort(devices, {}, deviceTypeRank);
+
     for (const auto& device : devices) {
         if (is_device_suitable(device)) {
             mPhysicalDevice = device;
@@ -46,14 +76,20 @@ bool VulkanDevice::is_device_suitable(VkPhysicalDevice physicalDevice) {
     vkGetPhysicalDeviceProperties(physicalDevice, &mDeviceProperties);
     MSG_INFO("[Vulkan] Device: {} queried, checking requirements...", mDeviceProperties.deviceName);
     vkGetPhysicalDeviceFeatures(physicalDevice, &mDeviceFeatures);
+    mVulkan12Features = VkPhysicalDeviceVulkan12Features{};
+    mVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &mVulkan12Features;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
     vkGetPhysicalDeviceMemoryProperties(physicalDevice, &mDeviceMemoryProperties);
 
     QueueFamilyIndices indices = find_queue_families(physicalDevice);
 
     bool extensionsSupported = check_device_extension_support(physicalDevice);
 
-    bool swapChainAdequate = false;
-    if (extensionsSupported) {
+    bool swapChainAdequate = is_headless();
+    if (extensionsSupported && !is_headless()) {
         mSwapChainSupport = query_swapchain_support(physicalDevice);
         swapChainAdequate = !mSwapChainSupport.formats.empty() && !mSwapChainSupport.presentModes.empty();
     }
@@ -65,7 +101,7 @@ bool VulkanDevice::is_device_suitable(VkPhysicalDevice physicalDevice) {
         return false;
     }
 
-    if (!indices.is_complete()) {
+    if (!indices.is_complete(!is_headless())) {
         MSG_INFO("[Vulkan] Device: {} does not support all required queue families!", mDeviceProperties.deviceName);
         return false;
     }
@@ -85,6 +121,12 @@ bool VulkanDevice::is_device_suitable(VkPhysicalDevice physicalDevice) {
         return false;
     }
 
+    // Frame synchronization and deferred deletion are built on timeline semaphores
+    if (mVulkan12Features.timelineSemaphore != VK_TRUE) {
+        MSG_INFO("[Vulkan] Device: {} does not support timeline semaphores!", mDeviceProperties.deviceName);
+        return false;
+    }
+
     VkFormat depthFormat{};
     if (!query_device_depth_format(physicalDevice, depthFormat)) {
         MSG_INFO("[Vulkan] Device: {} does not have a supported depth format!", mDeviceProperties.deviceName);
@@ -173,25 +215,102 @@ bool VulkanDevice::query_device_depth_format(VkPhysicalDevice physicalDevice, Vk
 void VulkanDevice::create_logical_device() {
     mQueueFamiles = find_queue_families(mPhysicalDevice);
 
-    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies = {mQueueFamiles.graphicsFamily.value(),
-                                              mQueueFamiles.presentFamily.value()};
+    const uint32_t graphicsFamily = mQueueFamiles.graphicsFamily.value();
+    const uint32_t transferFamily = mQueueFamiles.transferFamily.value();
+    const uint32_t computeFamily = mQueueFamiles.computeFamily.value();
 
-    float queuePriority = 1.0F;
-    for (uint32_t queueFamily : uniqueQueueFamilies) {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(mPhysicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(mPhysicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    // Every role takes the next unused queue of its family, a role left without one shares the family's first
+    // queue. Transfers and compute still get a queue of their own on devices with a single, but wide, family
+    std::map<uint32_t, uint32_t> queueCounts;
+    const auto claimQueue = [&](uint32_t family) -> uint32_t {
+        auto& count = queueCounts[family];
+        if (count < std::min(queueFamilies[family].queueCount, MAX_QUEUES_PER_FAMILY)) {
+            return count++;
+        }
+        return 0;
+    };
+    const uint32_t graphicsQueueIndex = claimQueue(graphicsFamily);
+    const uint32_t transferQueueIndex = claimQueue(transferFamily);
+    const uint32_t computeQueueIndex = claimQueue(computeFamily);
+    if (mQueueFamiles.presentFamily.has_value()) {
+        queueCounts.try_emplace(mQueueFamiles.presentFamily.value(), 1);
+    }
+
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+    const std::array<float, MAX_QUEUES_PER_FAMILY> queuePriorities{1.0F, 1.0F, 1.0F};
+    for (const auto& [queueFamily, queueCount] : queueCounts) {
         VkDeviceQueueCreateInfo queueCreateInfo{};
         queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         queueCreateInfo.queueFamilyIndex = queueFamily;
-        queueCreateInfo.queueCount = 1;
-        queueCreateInfo.pQueuePriorities = &queuePriority;
+        queueCreateInfo.queueCount = queueCount;
+        queueCreateInfo.pQueuePriorities = queuePriorities.data();
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+    // Queried again for the selected device, the members hold the last device checked for suitability
+    mVulkan12Features = VkPhysicalDeviceVulkan12Features{};
+    mVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    mVulkan12Properties = VkPhysicalDeviceVulkan12Properties{};
+    mVulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &mVulkan12Properties;
+    vkGetPhysicalDeviceProperties2(mPhysicalDevice, &properties2);
+    // Vulkan 1.3 structures may only be chained for devices supporting it
+    const bool vulkan13 = properties2.properties.apiVersion >= VK_API_VERSION_1_3;
+    VkPhysicalDeviceVulkan13Features supportedVulkan13Features{};
+    supportedVulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    mVulkan12Features.pNext = vulkan13 ? &supportedVulkan13Features : nullptr;
+    VkPhysicalDeviceFeatures2 supportedFeatures{};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext = &mVulkan12Features;
+    vkGetPhysicalDeviceFeatures2(mPhysicalDevice, &supportedFeatures);
+    mVulkan12Features.pNext = nullptr;
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+    // Descriptor indexing is optional, the renderer falls back to a descriptor set per draw without it. Bindless
+    // shaders index the arrays with push constants, which also takes dynamic array indexing
+    mDescriptorIndexing = supportedFeatures.features.shaderStorageBufferArrayDynamicIndexing == VK_TRUE &&
+        supportedFeatures.features.shaderSampledImageArrayDynamicIndexing == VK_TRUE &&
+        mVulkan12Features.runtimeDescriptorArray == VK_TRUE &&
+        mVulkan12Features.descriptorBindingPartiallyBound == VK_TRUE &&
+        mVulkan12Features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+        mVulkan12Features.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE &&
+        mVulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE;
+    if (mDescriptorIndexing) {
+        deviceFeatures.shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
+        deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+        vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+        vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    }
+    // Dynamic rendering is optional, the renderer falls back to render pass and framebuffer objects without it.
+    // Its layout transitions are recorded with synchronization2 barriers
+    VkPhysicalDeviceVulkan13Features vulkan13Features{};
+    vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    mDynamicRendering = vulkan13 && supportedVulkan13Features.dynamicRendering == VK_TRUE &&
+        supportedVulkan13Features.synchronization2 == VK_TRUE;
+    if (mDynamicRendering) {
+        vulkan13Features.dynamicRendering = VK_TRUE;
+        vulkan13Features.synchronization2 = VK_TRUE;
+        vulkan12Features.pNext = &vulkan13Features;
+    }
+
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &vulkan12Features;
 
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
@@ -210,15 +329,22 @@ void VulkanDevice::create_logical_device() {
         createInfo.enabledLayerCount = 0;
     }
 
-    VK_CHECK(vkCreateDevice(mPhysicalDevice, &createInfo, nullptr, &mDevice) != VK_SUCCESS);
+    VK_CHECK(vkCreateDevice(mPhysicalDevice, &createInfo, nullptr, &mDevice));
 
     MSG_INFO("[Vulkan] Successfully created logical device: {:p}", static_cast<void*>(mDevice));
 
-    vkGetDeviceQueue(mDevice, mQueueFamiles.graphicsFamily.value(), 0, &mGraphicsQueue);
-    vkGetDeviceQueue(mDevice, mQueueFamiles.presentFamily.value(), 0, &mPresentQueue);
-    vkGetDeviceQueue(mDevice, mQueueFamiles.transferFamily.value(), 0, &mTransferQueue);
+    vkGetDeviceQueue(mDevice, graphicsFamily, graphicsQueueIndex, &mGraphicsQueue);
+    if (mQueueFamiles.presentFamily.has_value()) {
+        vkGetDeviceQueue(mDevice, mQueueFamiles.presentFamily.value(), 0, &mPresentQueue);
+    }
+    vkGetDeviceQueue(mDevice, transferFamily, transferQueueIndex, &mTransferQueue);
+    vkGetDeviceQueue(mDevice, computeFamily, computeQueueIndex, &mComputeQueue);
 
-    MSG_INFO("[Vulkan] Required Device queues successfully bound");
+    MSG_INFO("[Vulkan] Required Device queues successfully bound, {} transfer queue, {} compute queue",
+             has_dedicated_transfer_queue() ? "dedicated" : "no dedicated",
+             has_dedicated_compute_queue() ? "dedicated" : "no dedicated");
+    MSG_INFO("[Vulkan] Descriptor indexing {}", mDescriptorIndexing ? "enabled" : "not supported, bindless disabled");
+    MSG_INFO("[Vulkan] Dynamic rendering {}", mDynamicRendering ? "enabled" : "not supported, using render passes");
 
     VkCommandPoolCreateInfo poolCreateInfo;
     poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -240,20 +366,28 @@ VulkanDevice::QueueFamilyIndices VulkanDevice::find_queue_families(VkPhysicalDev
     std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
     vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
 
-    int i{0};
+    // Every family is scanned, transfers prefer the family with the fewest other capabilities and compute prefers
+    // a family without graphics, those queues run alongside the graphics queue
+    uint32_t i{0};
     int minTransferScore{255};
     MSG_INFO("[Vulkan] Selected device queue families");
     MSG_INFO("[Vulkan] Graphics | Present | Compute | Transfer | Name");
     for (const auto& queueFamily : queueFamilies) {
         int currentTransferScore{0};
+        const bool hasGraphics = (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) != VK_FALSE;
+        const bool hasCompute = (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) != VK_FALSE;
 
-        if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) != VK_FALSE) {
-            indices.graphicsFamily = i;
+        if (hasGraphics) {
+            if (!indices.graphicsFamily.has_value()) {
+                indices.graphicsFamily = i;
+            }
             ++currentTransferScore;
         }
 
-        if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) != VK_FALSE) {
-            indices.computeFamily = i;
+        if (hasCompute) {
+            if (!indices.computeFamily.has_value() || (!hasGraphics && indices.computeFamily == indices.graphicsFamily)) {
+                indices.computeFamily = i;
+            }
             ++currentTransferScore;
         }
 
@@ -264,15 +398,13 @@ VulkanDevice::QueueFamilyIndices VulkanDevice::find_queue_families(VkPhysicalDev
             }
         }
 
-        VkBool32 presentSupport = VK_FALSE;
-        VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, mSurface, &presentSupport));
-        if (presentSupport == VK_TRUE) {
-            indices.presentFamily = i;
-        }
-
-        if (indices.is_complete()) {
-            // TODO: this might not find the most optimal queues for each, only first match for all.
-            break;
+        if (!is_headless()) {
+            VkBool32 presentSupport = VK_FALSE;
+            VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, mSurface, &presentSupport));
+            // Presenting from the graphics family avoids handing swapchain images between queues
+            if (presentSupport == VK_TRUE && (!indices.presentFamily.has_value() || indices.graphicsFamily == i)) {
+                indices.presentFamily = i;
+            }
         }
         i++;
     }
@@ -308,4 +440,15 @@ VulkanDevice::SwapChainSupportDetails VulkanDevice::query_swapchain_support(VkPh
     }
 
     return details;
+}
+
+uint32_t VulkanDevice::find_memory_type_index(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < mDeviceMemoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1U << i)) != 0 &&
+            (mDeviceMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    MSG_FATAL("[Vulkan] Failed to find suitable memory type!");
+    throw std::runtime_error("Failed to find suitable memory type!");
 }
\ No newline at end of file
@@ -1,11 +1,17 @@
 #pragma once
 #include "defines.hpp"
 
+#include <memory>
 #include <optional>
 #include <vector>
 #include <vulkan/vulkan.h>
 
+class VulkanMemoryAllocator;
+
 class VulkanDevice {
+    // Graphics, transfer and compute each take a queue of a family when it has enough
+    static constexpr uint32_t MAX_QUEUES_PER_FAMILY = 3;
+
     struct SwapChainSupportDetails {
         VkSurfaceCapabilitiesKHR capabilities;
         std::vector<VkSurfaceFormatKHR> formats;
@@ -18,17 +24,18 @@ class VulkanDevice {
         std::optional<uint32_t> computeFamily;
         std::optional<uint32_t> transferFamily;
 
-        [[nodiscard]] bool is_complete() const {
-            return graphicsFamily.has_value() && presentFamily.has_value() && computeFamily.has_value() &&
-                transferFamily.has_value();
+        [[nodiscard]] bool is_complete(bool requirePresent) const {
+            return graphicsFamily.has_value() && (presentFamily.has_value() || !requirePresent) &&
+                computeFamily.has_value() && transferFamily.has_value();
         }
     };
 
 public:
-    VulkanDevice(const VulkanDevice&) = default;
+    VulkanDevice(const VulkanDevice&) = delete;
     VulkanDevice(VulkanDevice&&) = delete;
     VulkanDevice& operator=(const VulkanDevice&) = delete;
     VulkanDevice& operator=(VulkanDevice&&) = delete;
+    // A VK_NULL_HANDLE surface creates a headless device without presentation support
     VulkanDevice(VkInstance instance, VkSurfaceKHR surface, const std::vector<const char*>& validationLayers);
     ~VulkanDevice();
     [[nodiscard]] const SwapChainSupportDetails& get_swapchain_support_details() {
@@ -41,6 +48,9 @@ public:
     [[nodiscard]] const VkSurfaceKHR& get_surface() const {
         return mSurface;
     }
+    [[nodiscard]] bool is_headless() const {
+        return mSurface == VK_NULL_HANDLE;
+    }
     [[nodiscard]] const QueueFamilyIndices& get_queue_families() const {
         return mQueueFamiles;
     }
@@ -50,6 +60,16 @@ public:
     [[nodiscard]] const VkPhysicalDeviceMemoryProperties& get_memory_properties() const {
         return mDeviceMemoryProperties;
     }
+    [[nodiscard]] const VkPhysicalDeviceProperties& get_properties() const {
+        return mDeviceProperties;
+    }
+    // Every image and buffer of the device allocates its memory here
+    [[nodiscard]] VulkanMemoryAllocator& get_allocator() const {
+        return *mAllocator;
+    }
+    // Throws when no memory type allowed by typeFilter has all requested properties
+    [[nodiscard]] uint32_t find_memory_type_index(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
     [[nodiscard]] const VkCommandPool& get_graphics_commandpool() const {
         return mGraphicsCommandPool;
     }
@@ -62,12 +82,50 @@ public:
         return mPresentQueue;
     }
 
+    // The graphics queue itself when the device offers no other queue for transfers
+    [[nodiscard]] const VkQueue& get_transfer_queue() const {
+        return mTransferQueue;
+    }
+
+    // Uploads on a queue of their own overlap rendering, but have to be synchronized with the graphics queue
+    [[nodiscard]] bool has_dedicated_transfer_queue() const {
+        return mTransferQueue != mGraphicsQueue;
+    }
+
+    // The graphics queue itself when the device offers no other queue for compute
+    [[nodiscard]] const VkQueue& get_compute_queue() const {
+        return mComputeQueue;
+    }
+
+    // Dispatches on a queue of their own overlap rasterization, but have to be synchronized with the graphics queue
+    [[nodiscard]] bool has_dedicated_compute_queue() const {
+        return mComputeQueue != mGraphicsQueue;
+    }
+
+    // Runtime descriptor arrays of partially bound, update after bind descriptors are enabled, which the
+    // bindless descriptor set needs. Without them draws bind a descriptor set each
+    [[nodiscard]] bool supports_descriptor_indexing() const {
+        return mDescriptorIndexing;
+    }
+    // Dynamic rendering and synchronization2 are enabled, render passes and framebuffers are not needed
+    [[nodiscard]] bool supports_dynamic_rendering() const {
+        return mDynamicRendering;
+    }
+    // Update after bind descriptor limits among others
+    [[nodiscard]] const VkPhysicalDeviceVulkan12Properties& get_vulkan12_properties() const {
+        return mVulkan12Properties;
+    }
+
 private:
     VkInstance mInstance{nullptr};
     VkSurfaceKHR mSurface{nullptr};
     VkPhysicalDevice mPhysicalDevice{nullptr};
     VkPhysicalDeviceProperties mDeviceProperties{};
     VkPhysicalDeviceFeatures mDeviceFeatures{};
+    VkPhysicalDeviceVulkan12Features mVulkan12Features{};
+    VkPhysicalDeviceVulkan12Properties mVulkan12Properties{};
+    bool mDescriptorIndexing{false};
+    bool mDynamicRendering{false};
     VkPhysicalDeviceMemoryProperties mDeviceMemoryProperties{};
     SwapChainSupportDetails mSwapChainSupport{};
     QueueFamilyIndices mQueueFamiles{};
@@ -75,13 +133,15 @@ private:
     VkQueue mGraphicsQueue{nullptr};
     VkQueue mPresentQueue{nullptr};
     VkQueue mTransferQueue{nullptr};
+    VkQueue mComputeQueue{nullptr};
     VkCommandPool mGraphicsCommandPool{nullptr};
     VkFormat mDepthFormat{};
+    std::unique_ptr<VulkanMemoryAllocator> mAllocator;
 
     std::vector<const char*> mValidationLayers;
 
     //TODO: Make this configurable
-    const std::vector<const char*> mDeviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    std::vector<const char*> mDeviceExtensions;
 
 
     void pick_physical_device();
@@ -0,0 +1,103 @@
+#include "vulkan_dynamic_rendering.hpp"
+#include "core/logger.hpp"
+#include <array>
+
+namespace {
+    VkImageMemoryBarrier2 image_barrier(VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout,
+                                        VkImageLayout newLayout) {
+        VkImageMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = VkImageSubresourceRange{aspect, 0, 1, 0, 1};
+        return barrier;
+    }
+
+    void pipeline_barrier(VkCommandBuffer commandBuffer, const VkImageMemoryBarrier2* barriers, u32 barrierCount) {
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.imageMemoryBarrierCount = barrierCount;
+        dependencyInfo.pImageMemoryBarriers = barriers;
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    }
+}  // namespace
+
+VulkanDynamicRendering::VulkanDynamicRendering(VkRect2D renderArea, VkClearColorValue clearColor,
+                                               VkClearDepthStencilValue depthStencil, VkFormat depthFormat,
+                                               VkImageLayout finalColorLayout)
+    : mRenderArea{renderArea}, mClearColor{clearColor}, mDepthStencil{depthStencil},
+      mFinalColorLayout{finalColorLayout} {
+    // Without separate depth stencil layouts both aspects change layout together
+    if (depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT) {
+        mDepthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    MSG_INFO("[Vulkan] Dynamic rendering: {:p} created", static_cast<void*>(this));
+}
+
+void VulkanDynamicRendering::begin(VkCommandBuffer commandBuffer, const Attachments& attachments,
+                                   VkRenderingFlags flags) const {
+    MSG_TRACE("[Vulkan] Dynamic rendering: {:p} begin render called", static_cast<const void*>(this));
+    // Both attachments are cleared, their previous contents are discarded. The color image's stage waits on
+    // image acquisition, the depth image is shared with the frame before
+    std::array<VkImageMemoryBarrier2, 2> barriers{
+        image_barrier(attachments.colorImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+                      VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL),
+        image_barrier(attachments.depthImage, mDepthAspect, VK_IMAGE_LAYOUT_UNDEFINED,
+                      VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)};
+    barriers[0].srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    barriers[0].srcAccessMask = VK_ACCESS_2_NONE;
+    barriers[0].dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[1].srcStageMask =
+        VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    barriers[1].srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barriers[1].dstStageMask =
+        VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    barriers[1].dstAccessMask =
+        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    pipeline_barrier(commandBuffer, barriers.data(), static_cast<u32>(barriers.size()));
+
+    VkRenderingAttachmentInfo colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    colorAttachment.imageView = attachments.colorView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue.color = mClearColor;
+
+    VkRenderingAttachmentInfo depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    depthAttachment.imageView = attachments.depthView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.clearValue.depthStencil = mDepthStencil;
+
+    VkRenderingInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    renderingInfo.flags = flags;
+    renderingInfo.renderArea = mRenderArea;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+    vkCmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void VulkanDynamicRendering::end(VkCommandBuffer commandBuffer, const Attachments& attachments) const {
+    MSG_TRACE("[Vulkan] Dynamic rendering: {:p} end render called", static_cast<const void*>(this));
+    vkCmdEndRendering(commandBuffer);
+
+    // Presentation waits on a semaphore signaled after the barrier, offscreen images are read by copies
+    const bool copied = mFinalColorLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    VkImageMemoryBarrier2 barrier = image_barrier(attachments.colorImage, VK_IMAGE_ASPECT_COLOR_BIT,
+                                                  VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, mFinalColorLayout);
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstStageMask = copied ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_NONE;
+    barrier.dstAccessMask = copied ? VK_ACCESS_2_TRANSFER_READ_BIT : VK_ACCESS_2_NONE;
+    pipeline_barrier(commandBuffer, &barrier, 1);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+
+// Begins and ends dynamic rendering instances on the swapchain images, replacing RenderPass and VulkanFramebuffer
+// on devices supporting it. Nothing is created per image, so swapchain recreation has nothing to rebuild.
+//
+// The layout transitions a render pass makes through its attachment descriptions and subpass dependency are
+// recorded as synchronization2 barriers around each instance instead.
+class VulkanDynamicRendering {
+public:
+    struct Attachments {
+        VkImage colorImage{VK_NULL_HANDLE};
+        VkImageView colorView{VK_NULL_HANDLE};
+        VkImage depthImage{VK_NULL_HANDLE};
+        VkImageView depthView{VK_NULL_HANDLE};
+    };
+
+    // Color images are left in finalColorLayout, ready for presentation or to be copied from when offscreen
+    VulkanDynamicRendering(VkRect2D renderArea, VkClearColorValue clearColor, VkClearDepthStencilValue depthStencil,
+                           VkFormat depthFormat, VkImageLayout finalColorLayout);
+
+    // Draws are either recorded inline or executed from secondary command buffers, never both
+    void begin(VkCommandBuffer commandBuffer, const Attachments& attachments, VkRenderingFlags flags = 0) const;
+    void end(VkCommandBuffer commandBuffer, const Attachments& attachments) const;
+
+    void set_render_area_extent(VkExtent2D extent) {
+        mRenderArea.extent = extent;
+    }
+
+private:
+    VkRect2D mRenderArea{};
+    VkClearColorValue mClearColor{};
+    VkClearDepthStencilValue mDepthStencil{};
+    VkImageAspectFlags mDepthAspect{VK_IMAGE_ASPECT_DEPTH_BIT};
+    VkImageLayout mFinalColorLayout{VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
+};
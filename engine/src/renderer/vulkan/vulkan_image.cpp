@@ -3,10 +3,10 @@
 #include "vulkan/vulkan_core.h"
 #include "vulkan_defines.inl"
 #include "vulkan_device.hpp"
-#include <stdexcept>
 
 VulkanImage::VulkanImage(VulkanDevice& device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling,
-                         VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties)
+                         VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties,
+                         VkImageAspectFlags aspectFlags)
     : mDevice{&device}, mWidth{width}, mHeight{height}, mFormat{format} {
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -29,28 +29,22 @@ VulkanImage::VulkanImage(VulkanDevice& device, uint32_t width, uint32_t height,
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(mDevice->get_logical_device(), mHandle, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = find_memory_type_index(memRequirements.memoryTypeBits, memoryProperties);
+    const auto kind = tiling == VK_IMAGE_TILING_LINEAR ? VulkanMemoryAllocator::ResourceKind::RESOURCE_KIND_LINEAR
+                                                       : VulkanMemoryAllocator::ResourceKind::RESOURCE_KIND_OPTIMAL;
+    mAllocation = mDevice->get_allocator().allocate(memRequirements, memoryProperties, kind);
 
-    VK_CHECK(vkAllocateMemory(mDevice->get_logical_device(), &allocInfo, nullptr, &mMemory));
-
-    VK_CHECK(vkBindImageMemory(mDevice->get_logical_device(), mHandle, mMemory, 0));
-    // TODO: This should be configurable!
-    create_image_view(VK_IMAGE_ASPECT_DEPTH_BIT);
+    VK_CHECK(vkBindImageMemory(mDevice->get_logical_device(), mHandle, mAllocation.memory, mAllocation.offset));
+    create_image_view(aspectFlags);
 }
 
 VulkanImage::~VulkanImage() {
     if (mImageView != nullptr) {
         vkDestroyImageView(mDevice->get_logical_device(), mImageView, nullptr);
     }
-    if (mMemory != nullptr) {
-        vkFreeMemory(mDevice->get_logical_device(), mMemory, nullptr);
-    }
     if (mHandle != nullptr) {
         vkDestroyImage(mDevice->get_logical_device(), mHandle, nullptr);
     }
+    mDevice->get_allocator().free(mAllocation);
 }
 
 void VulkanImage::create_image_view(VkImageAspectFlags aspectFlags) {
@@ -71,15 +65,4 @@ void VulkanImage::create_image_view(VkImageAspectFlags aspectFlags) {
     viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
 
     VK_CHECK(vkCreateImageView(mDevice->get_logical_device(), &viewInfo, nullptr, &mImageView));
-}
-
-uint32_t VulkanImage::find_memory_type_index(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties = mDevice->get_memory_properties();
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-    MSG_FATAL("[Vulkan] Failed to find suitable image format!");
-    throw std::runtime_error("Failed to find suitable memory type!");
 }
\ No newline at end of file
@@ -2,18 +2,27 @@
 
 #include "defines.hpp"
 #include "vulkan/vulkan_core.h"
+#include "vulkan_memory_allocator.hpp"
 
 class VulkanDevice;
 
 class VulkanImage {
 public:
     VulkanImage(VulkanDevice& device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling,
-                VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties);
+                VkImageUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties, VkImageAspectFlags aspectFlags);
     ~VulkanImage();
 
+    VulkanImage(const VulkanImage&) = delete;
+    VulkanImage(VulkanImage&&) = delete;
+    VulkanImage& operator=(const VulkanImage&) = delete;
+    VulkanImage& operator=(VulkanImage&&) = delete;
+
     [[nodiscard]] const VkFormat& get_format() const {
         return mFormat;
     }
+    [[nodiscard]] VkImage get_handle() const {
+        return mHandle;
+    }
     [[nodiscard]] VkImageView get_view() const {
         return mImageView;
     }
@@ -25,11 +34,9 @@ private:
     VkFormat mFormat{};
 
     VkImage mHandle{nullptr};
-    VkDeviceMemory mMemory{nullptr};
+    VulkanMemoryAllocator::Allocation mAllocation{};
     VkImageView mImageView{nullptr};
 
 
     void create_image_view(VkImageAspectFlags aspectFlags);
-
-    uint32_t find_memory_type_index(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 };
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "vulkan_layout_cache.hpp"
+#include "core/hash.hpp"
+#include "core/logger.hpp"
+#include "vulkan_defines.inl"
+#include "vulkan_shader_reflection.hpp"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    bool same_bindings(std::span<const VkDescriptorSetLayoutBinding> left,
+                       std::span<const VkDescriptorSetLayoutBinding> right) {
+        return std::ranges::equal(left, right, [](const auto& a, const auto& b) {
+            return a.binding == b.binding && a.descriptorType == b.descriptorType &&
+                   a.descriptorCount == b.descriptorCount && a.stageFlags == b.stageFlags;
+        });
+    }
+}  // namespace
+
+VulkanLayoutCache::VulkanLayoutCache(VkDevice device) : mDevice{device} {
+    MSG_TRACE("[Vulkan] Layout cache: {:p} created", static_cast<void*>(this));
+}
+
+VulkanLayoutCache::~VulkanLayoutCache() {
+    for (const auto& [key, entry] : mPipelineLayouts) {
+        vkDestroyPipelineLayout(mDevice, entry.handle, nullptr);
+    }
+    for (const auto& [key, entry] : mSetLayouts) {
+        vkDestroyDescriptorSetLayout(mDevice, entry.handle, nullptr);
+    }
+    MSG_TRACE("[Vulkan] Layout cache: {:p} destroyed with {} set layouts and {} pipeline layouts",
+              static_cast<void*>(this), mSetLayouts.size(), mPipelineLayouts.size());
+}
+
+VulkanLayoutCache::PipelineLayout VulkanLayoutCache::get_pipeline_layout(
+    std::span<const VulkanShaderReflection> stages) {
+    // Bindings by set, then binding number, ordered so equal resources always give equal layouts
+    std::map<u32, std::map<u32, VkDescriptorSetLayoutBinding>> sets;
+    PipelineLayout layout{};
+    for (const auto& stage : stages) {
+        for (const auto& reflected : stage.get_bindings()) {
+            if (reflected.count == 0) {
+                layout.bindlessSet = reflected.set;
+            }
+            auto [binding, inserted] = sets[reflected.set].try_emplace(reflected.binding);
+            if (inserted) {
+                binding->second.binding = reflected.binding;
+                binding->second.descriptorType = reflected.type;
+                binding->second.descriptorCount = reflected.count;
+            } else if (binding->second.descriptorType != reflected.type ||
+                       binding->second.descriptorCount != reflected.count) {
+                MSG_ERROR("[Vulkan] Shader stages disagree on set {} binding {}", reflected.set, reflected.binding);
+                throw std::runtime_error("Shader stages declare a binding differently");
+            }
+            binding->second.stageFlags |= stage.get_stage();
+        }
+        if (stage.get_push_constant_size() > 0) {
+            // One range covering every stage keeps push constant updates a single call
+            layout.pushConstantStages |= stage.get_stage();
+            layout.pushConstantSize = std::max(layout.pushConstantSize, stage.get_push_constant_size());
+        }
+    }
+
+    const std::scoped_lock lock{mMutex};
+    if (layout.bindlessSet.has_value()) {
+        check_bindless_set(sets[layout.bindlessSet.value()]);
+    }
+    const u32 setCount = sets.empty() ? 0 : sets.rbegin()->first + 1;
+    for (u32 set = 0; set < setCount; ++set) {
+        if (set == layout.bindlessSet) {
+            layout.setLayouts.push_back(mBindlessLayout);
+            continue;
+        }
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        if (const auto found = sets.find(set); found != sets.end()) {
+            for (const auto& [number, binding] : found->second) {
+                bindings.push_back(binding);
+            }
+        }
+        layout.setLayouts.push_back(find_set_layout(bindings));
+    }
+    VkPushConstantRange pushConstants{};
+    pushConstants.stageFlags = layout.pushConstantStages;
+    pushConstants.offset = 0;
+    pushConstants.size = layout.pushConstantSize;
+    layout.handle = find_pipeline_layout(layout.setLayouts, pushConstants);
+    return layout;
+}
+
+void VulkanLayoutCache::set_bindless_layout(VkDescriptorSetLayout layout,
+                                            std::span<const VkDescriptorSetLayoutBinding> bindings) {
+    const std::scoped_lock lock{mMutex};
+    mBindlessLayout = layout;
+    mBindlessBindings.assign(bindings.begin(), bindings.end());
+}
+
+void VulkanLayoutCache::check_bindless_set(const std::map<u32, VkDescriptorSetLayoutBinding>& bindings) const {
+    if (mBindlessLayout == VK_NULL_HANDLE) {
+        throw std::runtime_error("Runtime descriptor arrays need descriptor indexing, which the device lacks");
+    }
+    // Shaders may declare any subset of the bindless bindings, each no larger than the array it indexes
+    for (const auto& [number, binding] : bindings) {
+        const bool fits = std::ranges::any_of(mBindlessBindings, [&binding](const auto& bindless) {
+            return bindless.binding == binding.binding && bindless.descriptorType == binding.descriptorType &&
+                binding.descriptorCount <= bindless.descriptorCount;
+        });
+        if (!fits) {
+            MSG_ERROR("[Vulkan] Binding {} of a set with runtime descriptor arrays is not in the bindless layout",
+                      number);
+            throw std::runtime_error("Shader set does not fit the bindless layout");
+        }
+    }
+}
+
+VkDescriptorSetLayout VulkanLayoutCache::get_set_layout(std::span<const VkDescriptorSetLayoutBinding> bindings) {
+    const std::scoped_lock lock{mMutex};
+    return find_set_layout(bindings);
+}
+
+VkDescriptorSetLayout VulkanLayoutCache::find_set_layout(std::span<const VkDescriptorSetLayoutBinding> bindings) {
+    u64 key = hash::fnv1a_value(bindings.size());
+    for (const auto& binding : bindings) {
+        key = hash::fnv1a_value(binding.binding, key);
+        key = hash::fnv1a_value(binding.descriptorType, key);
+        key = hash::fnv1a_value(binding.descriptorCount, key);
+        key = hash::fnv1a_value(binding.stageFlags, key);
+    }
+    const auto [first, last] = mSetLayouts.equal_range(key);
+    for (auto match = first; match != last; ++match) {
+        if (same_bindings(match->second.bindings, bindings)) {
+            return match->second.handle;
+        }
+    }
+
+    SetLayoutEntry entry{};
+    entry.bindings.assign(bindings.begin(), bindings.end());
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+    setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutInfo.bindingCount = static_cast<u32>(entry.bindings.size());
+    setLayoutInfo.pBindings = entry.bindings.data();
+    VK_CHECK(vkCreateDescriptorSetLayout(mDevice, &setLayoutInfo, nullptr, &entry.handle));
+    MSG_DEBUG("[Vulkan] Layout cache: descriptor set layout with {} bindings created", entry.bindings.size());
+    return mSetLayouts.emplace(key, std::move(entry))->second.handle;
+}
+
+VkPipelineLayout VulkanLayoutCache::find_pipeline_layout(std::span<const VkDescriptorSetLayout> setLayouts,
+                                                         const VkPushConstantRange& pushConstants) {
+    u64 key = hash::fnv1a_value(setLayouts.size());
+    for (const auto& setLayout : setLayouts) {
+        key = hash::fnv1a_value(setLayout, key);
+    }
+    key = hash::fnv1a_value(pushConstants.stageFlags, key);
+    key = hash::fnv1a_value(pushConstants.size, key);
+    const auto [first, last] = mPipelineLayouts.equal_range(key);
+    for (auto match = first; match != last; ++match) {
+        const auto& entry = match->second;
+        if (std::ranges::equal(entry.setLayouts, setLayouts) &&
+            entry.pushConstants.stageFlags == pushConstants.stageFlags &&
+            entry.pushConstants.size == pushConstants.size) {
+            return entry.handle;
+        }
+    }
+
+    PipelineLayoutEntry entry{};
+    entry.setLayouts.assign(setLayouts.begin(), setLayouts.end());
+    entry.pushConstants = pushConstants;
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<u32>(entry.setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = entry.setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = pushConstants.size > 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = &entry.pushConstants;
+    VK_CHECK(vkCreatePipelineLayout(mDevice, &pipelineLayoutInfo, nullptr, &entry.handle));
+    MSG_DEBUG("[Vulkan] Layout cache: pipeline layout with {} sets and {} push constant bytes created",
+              entry.setLayouts.size(), pushConstants.size);
+    return mPipelineLayouts.emplace(key, std::move(entry))->second.handle;
+}
\ No newline at end of file
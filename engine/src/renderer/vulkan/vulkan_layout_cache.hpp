@@ -0,0 +1,72 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+class VulkanShaderReflection;
+
+// Descriptor set and pipeline layouts generated from shader reflection, deduplicated by a hash of their
+// contents. Pipelines whose shaders declare the same resources get the same layout handles, so descriptor sets
+// stay bound across pipeline switches and the layouts are created once for all of them.
+//
+// Thread safe, pipelines are created on the compile threads. Layouts live as long as the cache.
+class VulkanLayoutCache {
+public:
+    struct PipelineLayout {
+        VkPipelineLayout handle{nullptr};
+        // Indexed by set number, sets no stage declares get an empty layout
+        std::vector<VkDescriptorSetLayout> setLayouts;
+        VkShaderStageFlags pushConstantStages{0};
+        u32 pushConstantSize{0};
+        // The set declaring runtime descriptor arrays, it uses the bindless layout
+        std::optional<u32> bindlessSet;
+    };
+
+    VulkanLayoutCache(const VulkanLayoutCache&) = delete;
+    VulkanLayoutCache(VulkanLayoutCache&&) = delete;
+    VulkanLayoutCache& operator=(const VulkanLayoutCache&) = delete;
+    VulkanLayoutCache& operator=(VulkanLayoutCache&&) = delete;
+    explicit VulkanLayoutCache(VkDevice device);
+    ~VulkanLayoutCache();
+
+    // Merges the stages' resources, throws when two stages declare a binding differently or a set with runtime
+    // descriptor arrays does not fit the bindless layout
+    [[nodiscard]] PipelineLayout get_pipeline_layout(std::span<const VulkanShaderReflection> stages);
+    // Sets declaring runtime descriptor arrays are given this layout, which stays owned by the caller and has to
+    // outlive the cache. Without one such sets are rejected
+    void set_bindless_layout(VkDescriptorSetLayout layout, std::span<const VkDescriptorSetLayoutBinding> bindings);
+    // Bindings sorted by binding number, without immutable samplers
+    [[nodiscard]] VkDescriptorSetLayout get_set_layout(std::span<const VkDescriptorSetLayoutBinding> bindings);
+
+private:
+    struct SetLayoutEntry {
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        VkDescriptorSetLayout handle{nullptr};
+    };
+
+    struct PipelineLayoutEntry {
+        std::vector<VkDescriptorSetLayout> setLayouts;
+        VkPushConstantRange pushConstants{};
+        VkPipelineLayout handle{nullptr};
+    };
+
+    VkDevice mDevice{nullptr};
+    std::mutex mMutex;
+    VkDescriptorSetLayout mBindlessLayout{VK_NULL_HANDLE};
+    std::vector<VkDescriptorSetLayoutBinding> mBindlessBindings;
+    // Colliding contents share a hash
+    std::unordered_multimap<u64, SetLayoutEntry> mSetLayouts;
+    std::unordered_multimap<u64, PipelineLayoutEntry> mPipelineLayouts;
+
+    // Callers hold mMutex. Throws when the bindings are not part of the bindless layout
+    void check_bindless_set(const std::map<u32, VkDescriptorSetLayoutBinding>& bindings) const;
+    [[nodiscard]] VkDescriptorSetLayout find_set_layout(std::span<const VkDescriptorSetLayoutBinding> bindings);
+    [[nodiscard]] VkPipelineLayout find_pipeline_layout(std::span<const VkDescriptorSetLayout> setLayouts,
+                                                        const VkPushConstantRange& pushConstants);
+};
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "vulkan_memory_allocator.hpp"
+#include "core/logger.hpp"
+#include "vulkan_defines.inl"
+#include "vulkan_device.hpp"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    // Heaps smaller than this get proportionally smaller blocks
+    constexpr VkDeviceSize SMALL_HEAP_SIZE = 1024ULL * 1024 * 1024;
+    constexpr VkDeviceSize SMALL_HEAP_BLOCK_DIVISOR = 8;
+}  // namespace
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(const VulkanDevice& device)
+    : mDevice{&device}, mLogicalDevice{device.get_logical_device()},
+      mBufferImageGranularity{std::max<VkDeviceSize>(device.get_properties().limits.bufferImageGranularity, 1)} {
+    const auto& memoryProperties = mDevice->get_memory_properties();
+    mBlockSizes.resize(memoryProperties.memoryTypeCount);
+    mPools.resize(memoryProperties.memoryTypeCount);
+    for (u32 typeIndex = 0; typeIndex < memoryProperties.memoryTypeCount; ++typeIndex) {
+        const auto heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[typeIndex].heapIndex].size;
+        mBlockSizes[typeIndex] = heapSize < SMALL_HEAP_SIZE
+            ? std::max(std::bit_floor(heapSize / SMALL_HEAP_BLOCK_DIVISOR), MIN_BLOCK_SIZE)
+            : DEFAULT_BLOCK_SIZE;
+    }
+    MSG_TRACE("[Vulkan] Memory allocator: {:p} created, buffer image granularity {}", static_cast<void*>(this),
+              mBufferImageGranularity);
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+    for (auto& pools : mPools) {
+        for (auto& pool : pools) {
+            for (const auto& block : pool.blocks) {
+                if (block->allocationCount > 0) {
+                    MSG_WARN("[Vulkan] Memory block of {} bytes destroyed with {} live allocations", block->size,
+                             block->allocationCount);
+                }
+                vkFreeMemory(mLogicalDevice, block->memory, nullptr);
+            }
+        }
+    }
+    MSG_TRACE("[Vulkan] Memory allocator: {:p} destroyed", static_cast<void*>(this));
+}
+
+VulkanMemoryAllocator::Allocation VulkanMemoryAllocator::allocate(const VkMemoryRequirements& requirements,
+                                                                  VkMemoryPropertyFlags properties,
+                                                                  ResourceKind kind) {
+    const u32 memoryTypeIndex = mDevice->find_memory_type_index(requirements.memoryTypeBits, properties);
+    const u32 kindIndex = get_kind_index(kind);
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+    std::scoped_lock lock{mMutex};
+    auto& pool = mPools[memoryTypeIndex][kindIndex];
+    const VkDeviceSize blockSize = mBlockSizes[memoryTypeIndex];
+
+    Allocation allocation{};
+    if (requirements.size > blockSize / 2) {
+        auto& block = create_block(memoryTypeIndex, kindIndex, requirements.size, true);
+        assign(block, 0, requirements.size, alignment, 0, allocation);
+        return allocation;
+    }
+
+    for (auto& block : pool.blocks) {
+        if (!block->dedicated && allocate_buddy(*block, requirements.size, alignment, allocation)) {
+            return allocation;
+        }
+    }
+
+    auto& block = create_block(memoryTypeIndex, kindIndex, blockSize, false);
+    if (!allocate_buddy(block, requirements.size, alignment, allocation)) {
+        MSG_FATAL("[Vulkan] Allocation of {} bytes does not fit a new block of {} bytes", requirements.size,
+                  blockSize);
+        throw std::runtime_error("Vulkan memory allocation failed");
+    }
+    return allocation;
+}
+
+void VulkanMemoryAllocator::free(Allocation& allocation) {
+    if (!allocation.is_valid()) {
+        return;
+    }
+    std::scoped_lock lock{mMutex};
+    Pool& pool = mPools[allocation.block->memoryTypeIndex][allocation.block->kindIndex];
+    free_locked(allocation);
+    release_empty_blocks(pool);
+}
+
+void VulkanMemoryAllocator::set_relocatable(const Allocation& allocation, RelocateFunction function, void* userData) {
+    if (!allocation.is_valid() || allocation.block->dedicated) {
+        return;
+    }
+    std::scoped_lock lock{mMutex};
+    allocation.block->relocations.push_back(
+        {allocation.offset, allocation.size, allocation.alignment, allocation.level, function, userData});
+}
+
+u32 VulkanMemoryAllocator::defragment() {
+    std::scoped_lock lock{mMutex};
+    u32 moves = 0;
+    for (auto& pools : mPools) {
+        for (auto& pool : pools) {
+            Block* source = nullptr;
+            for (const auto& block : pool.blocks) {
+                if (!block->dedicated && block->allocationCount > 0 &&
+                    (source == nullptr || block->bytesUsed < source->bytesUsed)) {
+                    source = block.get();
+                }
+            }
+            if (source == nullptr) {
+                continue;
+            }
+            // Successful moves remove entries from the source block
+            const auto relocations = source->relocations;
+            for (const auto& relocation : relocations) {
+                Allocation target{};
+                const bool placed = std::ranges::any_of(pool.blocks, [&](const auto& block) {
+                    return block.get() != source && !block->dedicated &&
+                        allocate_buddy(*block, relocation.size, relocation.alignment, target);
+                });
+                if (!placed) {
+                    continue;
+                }
+                if (!relocation.function(relocation.userData, target)) {
+                    free_locked(target);
+                    continue;
+                }
+                target.block->relocations.push_back({target.offset, target.size, target.alignment, target.level,
+                                                     relocation.function, relocation.userData});
+                Allocation old{};
+                old.memory = source->memory;
+                old.offset = relocation.offset;
+                old.size = relocation.size;
+                old.alignment = relocation.alignment;
+                old.block = source;
+                old.level = relocation.level;
+                free_locked(old);
+                ++moves;
+            }
+            release_empty_blocks(pool);
+        }
+    }
+    if (moves > 0) {
+        MSG_DEBUG("[Vulkan] Defragmentation moved {} allocations", moves);
+    }
+    return moves;
+}
+
+VulkanMemoryAllocator::Statistics VulkanMemoryAllocator::get_statistics() const {
+    std::scoped_lock lock{mMutex};
+    Statistics statistics{};
+    for (const auto& pools : mPools) {
+        for (const auto& pool : pools) {
+            for (const auto& block : pool.blocks) {
+                (block->dedicated ? statistics.dedicatedAllocationCount : statistics.blockCount) += 1;
+                statistics.allocationCount += block->allocationCount;
+                statistics.bytesReserved += block->size;
+                statistics.bytesUsed += block->bytesUsed;
+            }
+        }
+    }
+    return statistics;
+}
+
+std::string VulkanMemoryAllocator::get_usage() const {
+    constexpr f64 mebibyte = 1024.0 * 1024.0;
+    const auto& memoryProperties = mDevice->get_memory_properties();
+    std::vector<Statistics> heaps(memoryProperties.memoryHeapCount);
+    {
+        std::scoped_lock lock{mMutex};
+        for (u32 typeIndex = 0; typeIndex < mPools.size(); ++typeIndex) {
+            auto& heap = heaps[memoryProperties.memoryTypes[typeIndex].heapIndex];
+            for (const auto& pool : mPools[typeIndex]) {
+                for (const auto& block : pool.blocks) {
+                    (block->dedicated ? heap.dedicatedAllocationCount : heap.blockCount) += 1;
+                    heap.allocationCount += block->allocationCount;
+                    heap.bytesReserved += block->size;
+                    heap.bytesUsed += block->bytesUsed;
+                }
+            }
+        }
+    }
+
+    std::ostringstream stringStream;
+    stringStream << "GPU memory use (per heap): \n";
+    for (u32 heapIndex = 0; heapIndex < heaps.size(); ++heapIndex) {
+        const auto& heap = heaps[heapIndex];
+        const bool deviceLocal = (memoryProperties.memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        stringStream << "  Heap " << heapIndex << (deviceLocal ? " (local) " : " (shared)") << ": " << std::fixed
+                     << std::setprecision(2) << static_cast<f64>(heap.bytesUsed) / mebibyte << "MiB used of "
+                     << static_cast<f64>(heap.bytesReserved) / mebibyte << "MiB in " << heap.blockCount
+                     << " blocks, " << heap.dedicatedAllocationCount << " dedicated, " << heap.allocationCount
+                     << " allocations\n";
+    }
+    return stringStream.str();
+}
+
+u32 VulkanMemoryAllocator::get_kind_index(ResourceKind kind) const {
+    // Without a granularity constraint every resource shares the same blocks
+    return mBufferImageGranularity > 1 ? static_cast<u32>(kind) : 0;
+}
+
+VulkanMemoryAllocator::Block& VulkanMemoryAllocator::create_block(u32 memoryTypeIndex, u32 kindIndex, VkDeviceSize size,
+                                                                  bool dedicated) {
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    auto block = std::make_unique<Block>();
+    const VkResult result = vkAllocateMemory(mLogicalDevice, &allocInfo, nullptr, &block->memory);
+    if (result != VK_SUCCESS) {
+        MSG_FATAL("[Vulkan] Failed to allocate a memory block of {} bytes from memory type {}", size, memoryTypeIndex);
+        throw std::runtime_error("Vulkan memory allocation failed");
+    }
+    const auto propertyFlags = mDevice->get_memory_properties().memoryTypes[memoryTypeIndex].propertyFlags;
+    if ((propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+        VK_CHECK(vkMapMemory(mLogicalDevice, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped));
+    }
+
+    block->size = size;
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->kindIndex = kindIndex;
+    block->dedicated = dedicated;
+    if (!dedicated) {
+        const auto levelCount = static_cast<size_t>(std::countr_zero(size) - std::countr_zero(MIN_BUDDY_SIZE)) + 1;
+        block->freeLists.resize(levelCount);
+        block->freeLists[0].push_back(0);
+    }
+    MSG_DEBUG("[Vulkan] {} memory block of {} bytes allocated from memory type {}",
+              dedicated ? "Dedicated" : "Buddy", size, memoryTypeIndex);
+
+    auto& pool = mPools[memoryTypeIndex][kindIndex];
+    pool.blocks.push_back(std::move(block));
+    return *pool.blocks.back();
+}
+
+void VulkanMemoryAllocator::destroy_block(Pool& pool, const Block& block) {
+    vkFreeMemory(mLogicalDevice, block.memory, nullptr);
+    std::erase_if(pool.blocks, [&block](const auto& candidate) { return candidate.get() == &block; });
+}
+
+bool VulkanMemoryAllocator::allocate_buddy(Block& block, VkDeviceSize size, VkDeviceSize alignment,
+                                           Allocation& outAllocation) {
+    // Ranges are aligned to their own power of two size, which covers every Vulkan alignment below it
+    const VkDeviceSize rangeSize = std::bit_ceil(std::max({size, alignment, MIN_BUDDY_SIZE}));
+    if (rangeSize > block.size) {
+        return false;
+    }
+    const auto level = static_cast<u32>(std::countr_zero(block.size) - std::countr_zero(rangeSize));
+
+    // Smallest free range the allocation fits in
+    u32 freeLevel = level + 1;
+    while (freeLevel > 0 && block.freeLists[freeLevel - 1].empty()) {
+        --freeLevel;
+    }
+    if (freeLevel == 0) {
+        return false;
+    }
+    --freeLevel;
+
+    const VkDeviceSize offset = block.freeLists[freeLevel].back();
+    block.freeLists[freeLevel].pop_back();
+    // Split down to the requested level, the upper halves become free
+    for (u32 splitLevel = freeLevel + 1; splitLevel <= level; ++splitLevel) {
+        block.freeLists[splitLevel].push_back(offset + (block.size >> splitLevel));
+    }
+    assign(block, offset, size, alignment, level, outAllocation);
+    return true;
+}
+
+void VulkanMemoryAllocator::assign(Block& block, VkDeviceSize offset, VkDeviceSize size, VkDeviceSize alignment,
+                                   u32 level, Allocation& outAllocation) {
+    outAllocation.memory = block.memory;
+    outAllocation.offset = offset;
+    outAllocation.size = size;
+    outAllocation.alignment = alignment;
+    outAllocation.mapped = block.mapped != nullptr ? static_cast<u8*>(block.mapped) + offset : nullptr;
+    outAllocation.block = &block;
+    outAllocation.level = level;
+    ++block.allocationCount;
+    block.bytesUsed += size;
+}
+
+void VulkanMemoryAllocator::free_locked(Allocation& allocation) {
+    Block& block = *allocation.block;
+    --block.allocationCount;
+    block.bytesUsed -= allocation.size;
+    std::erase_if(block.relocations,
+                  [&allocation](const Relocation& relocation) { return relocation.offset == allocation.offset; });
+
+    // Dedicated blocks hold a single allocation and are released once it is freed
+    if (!block.dedicated) {
+        VkDeviceSize offset = allocation.offset;
+        u32 level = allocation.level;
+        // Merge with the buddy for as long as it is free as well
+        while (level > 0) {
+            const VkDeviceSize buddy = offset ^ (block.size >> level);
+            auto& freeList = block.freeLists[level];
+            auto freeBuddy = std::ranges::find(freeList, buddy);
+            if (freeBuddy == freeList.end()) {
+                break;
+            }
+            *freeBuddy = freeList.back();
+            freeList.pop_back();
+            offset = std::min(offset, buddy);
+            --level;
+        }
+        block.freeLists[level].push_back(offset);
+    }
+    allocation = Allocation{};
+}
+
+void VulkanMemoryAllocator::release_empty_blocks(Pool& pool) {
+    bool keptEmptyBlock = false;
+    std::vector<const Block*> emptyBlocks;
+    for (const auto& block : pool.blocks) {
+        if (block->allocationCount > 0) {
+            continue;
+        }
+        if (block->dedicated || keptEmptyBlock) {
+            emptyBlocks.push_back(block.get());
+        } else {
+            keptEmptyBlock = true;
+        }
+    }
+    for (const auto* block : emptyBlocks) {
+        destroy_block(pool, *block);
+    }
+}
\ No newline at end of file
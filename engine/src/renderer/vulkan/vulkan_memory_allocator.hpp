@@ -0,0 +1,140 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class VulkanDevice;
+
+// Sub-allocates device memory out of large blocks per memory type, keeping vkAllocateMemory calls far below
+// maxMemoryAllocationCount and off the resource creation path.
+//
+// Blocks are buddy allocated: ranges are power of two sized and merge with their buddy when freed. Resources
+// larger than half a block get a dedicated allocation.
+//
+// With a bufferImageGranularity above 1 buffers and optimally tiled images are placed in separate blocks, so
+// neighbouring linear and non-linear resources can never share a granularity page.
+class VulkanMemoryAllocator {
+public:
+    enum class ResourceKind : u8 {
+        RESOURCE_KIND_LINEAR,  // Buffers and linearly tiled images
+        RESOURCE_KIND_OPTIMAL  // Optimally tiled images
+    };
+
+private:
+    struct Block;
+
+public:
+    // Owned by the resource bound to it and handed back with free()
+    struct Allocation {
+        VkDeviceMemory memory{VK_NULL_HANDLE};
+        VkDeviceSize offset{0};
+        VkDeviceSize size{0};
+        VkDeviceSize alignment{1};
+        // Host visible blocks stay mapped for their whole lifetime, points at offset
+        void* mapped{nullptr};
+
+        [[nodiscard]] bool is_valid() const {
+            return memory != VK_NULL_HANDLE;
+        }
+
+    private:
+        friend class VulkanMemoryAllocator;
+        Block* block{nullptr};
+        u32 level{0};
+    };
+
+    struct Statistics {
+        u64 blockCount{0};
+        u64 dedicatedAllocationCount{0};
+        u64 allocationCount{0};
+        u64 bytesReserved{0};  // Device memory allocated for blocks and dedicated allocations
+        u64 bytesUsed{0};      // Requested by live allocations, without padding
+    };
+
+    // Called for every allocation defragment() moves. The owner copies its contents into the new allocation and
+    // rebinds its resource to it before returning true, the allocator then frees the old allocation.
+    // Runs with the allocator locked, it must not call back into the allocator
+    using RelocateFunction = bool (*)(void* userData, const Allocation& newAllocation);
+
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ULL * 1024 * 1024;
+    static constexpr VkDeviceSize MIN_BLOCK_SIZE = 1ULL * 1024 * 1024;
+    static constexpr VkDeviceSize MIN_BUDDY_SIZE = 256;
+
+    VulkanMemoryAllocator(const VulkanMemoryAllocator&) = delete;
+    VulkanMemoryAllocator(VulkanMemoryAllocator&&) = delete;
+    VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+    VulkanMemoryAllocator& operator=(VulkanMemoryAllocator&&) = delete;
+    explicit VulkanMemoryAllocator(const VulkanDevice& device);
+    ~VulkanMemoryAllocator();
+
+    // Throws when no memory type satisfies the requirements or the device is out of memory
+    [[nodiscard]] Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+                                      ResourceKind kind);
+    void free(Allocation& allocation);
+
+    // Defragmentation hook, nothing in the renderer opts in yet. Registers a block allocation for defragment(),
+    // until it is freed
+    void set_relocatable(const Allocation& allocation, RelocateFunction function, void* userData);
+    // Moves the relocatable allocations of each pool's sparsest block into its other blocks, releasing the block
+    // once emptied. Nothing synchronizes with the GPU: no submitted work may still access a relocatable resource,
+    // idle the device first. Returns the number of allocations moved
+    u32 defragment();
+
+    [[nodiscard]] Statistics get_statistics() const;
+    // Per heap usage, formatted like MemoryManager::get_usage()
+    [[nodiscard]] std::string get_usage() const;
+
+private:
+    struct Relocation {
+        VkDeviceSize offset{0};
+        VkDeviceSize size{0};
+        VkDeviceSize alignment{1};
+        u32 level{0};
+        RelocateFunction function{nullptr};
+        void* userData{nullptr};
+    };
+
+    struct Block {
+        VkDeviceMemory memory{VK_NULL_HANDLE};
+        VkDeviceSize size{0};
+        void* mapped{nullptr};
+        u32 memoryTypeIndex{0};
+        u32 kindIndex{0};
+        bool dedicated{false};
+        u32 allocationCount{0};
+        VkDeviceSize bytesUsed{0};
+        // Free range offsets per level, level 0 spans the whole block and each level halves the size. Empty for
+        // dedicated blocks
+        std::vector<std::vector<VkDeviceSize>> freeLists;
+        std::vector<Relocation> relocations;
+    };
+
+    // Blocks of one memory type and resource kind
+    struct Pool {
+        std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    static constexpr u32 RESOURCE_KIND_COUNT = 2;
+
+    const VulkanDevice* mDevice{nullptr};
+    VkDevice mLogicalDevice{VK_NULL_HANDLE};
+    VkDeviceSize mBufferImageGranularity{1};
+    std::vector<VkDeviceSize> mBlockSizes;  // Indexed by memory type
+    std::vector<std::array<Pool, RESOURCE_KIND_COUNT>> mPools;
+    mutable std::mutex mMutex;
+
+    [[nodiscard]] u32 get_kind_index(ResourceKind kind) const;
+    Block& create_block(u32 memoryTypeIndex, u32 kindIndex, VkDeviceSize size, bool dedicated);
+    void destroy_block(Pool& pool, const Block& block);
+    static bool allocate_buddy(Block& block, VkDeviceSize size, VkDeviceSize alignment, Allocation& outAllocation);
+    static void assign(Block& block, VkDeviceSize offset, VkDeviceSize size, VkDeviceSize alignment, u32 level,
+                       Allocation& outAllocation);
+    void free_locked(Allocation& allocation);
+    // Keeps one empty block per pool around, allocation patterns tend to repeat
+    void release_empty_blocks(Pool& pool);
+};
\ No newline at end of file
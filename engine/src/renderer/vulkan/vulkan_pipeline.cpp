@@ -0,0 +1,258 @@
+#include "vulkan_pipeline.hpp"
+#include "core/logger.hpp"
+#include "renderer/renderer_types.hpp"
+#include "vulkan/vulkan_core.h"
+#include "vulkan_defines.inl"
+#include "vulkan_layout_cache.hpp"
+#include "vulkan_shader_reflection.hpp"
+#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    VkPrimitiveTopology to_vulkan_topology(PrimitiveTopology topology) {
+        switch (topology) {
+            case PrimitiveTopology::PRIMITIVE_TOPOLOGY_LINE_LIST:
+                return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+            case PrimitiveTopology::PRIMITIVE_TOPOLOGY_POINT_LIST:
+                return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+            case PrimitiveTopology::PRIMITIVE_TOPOLOGY_TRIANGLE_LIST:
+            default:
+                return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        }
+    }
+
+    VkCullModeFlags to_vulkan_cull_mode(CullMode cullMode) {
+        switch (cullMode) {
+            case CullMode::CULL_MODE_BACK:
+                return VK_CULL_MODE_BACK_BIT;
+            case CullMode::CULL_MODE_FRONT:
+                return VK_CULL_MODE_FRONT_BIT;
+            case CullMode::CULL_MODE_NONE:
+            default:
+                return VK_CULL_MODE_NONE;
+        }
+    }
+
+    VkPipelineColorBlendAttachmentState to_vulkan_blend_state(BlendMode blendMode) {
+        VkPipelineColorBlendAttachmentState blendState{};
+        blendState.colorWriteMask =
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        if (blendMode == BlendMode::BLEND_MODE_OPAQUE) {
+            blendState.blendEnable = VK_FALSE;
+            return blendState;
+        }
+        const bool additive = blendMode == BlendMode::BLEND_MODE_ADDITIVE;
+        blendState.blendEnable = VK_TRUE;
+        blendState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        blendState.dstColorBlendFactor = additive ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blendState.colorBlendOp = VK_BLEND_OP_ADD;
+        blendState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        blendState.dstAlphaBlendFactor = additive ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blendState.alphaBlendOp = VK_BLEND_OP_ADD;
+        return blendState;
+    }
+}  // namespace
+
+VulkanPipeline::VulkanPipeline(VkDevice device, VkPipelineCache pipelineCache, VulkanLayoutCache& layoutCache,
+                               const RenderTarget& target, const PipelineDescription& description)
+    : mDevice{device} {
+    const std::vector<char> vertexCode = read_shader_file(description.vertexShader);
+    const std::vector<char> fragmentCode = read_shader_file(description.fragmentShader);
+    const std::array reflections{VulkanShaderReflection{vertexCode}, VulkanShaderReflection{fragmentCode}};
+    if (reflections[0].get_stage() != VK_SHADER_STAGE_VERTEX_BIT ||
+        reflections[1].get_stage() != VK_SHADER_STAGE_FRAGMENT_BIT) {
+        MSG_ERROR("[Vulkan] {} and {} are not a vertex and a fragment shader", description.vertexShader,
+                  description.fragmentShader);
+        throw std::runtime_error("Pipeline shaders have the wrong stages");
+    }
+
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(Vertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(Vertex, position);
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    attributeDescriptions[1].offset = offsetof(Vertex, color);
+
+    // Caught here rather than by the validation layers, which only warn about it
+    for (const auto& input : reflections[0].get_vertex_inputs()) {
+        const bool provided = std::ranges::any_of(attributeDescriptions, [&input](const auto& attribute) {
+            return attribute.location == input.location && attribute.format == input.format;
+        });
+        if (!provided) {
+            MSG_ERROR("[Vulkan] {} reads vertex input location {} the vertex layout does not provide",
+                      description.vertexShader, input.location);
+            throw std::runtime_error("Vertex shader inputs do not match the vertex layout");
+        }
+    }
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = to_vulkan_topology(description.topology);
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    // Set every frame by the backend
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    std::array dynamicStates{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0F;
+    rasterizer.cullMode = to_vulkan_cull_mode(description.cullMode);
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = description.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = description.depthTest && description.depthWrite ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
+    const VkPipelineColorBlendAttachmentState colorBlendAttachment = to_vulkan_blend_state(description.blendMode);
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    VulkanLayoutCache::PipelineLayout layout = layoutCache.get_pipeline_layout(reflections);
+    if (layout.bindlessSet.has_value()) {
+        if (*layout.bindlessSet != 0 || layout.setLayouts.size() != 1 || layout.pushConstantSize < sizeof(u32)) {
+            MSG_ERROR("[Vulkan] {} and {} must read the bindless set as set 0 and its slot from push constants",
+                      description.vertexShader, description.fragmentShader);
+            throw std::runtime_error("Pipeline reads the bindless set in an unsupported way");
+        }
+        mDrawResources = DrawResources::DRAW_RESOURCES_BINDLESS;
+    } else if (!layout.setLayouts.empty()) {
+        for (const auto& reflection : reflections) {
+            for (const auto& binding : reflection.get_bindings()) {
+                if (binding.set != 0 || binding.binding != 0 ||
+                    binding.type != VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || binding.count != 1) {
+                    MSG_ERROR("[Vulkan] {} and {} may only read a storage buffer at set 0 binding 0",
+                              description.vertexShader, description.fragmentShader);
+                    throw std::runtime_error("Pipeline reads resources draws cannot bind");
+                }
+            }
+        }
+        mDrawResources = DrawResources::DRAW_RESOURCES_DESCRIPTOR_SET;
+    }
+    mLayout = layout.handle;
+    mSetLayouts = std::move(layout.setLayouts);
+    mPushConstantStages = layout.pushConstantStages;
+
+    VkShaderModule vertexShader = create_shader_module(mDevice, vertexCode);
+    VkShaderModule fragmentShader = create_shader_module(mDevice, fragmentCode);
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertexShader;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragmentShader;
+    shaderStages[1].pName = "main";
+
+    // Ignored when a render pass is given
+    VkPipelineRenderingCreateInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &target.colorFormat;
+    renderingInfo.depthAttachmentFormat = target.depthFormat;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = target.renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
+    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = mLayout;
+    pipelineInfo.renderPass = target.renderPass;
+    pipelineInfo.subpass = 0;
+
+    VK_CHECK(vkCreateGraphicsPipelines(mDevice, pipelineCache, 1, &pipelineInfo, nullptr, &mHandle));
+
+    // Modules are only needed during pipeline creation
+    vkDestroyShaderModule(mDevice, fragmentShader, nullptr);
+    vkDestroyShaderModule(mDevice, vertexShader, nullptr);
+    MSG_INFO("[Vulkan] Pipeline: {:p} successfully created", static_cast<void*>(this));
+}
+
+VulkanPipeline::~VulkanPipeline() {
+    vkDestroyPipeline(mDevice, mHandle, nullptr);
+    MSG_INFO("[Vulkan] Pipeline: {:p} destroyed", static_cast<void*>(this));
+}
+
+void VulkanPipeline::bind(VkCommandBuffer commandBuffer) const {
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mHandle);
+}
+
+VkShaderModule VulkanPipeline::create_shader_module(VkDevice device, const std::vector<char>& code) {
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size();
+    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule shaderModule{nullptr};
+    VK_CHECK(vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule));
+    return shaderModule;
+}
+
+std::vector<char> VulkanPipeline::read_shader_file(const std::string& path) {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        MSG_FATAL("[Vulkan] Failed to open shader: {}", path);
+        throw std::runtime_error("Failed to open shader file!");
+    }
+
+    const auto fileSize = static_cast<size_t>(file.tellg());
+    std::vector<char> buffer(fileSize);
+    file.seekg(0);
+    file.read(buffer.data(), static_cast<std::streamsize>(fileSize));
+    MSG_DEBUG("[Vulkan] Loaded shader: {} ({} bytes)", path, fileSize);
+    return buffer;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "defines.hpp"
+#include "renderer/renderer_types.hpp"
+#include "vulkan/vulkan_core.h"
+#include <string>
+#include <vector>
+
+class VulkanLayoutCache;
+
+// Graphics pipeline built from a PipelineDescription, viewport and scissor are dynamic state.
+// Its layout comes from the layout cache, generated from what the shaders declare.
+class VulkanPipeline {
+public:
+    // What the shaders read besides vertex inputs, the draw's resources buffer is bound accordingly
+    enum class DrawResources {
+        DRAW_RESOURCES_NONE,
+        // Storage buffer at binding 0 of set 0, bound with a descriptor set per draw
+        DRAW_RESOURCES_DESCRIPTOR_SET,
+        // Storage buffer array of the bindless set as set 0, the draw's slot is the first u32 of push constants
+        DRAW_RESOURCES_BINDLESS
+    };
+
+    // What the pipeline renders into. Without a render pass it is drawn inside dynamic rendering instances with
+    // these attachment formats
+    struct RenderTarget {
+        VkRenderPass renderPass{VK_NULL_HANDLE};
+        VkFormat colorFormat{VK_FORMAT_UNDEFINED};
+        VkFormat depthFormat{VK_FORMAT_UNDEFINED};
+    };
+
+    // The description's shader paths are opened as given. Throws when a shader cannot be opened, reads vertex
+    // inputs the description's vertex layout does not provide or declares resources no DrawResources binds
+    VulkanPipeline(VkDevice device, VkPipelineCache pipelineCache, VulkanLayoutCache& layoutCache,
+                   const RenderTarget& target, const PipelineDescription& description);
+    ~VulkanPipeline();
+
+    VulkanPipeline(const VulkanPipeline&) = delete;
+    VulkanPipeline(VulkanPipeline&&) = delete;
+    VulkanPipeline& operator=(const VulkanPipeline&) = delete;
+    VulkanPipeline& operator=(VulkanPipeline&&) = delete;
+
+    void bind(VkCommandBuffer commandBuffer) const;
+
+    [[nodiscard]] const VkPipeline& get_handle() const {
+        return mHandle;
+    }
+    // Owned by the layout cache
+    [[nodiscard]] const VkPipelineLayout& get_layout() const {
+        return mLayout;
+    }
+    [[nodiscard]] const std::vector<VkDescriptorSetLayout>& get_set_layouts() const {
+        return mSetLayouts;
+    }
+    [[nodiscard]] DrawResources get_draw_resources() const {
+        return mDrawResources;
+    }
+    [[nodiscard]] VkShaderStageFlags get_push_constant_stages() const {
+        return mPushConstantStages;
+    }
+
+    // Shared with the other pipeline kinds, throws when the file cannot be opened
+    [[nodiscard]] static std::vector<char> read_shader_file(const std::string& path);
+    [[nodiscard]] static VkShaderModule create_shader_module(VkDevice device, const std::vector<char>& code);
+
+private:
+    VkDevice mDevice{nullptr};
+    VkPipeline mHandle{nullptr};
+    VkPipelineLayout mLayout{nullptr};
+    std::vector<VkDescriptorSetLayout> mSetLayouts;
+    DrawResources mDrawResources{DrawResources::DRAW_RESOURCES_NONE};
+    VkShaderStageFlags mPushConstantStages{0};
+};
\ No newline at end of file
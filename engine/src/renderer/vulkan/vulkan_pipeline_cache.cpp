@@ -0,0 +1,133 @@
+#include "vulkan_pipeline_cache.hpp"
+#include "core/hash.hpp"
+#include "core/logger.hpp"
+#include "vulkan_defines.inl"
+#include "vulkan_device.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace {
+    constexpr u32 FILE_MAGIC = 0x43505645;  // "EVPC"
+    // Bump when FileHeader changes
+    constexpr u32 FILE_VERSION = 1;
+}  // namespace
+
+VulkanPipelineCache::VulkanPipelineCache(const VulkanDevice& device, std::string path)
+    : mDevice{device.get_logical_device()}, mPath{std::move(path)} {
+    const auto& properties = device.get_properties();
+    mDeviceHeader.magic = FILE_MAGIC;
+    mDeviceHeader.version = FILE_VERSION;
+    mDeviceHeader.vendorID = properties.vendorID;
+    mDeviceHeader.deviceID = properties.deviceID;
+    mDeviceHeader.driverVersion = properties.driverVersion;
+    std::memcpy(mDeviceHeader.pipelineCacheUUID.data(), properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    const std::vector<u8> initialData = mPath.empty() ? std::vector<u8>{} : load_file();
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = initialData.size();
+    createInfo.pInitialData = initialData.data();
+    VK_CHECK(vkCreatePipelineCache(mDevice, &createInfo, nullptr, &mHandle));
+    mLoadedSize = initialData.size();
+    MSG_TRACE("[Vulkan] Pipeline cache: {:p} created with {} bytes", static_cast<void*>(this), mLoadedSize);
+}
+
+VulkanPipelineCache::~VulkanPipelineCache() {
+    vkDestroyPipelineCache(mDevice, mHandle, nullptr);
+    MSG_TRACE("[Vulkan] Pipeline cache: {:p} destroyed", static_cast<void*>(this));
+}
+
+bool VulkanPipelineCache::save() {
+    if (mPath.empty()) {
+        return false;
+    }
+    size_t dataSize = 0;
+    VK_CHECK(vkGetPipelineCacheData(mDevice, mHandle, &dataSize, nullptr));
+    std::vector<u8> data(dataSize);
+    // The cache may only grow between the two calls when pipelines are created meanwhile
+    if (vkGetPipelineCacheData(mDevice, mHandle, &dataSize, data.data()) != VK_SUCCESS) {
+        MSG_WARN("[Vulkan] Pipeline cache data changed while saving, not saved");
+        return false;
+    }
+    data.resize(dataSize);
+
+    FileHeader header = mDeviceHeader;
+    header.dataSize = data.size();
+    header.dataHash = hash::fnv1a(data.data(), data.size());
+
+    // Written next to the file and renamed over it, a crash while saving never leaves a truncated cache behind
+    const std::string temporaryPath = mPath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            MSG_WARN("[Vulkan] Failed to write pipeline cache: {}", temporaryPath);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, mPath, error);
+    if (error) {
+        MSG_WARN("[Vulkan] Failed to replace pipeline cache: {} ({})", mPath, error.message());
+        return false;
+    }
+    MSG_INFO("[Vulkan] Saved {} bytes of pipeline cache to {}", data.size(), mPath);
+    return true;
+}
+
+std::vector<u8> VulkanPipelineCache::load_file() const {
+    std::ifstream file(mPath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        MSG_INFO("[Vulkan] No pipeline cache at {}, starting cold", mPath);
+        return {};
+    }
+    const auto fileSize = static_cast<u64>(file.tellg());
+    file.seekg(0);
+
+    FileHeader header{};
+    if (fileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        MSG_WARN("[Vulkan] Pipeline cache {} is truncated, starting cold", mPath);
+        return {};
+    }
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION) {
+        MSG_WARN("[Vulkan] Pipeline cache {} has an unknown format, starting cold", mPath);
+        return {};
+    }
+    if (header.vendorID != mDeviceHeader.vendorID || header.deviceID != mDeviceHeader.deviceID ||
+        header.driverVersion != mDeviceHeader.driverVersion ||
+        header.pipelineCacheUUID != mDeviceHeader.pipelineCacheUUID) {
+        MSG_INFO("[Vulkan] Pipeline cache {} was written for another device or driver, starting cold", mPath);
+        return {};
+    }
+    if (header.dataSize != fileSize - sizeof(header)) {
+        MSG_WARN("[Vulkan] Pipeline cache {} is truncated, starting cold", mPath);
+        return {};
+    }
+
+    std::vector<u8> data(header.dataSize);
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())) ||
+        hash::fnv1a(data.data(), data.size()) != header.dataHash) {
+        MSG_WARN("[Vulkan] Pipeline cache {} is corrupted, starting cold", mPath);
+        return {};
+    }
+
+    // The driver's own header at the start of the data has to agree as well
+    VkPipelineCacheHeaderVersionOne driverHeader{};
+    if (data.size() < sizeof(driverHeader)) {
+        return {};
+    }
+    std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+    if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        driverHeader.vendorID != mDeviceHeader.vendorID || driverHeader.deviceID != mDeviceHeader.deviceID ||
+        !std::equal(mDeviceHeader.pipelineCacheUUID.begin(), mDeviceHeader.pipelineCacheUUID.end(),
+                    std::begin(driverHeader.pipelineCacheUUID))) {
+        MSG_WARN("[Vulkan] Pipeline cache {} does not match its driver header, starting cold", mPath);
+        return {};
+    }
+    MSG_INFO("[Vulkan] Loaded {} bytes of pipeline cache from {}", data.size(), mPath);
+    return data;
+}
\ No newline at end of file
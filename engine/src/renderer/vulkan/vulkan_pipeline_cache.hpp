@@ -0,0 +1,61 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <array>
+#include <string>
+#include <vector>
+
+class VulkanDevice;
+
+// Pipeline cache persisted between runs, so pipelines compiled by the driver once are only looked up afterwards.
+//
+// The file starts with a header of our own identifying the device and driver that wrote it and checksumming the
+// data. A file from another GPU or driver version, or a truncated or corrupted one, is discarded and the cache
+// starts empty, drivers are not trusted to reject foreign data themselves.
+//
+// Compile threads create their pipelines straight into the cache, Vulkan synchronizes pipeline caches internally.
+// Pipelines loaded from the file are found by every thread that way, and their new ones end up in the saved data.
+class VulkanPipelineCache {
+public:
+    VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+    VulkanPipelineCache(VulkanPipelineCache&&) = delete;
+    VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+    VulkanPipelineCache& operator=(VulkanPipelineCache&&) = delete;
+    // An empty path keeps the cache in memory only
+    VulkanPipelineCache(const VulkanDevice& device, std::string path);
+    ~VulkanPipelineCache();
+
+    // Pipelines still being created meanwhile may be missing from the saved data
+    bool save();
+
+    // Pipelines may be created into it from any thread without further locking
+    [[nodiscard]] const VkPipelineCache& get_handle() const {
+        return mHandle;
+    }
+    // Bytes of cache data loaded at startup, 0 on a cold start
+    [[nodiscard]] u64 get_loaded_size() const {
+        return mLoadedSize;
+    }
+
+private:
+    struct FileHeader {
+        u32 magic{0};
+        u32 version{0};
+        u64 dataSize{0};
+        u64 dataHash{0};
+        u32 vendorID{0};
+        u32 deviceID{0};
+        u32 driverVersion{0};
+        std::array<u8, VK_UUID_SIZE> pipelineCacheUUID{};
+    };
+
+    VkDevice mDevice{nullptr};
+    VkPipelineCache mHandle{nullptr};
+    FileHeader mDeviceHeader{};
+    std::string mPath;
+    u64 mLoadedSize{0};
+
+    // Empty when the file is missing or was written for another device or driver
+    [[nodiscard]] std::vector<u8> load_file() const;
+};
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "vulkan_pipeline_manager.hpp"
+#include "core/hash.hpp"
+#include "core/logger.hpp"
+#include "vulkan_pipeline.hpp"
+#include "vulkan_pipeline_cache.hpp"
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <utility>
+
+VulkanPipelineManager::VulkanPipelineManager(VkDevice device, VulkanPipelineCache& pipelineCache,
+                                             VulkanLayoutCache& layoutCache,
+                                             const VulkanPipeline::RenderTarget& target, u32 compileThreadCount)
+    : mDevice{device}, mPipelineCache{pipelineCache}, mLayoutCache{layoutCache}, mTarget{target} {
+    for (u32 i = 0; i < std::max(compileThreadCount, 1U); ++i) {
+        mCompileThreads.emplace_back(&VulkanPipelineManager::compile_thread_main, this);
+    }
+    MSG_TRACE("[Vulkan] Pipeline manager: {:p} created with {} compile threads", static_cast<void*>(this),
+              mCompileThreads.size());
+}
+
+VulkanPipelineManager::~VulkanPipelineManager() {
+    {
+        const std::scoped_lock lock{mQueueMutex};
+        mStopping = true;
+        mQueue.clear();
+    }
+    mQueueCondition.notify_all();
+    for (auto& thread : mCompileThreads) {
+        thread.join();
+    }
+    MSG_TRACE("[Vulkan] Pipeline manager: {:p} destroyed with {} pipelines", static_cast<void*>(this),
+              mEntries.size());
+}
+
+PipelineHandle VulkanPipelineManager::request(const PipelineDescription& description) {
+    PipelineDescription resolved = description;
+    for (auto* shader : {&resolved.vertexShader, &resolved.fragmentShader}) {
+        std::filesystem::path path{*shader};
+        if (path.is_relative()) {
+            path = std::filesystem::path{ENGINE_SHADER_DIR} / path;
+        }
+        if (!std::filesystem::is_regular_file(path)) {
+            MSG_ERROR("[Vulkan] Shader not found: {}", path.string());
+            return {};
+        }
+        *shader = path.string();
+    }
+
+    const u64 key = hash_description(resolved);
+    const auto [first, last] = mLookup.equal_range(key);
+    for (auto match = first; match != last; ++match) {
+        if (mEntries[match->second - 1]->description == resolved) {
+            return PipelineHandle{match->second};
+        }
+    }
+
+    auto& entry = *mEntries.emplace_back(std::make_unique<Entry>());
+    entry.description = std::move(resolved);
+    const auto id = static_cast<u32>(mEntries.size());
+    mLookup.emplace(key, id);
+    mPendingCount.fetch_add(1, std::memory_order_relaxed);
+    {
+        const std::scoped_lock lock{mQueueMutex};
+        mQueue.push_back(&entry);
+    }
+    mQueueCondition.notify_one();
+    return PipelineHandle{id};
+}
+
+const VulkanPipeline* VulkanPipelineManager::get(PipelineHandle pipeline) const {
+    if (!pipeline.is_valid() || pipeline.id > mEntries.size()) {
+        return nullptr;
+    }
+    const auto& entry = *mEntries[pipeline.id - 1];
+    return entry.state.load(std::memory_order_acquire) == State::STATE_READY ? entry.pipeline.get() : nullptr;
+}
+
+u64 VulkanPipelineManager::hash_description(const PipelineDescription& description) const {
+    u64 key = hash::fnv1a(description.vertexShader);
+    key = hash::fnv1a(description.fragmentShader, key);
+    key = hash::fnv1a_value(description.vertexLayout, key);
+    key = hash::fnv1a_value(description.topology, key);
+    key = hash::fnv1a_value(description.cullMode, key);
+    key = hash::fnv1a_value(description.blendMode, key);
+    key = hash::fnv1a_value(description.depthTest, key);
+    key = hash::fnv1a_value(description.depthWrite, key);
+    key = hash::fnv1a_value(mTarget.colorFormat, key);
+    return hash::fnv1a_value(mTarget.depthFormat, key);
+}
+
+void VulkanPipelineManager::compile_thread_main() {
+    while (true) {
+        Entry* entry{nullptr};
+        {
+            std::unique_lock lock{mQueueMutex};
+            mQueueCondition.wait(lock, [this] { return mStopping || !mQueue.empty(); });
+            if (mStopping) {
+                return;
+            }
+            entry = mQueue.front();
+            mQueue.pop_front();
+        }
+        compile(*entry);
+        mPendingCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void VulkanPipelineManager::compile(Entry& entry) {
+    try {
+        entry.pipeline = std::make_unique<VulkanPipeline>(mDevice, mPipelineCache.get_handle(), mLayoutCache, mTarget,
+                                                          entry.description);
+        entry.state.store(State::STATE_READY, std::memory_order_release);
+    } catch (const std::exception& exception) {
+        MSG_ERROR("[Vulkan] Pipeline for {} and {} failed to compile: {}", entry.description.vertexShader,
+                  entry.description.fragmentShader, exception.what());
+        entry.state.store(State::STATE_FAILED, std::memory_order_release);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "defines.hpp"
+#include "renderer/renderer_types.hpp"
+#include "vulkan/vulkan_core.h"
+#include "vulkan_pipeline.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class VulkanPipelineCache;
+class VulkanLayoutCache;
+
+// Graphics pipelines keyed by a hash of their description and the render target formats.
+//
+// Requesting a description not seen before returns its handle right away and queues the pipeline for one of the
+// compile threads, the driver's compilation never stalls the frame. Until it is ready get() returns nullptr and
+// draws fall back to another pipeline. Compile threads create into the persistent pipeline cache, so pipelines
+// loaded from disk compile warm.
+//
+// Only request() and get() are called by the renderer, which serializes them.
+class VulkanPipelineManager {
+public:
+    VulkanPipelineManager(const VulkanPipelineManager&) = delete;
+    VulkanPipelineManager(VulkanPipelineManager&&) = delete;
+    VulkanPipelineManager& operator=(const VulkanPipelineManager&) = delete;
+    VulkanPipelineManager& operator=(VulkanPipelineManager&&) = delete;
+    VulkanPipelineManager(VkDevice device, VulkanPipelineCache& pipelineCache, VulkanLayoutCache& layoutCache,
+                          const VulkanPipeline::RenderTarget& target, u32 compileThreadCount);
+    // Drops the queued compilations and waits for the running ones
+    ~VulkanPipelineManager();
+
+    // Invalid handle when a shader file does not exist, relative shader paths are resolved first
+    [[nodiscard]] PipelineHandle request(const PipelineDescription& description);
+    // nullptr while the pipeline is compiling or when its compilation failed
+    [[nodiscard]] const VulkanPipeline* get(PipelineHandle pipeline) const;
+
+    [[nodiscard]] u32 get_pending_count() const {
+        return mPendingCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    enum class State : u8 {
+        STATE_COMPILING,
+        STATE_READY,
+        STATE_FAILED
+    };
+
+    struct Entry {
+        PipelineDescription description;
+        // Written by the compile thread before the state turns ready
+        std::unique_ptr<VulkanPipeline> pipeline;
+        std::atomic<State> state{State::STATE_COMPILING};
+    };
+
+    VkDevice mDevice{nullptr};
+    VulkanPipelineCache& mPipelineCache;
+    VulkanLayoutCache& mLayoutCache;
+    VulkanPipeline::RenderTarget mTarget;
+
+    // Indexed by handle id - 1, entries keep their address for the compile threads
+    std::vector<std::unique_ptr<Entry>> mEntries;
+    // Handle ids by description hash, colliding descriptions share a hash
+    std::unordered_multimap<u64, u32> mLookup;
+    std::atomic<u32> mPendingCount{0};
+
+    std::vector<std::thread> mCompileThreads;
+    std::mutex mQueueMutex;
+    std::condition_variable mQueueCondition;
+    std::deque<Entry*> mQueue;
+    bool mStopping{false};
+
+    [[nodiscard]] u64 hash_description(const PipelineDescription& description) const;
+    void compile_thread_main();
+    void compile(Entry& entry);
+};
\ No newline at end of file
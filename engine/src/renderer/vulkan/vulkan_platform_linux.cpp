@@ -0,0 +1,25 @@
+#include "vulkan_platform.hpp"
+
+#if ENGINE_PLATFORM_LINUX
+#include "platform/platform_linux.hpp"
+#include <xcb/xcb.h>
+#include "vulkan/vulkan_xcb.h"
+
+std::vector<const char*> vulkanplatform::get_platform_extensions() {
+    std::vector<const char*> requiredExtensions{"VK_KHR_xcb_surface"};
+    return requiredExtensions;
+}
+
+VkSurfaceKHR vulkanplatform::create_platform_surface(Platform& platform, VkInstance instance) {
+    VkXcbSurfaceCreateInfoKHR surfaceCreateInfo{};
+    surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR;
+    surfaceCreateInfo.connection = dynamic_cast<LinuxState*>(platform.getState())->connection;
+    surfaceCreateInfo.window = dynamic_cast<LinuxState*>(platform.getState())->window;
+
+    VkSurfaceKHR surface{nullptr};
+
+    vkCreateXcbSurfaceKHR(instance, &surfaceCreateInfo, nullptr, &surface);
+    return surface;
+}
+
+#endif
\ No newline at end of file
@@ -20,7 +20,8 @@ RenderPass::RenderPass(VkDevice device, const VulkanSwapchain& swapchain, VkRect
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout =
+        swapchain.is_offscreen() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     VkAttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;
@@ -68,7 +69,7 @@ RenderPass::RenderPass(VkDevice device, const VulkanSwapchain& swapchain, VkRect
     MSG_INFO("[Vulkan] Successfully created renderpass: {:p}", static_cast<void*>(this));
 }
 
-void RenderPass::begin(VkFramebuffer framebuffer, VkCommandBuffer commandBuffer) {
+void RenderPass::begin(VkFramebuffer framebuffer, VkCommandBuffer commandBuffer, VkSubpassContents contents) {
     MSG_TRACE("[Vulkan] Renderpass: {:p} begin render called", static_cast<void*>(this));
     std::array<VkClearValue, 2> clearValues{};
     clearValues[0].color = mClearColor;
@@ -82,7 +83,7 @@ void RenderPass::begin(VkFramebuffer framebuffer, VkCommandBuffer commandBuffer)
     beginInfo.clearValueCount = clearValues.size();
     beginInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(commandBuffer, &beginInfo, contents);
 }
 
 void RenderPass::end(VkCommandBuffer commandBuffer) {
@@ -9,7 +9,9 @@ public:
                VkClearDepthStencilValue depthStencil);
     ~RenderPass();
 
-    void begin(VkFramebuffer framebuffer, VkCommandBuffer commandBuffer);
+    // Draws are either recorded inline or executed from secondary command buffers, never both
+    void begin(VkFramebuffer framebuffer, VkCommandBuffer commandBuffer,
+               VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
     void end(VkCommandBuffer commandBuffer);
 
     void set_render_area_extent(VkExtent2D extent) {
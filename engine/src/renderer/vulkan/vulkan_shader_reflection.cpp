@@ -0,0 +1,382 @@
+#include "vulkan_shader_reflection.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    constexpr u32 SPIRV_MAGIC = 0x07230203;
+    constexpr size_t SPIRV_HEADER_WORDS = 5;
+
+    // Opcodes, decorations and enumerants from the SPIR-V specification, only the ones reflection looks at
+    constexpr u32 OP_ENTRY_POINT = 15;
+    constexpr u32 OP_TYPE_INT = 21;
+    constexpr u32 OP_TYPE_FLOAT = 22;
+    constexpr u32 OP_TYPE_VECTOR = 23;
+    constexpr u32 OP_TYPE_MATRIX = 24;
+    constexpr u32 OP_TYPE_IMAGE = 25;
+    constexpr u32 OP_TYPE_SAMPLER = 26;
+    constexpr u32 OP_TYPE_SAMPLED_IMAGE = 27;
+    constexpr u32 OP_TYPE_ARRAY = 28;
+    constexpr u32 OP_TYPE_RUNTIME_ARRAY = 29;
+    constexpr u32 OP_TYPE_STRUCT = 30;
+    constexpr u32 OP_TYPE_POINTER = 32;
+    constexpr u32 OP_CONSTANT = 43;
+    constexpr u32 OP_VARIABLE = 59;
+    constexpr u32 OP_DECORATE = 71;
+    constexpr u32 OP_MEMBER_DECORATE = 72;
+
+    constexpr u32 DECORATION_BUFFER_BLOCK = 3;
+    constexpr u32 DECORATION_ARRAY_STRIDE = 6;
+    constexpr u32 DECORATION_MATRIX_STRIDE = 7;
+    constexpr u32 DECORATION_BUILT_IN = 11;
+    constexpr u32 DECORATION_LOCATION = 30;
+    constexpr u32 DECORATION_BINDING = 33;
+    constexpr u32 DECORATION_DESCRIPTOR_SET = 34;
+    constexpr u32 DECORATION_OFFSET = 35;
+
+    constexpr u32 STORAGE_CLASS_UNIFORM_CONSTANT = 0;
+    constexpr u32 STORAGE_CLASS_INPUT = 1;
+    constexpr u32 STORAGE_CLASS_UNIFORM = 2;
+    constexpr u32 STORAGE_CLASS_PUSH_CONSTANT = 9;
+    constexpr u32 STORAGE_CLASS_STORAGE_BUFFER = 12;
+
+    constexpr u32 EXECUTION_MODEL_VERTEX = 0;
+    constexpr u32 EXECUTION_MODEL_TESSELLATION_CONTROL = 1;
+    constexpr u32 EXECUTION_MODEL_TESSELLATION_EVALUATION = 2;
+    constexpr u32 EXECUTION_MODEL_GEOMETRY = 3;
+    constexpr u32 EXECUTION_MODEL_FRAGMENT = 4;
+    constexpr u32 EXECUTION_MODEL_GL_COMPUTE = 5;
+
+    constexpr u32 DIM_BUFFER = 5;
+    constexpr u32 DIM_SUBPASS_DATA = 6;
+    // OpTypeImage's Sampled operand, 1 for images used with a sampler, 2 for storage images
+    constexpr u32 IMAGE_SAMPLED = 1;
+    constexpr u32 IMAGE_STORAGE = 2;
+
+    // Everything known about an id, filled in over the whole module since decorations precede the types
+    struct Id {
+        u32 opcode{0};
+        // The instruction's operands after the result id
+        std::vector<u32> operands;
+        std::unordered_map<u32, u32> decorations;
+        // Offset, ArrayStride and MatrixStride of struct members by member index
+        std::unordered_map<u32, std::unordered_map<u32, u32>> memberDecorations;
+    };
+
+    class Module {
+    public:
+        explicit Module(std::span<const u32> words) {
+            if (words.size() < SPIRV_HEADER_WORDS || words[0] != SPIRV_MAGIC) {
+                throw std::runtime_error("Shader is not SPIR-V");
+            }
+            size_t offset = SPIRV_HEADER_WORDS;
+            while (offset < words.size()) {
+                const u32 wordCount = words[offset] >> 16U;
+                const u32 opcode = words[offset] & 0xFFFFU;
+                if (wordCount == 0 || offset + wordCount > words.size()) {
+                    throw std::runtime_error("SPIR-V instruction runs past the end of the shader");
+                }
+                parse_instruction(opcode, words.subspan(offset + 1, wordCount - 1));
+                offset += wordCount;
+            }
+        }
+
+        [[nodiscard]] const Id& get(u32 id) const {
+            const auto found = mIds.find(id);
+            if (found == mIds.end()) {
+                throw std::runtime_error("SPIR-V references an undefined id");
+            }
+            return found->second;
+        }
+
+        [[nodiscard]] u32 get_decoration(u32 id, u32 decoration, u32 fallback) const {
+            const auto found = mIds.find(id);
+            if (found == mIds.end()) {
+                return fallback;
+            }
+            const auto value = found->second.decorations.find(decoration);
+            return value != found->second.decorations.end() ? value->second : fallback;
+        }
+
+        [[nodiscard]] bool has_decoration(u32 id, u32 decoration) const {
+            const auto found = mIds.find(id);
+            return found != mIds.end() && found->second.decorations.contains(decoration);
+        }
+
+        [[nodiscard]] u32 get_member_decoration(u32 id, u32 member, u32 decoration) const {
+            const auto& members = get(id).memberDecorations;
+            const auto foundMember = members.find(member);
+            if (foundMember == members.end()) {
+                return 0;
+            }
+            const auto value = foundMember->second.find(decoration);
+            return value != foundMember->second.end() ? value->second : 0;
+        }
+
+        [[nodiscard]] const std::vector<u32>& get_variables() const {
+            return mVariables;
+        }
+        [[nodiscard]] bool has_entry_point() const {
+            return mHasEntryPoint;
+        }
+        [[nodiscard]] u32 get_execution_model() const {
+            return mExecutionModel;
+        }
+
+        // Byte size of a type as laid out in a block, explicit strides win over the natural size
+        [[nodiscard]] u32 get_size(u32 typeId) const {
+            const Id& type = get(typeId);
+            switch (type.opcode) {
+                case OP_TYPE_INT:
+                case OP_TYPE_FLOAT:
+                    return type.operands.at(0) / 8;
+                case OP_TYPE_VECTOR:
+                    return get_size(type.operands.at(0)) * type.operands.at(1);
+                case OP_TYPE_MATRIX:
+                    return get_size(type.operands.at(0)) * type.operands.at(1);
+                case OP_TYPE_ARRAY: {
+                    const u32 stride = get_decoration(typeId, DECORATION_ARRAY_STRIDE, 0);
+                    const u32 length = get_constant(type.operands.at(1));
+                    return (stride > 0 ? stride : get_size(type.operands.at(0))) * length;
+                }
+                case OP_TYPE_STRUCT: {
+                    u32 size = 0;
+                    for (u32 member = 0; member < type.operands.size(); ++member) {
+                        const u32 memberType = type.operands[member];
+                        u32 memberSize = get_size(memberType);
+                        // Row major matrices and the like are only sized correctly through their stride
+                        const u32 matrixStride = get_member_decoration(typeId, member, DECORATION_MATRIX_STRIDE);
+                        if (matrixStride > 0 && get(memberType).opcode == OP_TYPE_MATRIX) {
+                            memberSize = matrixStride * get(memberType).operands.at(1);
+                        }
+                        size = std::max(size, get_member_decoration(typeId, member, DECORATION_OFFSET) + memberSize);
+                    }
+                    return size;
+                }
+                default:
+                    // Runtime arrays and opaque types do not add to a block's size
+                    return 0;
+            }
+        }
+
+        [[nodiscard]] u32 get_constant(u32 id) const {
+            const Id& constant = get(id);
+            if (constant.opcode != OP_CONSTANT) {
+                throw std::runtime_error("SPIR-V array length is not a constant, specialization is unsupported");
+            }
+            return constant.operands.at(1);
+        }
+
+    private:
+        std::unordered_map<u32, Id> mIds;
+        std::vector<u32> mVariables;
+        bool mHasEntryPoint{false};
+        u32 mExecutionModel{0};
+
+        void parse_instruction(u32 opcode, std::span<const u32> operands) {
+            switch (opcode) {
+                case OP_ENTRY_POINT:
+                    // The first entry point decides the stage, modules with several are not used by the engine
+                    if (!mHasEntryPoint && !operands.empty()) {
+                        mHasEntryPoint = true;
+                        mExecutionModel = operands[0];
+                    }
+                    break;
+                case OP_DECORATE:
+                    if (operands.size() >= 2) {
+                        mIds[operands[0]].decorations[operands[1]] = operands.size() >= 3 ? operands[2] : 0;
+                    }
+                    break;
+                case OP_MEMBER_DECORATE:
+                    if (operands.size() >= 3) {
+                        mIds[operands[0]].memberDecorations[operands[1]][operands[2]] =
+                            operands.size() >= 4 ? operands[3] : 0;
+                    }
+                    break;
+                case OP_TYPE_INT:
+                case OP_TYPE_FLOAT:
+                case OP_TYPE_VECTOR:
+                case OP_TYPE_MATRIX:
+                case OP_TYPE_IMAGE:
+                case OP_TYPE_SAMPLER:
+                case OP_TYPE_SAMPLED_IMAGE:
+                case OP_TYPE_ARRAY:
+                case OP_TYPE_RUNTIME_ARRAY:
+                case OP_TYPE_STRUCT:
+                case OP_TYPE_POINTER:
+                    if (!operands.empty()) {
+                        define(operands[0], opcode, operands.subspan(1));
+                    }
+                    break;
+                case OP_CONSTANT:
+                case OP_VARIABLE:
+                    // Result type first, the result id second
+                    if (operands.size() >= 2) {
+                        Id& id = define(operands[1], opcode, operands.subspan(2));
+                        id.operands.insert(id.operands.begin(), operands[0]);
+                        if (opcode == OP_VARIABLE) {
+                            mVariables.push_back(operands[1]);
+                        }
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        Id& define(u32 id, u32 opcode, std::span<const u32> operands) {
+            Id& entry = mIds[id];
+            entry.opcode = opcode;
+            entry.operands.assign(operands.begin(), operands.end());
+            return entry;
+        }
+    };
+
+    VkShaderStageFlagBits to_vulkan_stage(u32 executionModel) {
+        switch (executionModel) {
+            case EXECUTION_MODEL_VERTEX:
+                return VK_SHADER_STAGE_VERTEX_BIT;
+            case EXECUTION_MODEL_TESSELLATION_CONTROL:
+                return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case EXECUTION_MODEL_TESSELLATION_EVALUATION:
+                return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case EXECUTION_MODEL_GEOMETRY:
+                return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case EXECUTION_MODEL_FRAGMENT:
+                return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case EXECUTION_MODEL_GL_COMPUTE:
+                return VK_SHADER_STAGE_COMPUTE_BIT;
+            default:
+                throw std::runtime_error("SPIR-V entry point has an unsupported execution model");
+        }
+    }
+
+    VkDescriptorType to_descriptor_type(const Module& module, u32 storageClass, u32 typeId) {
+        const Id& type = module.get(typeId);
+        if (storageClass == STORAGE_CLASS_STORAGE_BUFFER) {
+            return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        }
+        if (storageClass == STORAGE_CLASS_UNIFORM) {
+            // Older compilers mark storage buffers as BufferBlock in the Uniform storage class
+            return module.has_decoration(typeId, DECORATION_BUFFER_BLOCK) ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+                                                                           : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        }
+        switch (type.opcode) {
+            case OP_TYPE_SAMPLER:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case OP_TYPE_SAMPLED_IMAGE:
+                return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            case OP_TYPE_IMAGE: {
+                // Sampled type, dim, depth, arrayed, multisampled, sampled, format
+                const u32 dim = type.operands.at(1);
+                const u32 sampled = type.operands.at(5);
+                if (dim == DIM_SUBPASS_DATA) {
+                    return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                }
+                if (dim == DIM_BUFFER) {
+                    return sampled == IMAGE_STORAGE ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                                                    : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                }
+                return sampled == IMAGE_SAMPLED ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            }
+            default:
+                throw std::runtime_error("SPIR-V resource has an unsupported type");
+        }
+    }
+
+    VkFormat to_vertex_format(const Module& module, u32 typeId) {
+        const Id& type = module.get(typeId);
+        u32 componentCount = 1;
+        const Id* component = &type;
+        if (type.opcode == OP_TYPE_VECTOR) {
+            componentCount = type.operands.at(1);
+            component = &module.get(type.operands.at(0));
+        }
+        if ((component->opcode != OP_TYPE_FLOAT && component->opcode != OP_TYPE_INT) ||
+            component->operands.at(0) != 32 || componentCount < 1 || componentCount > 4) {
+            throw std::runtime_error("SPIR-V vertex input has an unsupported type");
+        }
+        if (component->opcode == OP_TYPE_FLOAT) {
+            constexpr std::array formats{VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT,
+                                         VK_FORMAT_R32G32B32A32_SFLOAT};
+            return formats[componentCount - 1];
+        }
+        if (component->operands.at(1) != 0) {
+            constexpr std::array formats{VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT,
+                                         VK_FORMAT_R32G32B32A32_SINT};
+            return formats[componentCount - 1];
+        }
+        constexpr std::array formats{VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT,
+                                     VK_FORMAT_R32G32B32A32_UINT};
+        return formats[componentCount - 1];
+    }
+}  // namespace
+
+VulkanShaderReflection::VulkanShaderReflection(std::span<const char> code) {
+    if (code.size() % sizeof(u32) != 0) {
+        throw std::runtime_error("SPIR-V size is not a multiple of its word size");
+    }
+    // Shader files are read into char buffers, copying keeps the words aligned
+    std::vector<u32> words(code.size() / sizeof(u32));
+    std::memcpy(words.data(), code.data(), code.size());
+    const Module module{words};
+    if (!module.has_entry_point()) {
+        throw std::runtime_error("SPIR-V has no entry point");
+    }
+    mStage = to_vulkan_stage(module.get_execution_model());
+
+    for (const u32 variableId : module.get_variables()) {
+        const Id& variable = module.get(variableId);
+        const u32 storageClass = variable.operands.at(1);
+        const Id& pointer = module.get(variable.operands.at(0));
+        if (pointer.opcode != OP_TYPE_POINTER) {
+            throw std::runtime_error("SPIR-V variable is not a pointer");
+        }
+        const u32 typeId = pointer.operands.at(1);
+
+        switch (storageClass) {
+            case STORAGE_CLASS_UNIFORM_CONSTANT:
+            case STORAGE_CLASS_UNIFORM:
+            case STORAGE_CLASS_STORAGE_BUFFER: {
+                Binding binding{};
+                binding.set = module.get_decoration(variableId, DECORATION_DESCRIPTOR_SET, 0);
+                binding.binding = module.get_decoration(variableId, DECORATION_BINDING, 0);
+                u32 elementType = typeId;
+                const Id& type = module.get(typeId);
+                if (type.opcode == OP_TYPE_ARRAY) {
+                    binding.count = module.get_constant(type.operands.at(1));
+                    elementType = type.operands.at(0);
+                } else if (type.opcode == OP_TYPE_RUNTIME_ARRAY) {
+                    binding.count = 0;
+                    elementType = type.operands.at(0);
+                }
+                binding.type = to_descriptor_type(module, storageClass, elementType);
+                mBindings.push_back(binding);
+                break;
+            }
+            case STORAGE_CLASS_PUSH_CONSTANT:
+                mPushConstantSize = std::max(mPushConstantSize, module.get_size(typeId));
+                break;
+            case STORAGE_CLASS_INPUT:
+                // Built-ins like gl_VertexIndex are not fed by vertex buffers, neither are block members
+                if (mStage == VK_SHADER_STAGE_VERTEX_BIT && !module.has_decoration(variableId, DECORATION_BUILT_IN) &&
+                    module.has_decoration(variableId, DECORATION_LOCATION)) {
+                    mVertexInputs.push_back(VertexInput{module.get_decoration(variableId, DECORATION_LOCATION, 0),
+                                                        to_vertex_format(module, typeId)});
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::ranges::sort(mBindings, [](const Binding& left, const Binding& right) {
+        return left.set != right.set ? left.set < right.set : left.binding < right.binding;
+    });
+    std::ranges::sort(mVertexInputs, {}, &VertexInput::location);
+    MSG_TRACE("[Vulkan] Shader reflection: stage {}, {} bindings, {} push constant bytes, {} vertex inputs",
+              static_cast<u32>(mStage), mBindings.size(), mPushConstantSize, mVertexInputs.size());
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <span>
+#include <vector>
+
+// Descriptor bindings, push constants and vertex inputs a SPIR-V module declares, read straight from its
+// instructions so layouts can never drift from the shaders they are created for.
+//
+// Only the parts of SPIR-V needed for layouts are understood: resources are described by the types of their
+// variables and the Binding, DescriptorSet, Location and Offset decorations.
+class VulkanShaderReflection {
+public:
+    struct Binding {
+        u32 set{0};
+        u32 binding{0};
+        VkDescriptorType type{VK_DESCRIPTOR_TYPE_MAX_ENUM};
+        // 0 for runtime arrays, their size is chosen by whoever creates the layout
+        u32 count{1};
+    };
+
+    struct VertexInput {
+        u32 location{0};
+        VkFormat format{VK_FORMAT_UNDEFINED};
+    };
+
+    // Throws when the code is not valid SPIR-V or has no entry point
+    explicit VulkanShaderReflection(std::span<const char> code);
+
+    [[nodiscard]] VkShaderStageFlagBits get_stage() const {
+        return mStage;
+    }
+    // Sorted by set, then binding
+    [[nodiscard]] const std::vector<Binding>& get_bindings() const {
+        return mBindings;
+    }
+    // End of the last push constant member the shader declares, 0 without push constants
+    [[nodiscard]] u32 get_push_constant_size() const {
+        return mPushConstantSize;
+    }
+    // Vertex stage only, sorted by location
+    [[nodiscard]] const std::vector<VertexInput>& get_vertex_inputs() const {
+        return mVertexInputs;
+    }
+
+private:
+    VkShaderStageFlagBits mStage{VK_SHADER_STAGE_ALL};
+    std::vector<Binding> mBindings;
+    u32 mPushConstantSize{0};
+    std::vector<VertexInput> mVertexInputs;
+};
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "vulkan_staging_ring.hpp"
+#include "core/logger.hpp"
+#include "vulkan_buffer.hpp"
+#include "vulkan_defines.inl"
+#include "vulkan_timeline_semaphore.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace {
+    // Uploaded buffers are read by draws as vertices, indices or draw resources
+    constexpr VkPipelineStageFlags DRAW_READ_STAGES = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    constexpr VkAccessFlags DRAW_READ_ACCESS = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+        VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+}  // namespace
+
+VulkanStagingRing::VulkanStagingRing(VulkanDevice& device, VkDeviceSize capacity)
+    : mBuffer{std::make_unique<VulkanBuffer>(device, capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)},
+      mMapped{static_cast<u8*>(mBuffer->get_mapped())}, mCapacity{capacity} {
+    MSG_TRACE("[Vulkan] Staging ring: {:p} created with {} bytes", static_cast<void*>(this), mCapacity);
+}
+
+VulkanStagingRing::~VulkanStagingRing() {
+    if (!mPendingCopies.empty()) {
+        MSG_WARN("[Vulkan] Staging ring destroyed with {} copies never submitted", mPendingCopies.size());
+    }
+    MSG_TRACE("[Vulkan] Staging ring: {:p} destroyed", static_cast<void*>(this));
+}
+
+bool VulkanStagingRing::stage(const VulkanBuffer& destination, VkDeviceSize destinationOffset, const void* data,
+                              VkDeviceSize size) {
+    if (size > get_max_upload_size()) {
+        return false;
+    }
+    const VkDeviceSize position = mHead % mCapacity;
+    VkDeviceSize start = (position + COPY_ALIGNMENT - 1) & ~(COPY_ALIGNMENT - 1);
+    // An upload never wraps, the end of the ring is skipped instead
+    if (start + size > mCapacity) {
+        start = 0;
+    }
+    const VkDeviceSize consumed = (start >= position ? start - position : mCapacity - position + start) + size;
+    if (mHead + consumed - mTail > mCapacity) {
+        return false;
+    }
+    mHead += consumed;
+
+    std::memcpy(mMapped + start, data, size);
+    const VkBuffer handle = destination.get_handle();
+    const bool needsBarrier = track_write(handle, destinationOffset, size);
+    mPendingCopies.push_back({handle, VkBufferCopy{start, destinationOffset, size}, needsBarrier});
+    return true;
+}
+
+bool VulkanStagingRing::track_write(VkBuffer destination, VkDeviceSize offset, VkDeviceSize size) {
+    auto& ranges = mWrittenRanges[destination];
+    const VkDeviceSize end = offset + size;
+    // The ranges are disjoint, only the last one starting before the end can reach into the write
+    auto next = ranges.lower_bound(end);
+    const bool overlaps = next != ranges.begin() && std::prev(next)->second > offset;
+    if (overlaps) {
+        // The barrier orders the write after every copy before it, on all destinations
+        mWrittenRanges.clear();
+        mWrittenRanges[destination].emplace(offset, end);
+    } else {
+        ranges.emplace_hint(next, offset, end);
+    }
+    return overlaps;
+}
+
+u64 VulkanStagingRing::record_copies(VkCommandBuffer commandBuffer) {
+    if (mPendingCopies.empty()) {
+        return mRecordedHead;
+    }
+    // Execution dependency only, nothing written by the reads before needs to be made visible
+    vkCmdPipelineBarrier(commandBuffer, DRAW_READ_STAGES, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0,
+                         nullptr);
+    record_copy_commands(commandBuffer);
+
+    VkMemoryBarrier readBarrier{};
+    readBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    readBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    readBarrier.dstAccessMask = DRAW_READ_ACCESS;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, DRAW_READ_STAGES, 0, 1, &readBarrier, 0,
+                         nullptr, 0, nullptr);
+    return finish_recording();
+}
+
+u64 VulkanStagingRing::record_copies_for_queue(VkCommandBuffer commandBuffer) {
+    if (mPendingCopies.empty()) {
+        return mRecordedHead;
+    }
+    // Copies of earlier submissions to the queue may have written the same ranges
+    VkMemoryBarrier transferBarrier{};
+    transferBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    transferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    transferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1,
+                         &transferBarrier, 0, nullptr, 0, nullptr);
+    record_copy_commands(commandBuffer);
+    return finish_recording();
+}
+
+void VulkanStagingRing::record_copy_commands(VkCommandBuffer commandBuffer) const {
+    VkMemoryBarrier transferBarrier{};
+    transferBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    transferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    transferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    for (const auto& copy : mPendingCopies) {
+        if (copy.needsBarrier) {
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1,
+                                 &transferBarrier, 0, nullptr, 0, nullptr);
+        }
+        vkCmdCopyBuffer(commandBuffer, mBuffer->get_handle(), copy.destination, 1, &copy.region);
+    }
+}
+
+u64 VulkanStagingRing::finish_recording() {
+    mPendingCopies.clear();
+    mWrittenRanges.clear();
+    mRetirements.push_back({0, mHead});
+    mRecordedHead = mHead;
+    return mHead;
+}
+
+void VulkanStagingRing::retire(u64 head, u64 submitValue) {
+    // Recordings may be submitted out of order, a frame's command buffer goes after the uploads flushed during it
+    const auto retirement =
+        std::ranges::find_if(mRetirements, [head](const Retirement& entry) { return entry.head == head; });
+    if (retirement != mRetirements.end() && retirement->submitValue == 0) {
+        retirement->submitValue = submitValue;
+    }
+}
+
+void VulkanStagingRing::reclaim(VulkanTimelineSemaphore& timeline) {
+    while (!mRetirements.empty() && mRetirements.front().submitValue != 0 &&
+           timeline.is_complete(mRetirements.front().submitValue)) {
+        mTail = mRetirements.front().head;
+        mRetirements.pop_front();
+    }
+}
+
+bool VulkanStagingRing::wait_for_space(VulkanTimelineSemaphore& timeline, size_t timeoutNs) {
+    if (mRetirements.empty() || mRetirements.front().submitValue == 0 ||
+        !timeline.wait(mRetirements.front().submitValue, timeoutNs)) {
+        return false;
+    }
+    reclaim(timeline);
+    return true;
+}
\ No newline at end of file
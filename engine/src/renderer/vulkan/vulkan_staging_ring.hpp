@@ -0,0 +1,97 @@
+#pragma once
+
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class VulkanDevice;
+class VulkanBuffer;
+class VulkanTimelineSemaphore;
+
+// Persistently mapped staging memory used as a ring, uploads are copied in and their buffer copies batched until
+// the next submission records them. Space is reclaimed once the timeline value of the submission carrying its
+// copies has been reached, no upload ever waits for a queue to idle.
+class VulkanStagingRing {
+public:
+    VulkanStagingRing(const VulkanStagingRing&) = delete;
+    VulkanStagingRing(VulkanStagingRing&&) = delete;
+    VulkanStagingRing& operator=(const VulkanStagingRing&) = delete;
+    VulkanStagingRing& operator=(VulkanStagingRing&&) = delete;
+    VulkanStagingRing(VulkanDevice& device, VkDeviceSize capacity);
+    ~VulkanStagingRing();
+
+    // Copies the data into the ring and queues a copy into the destination.
+    // Returns false without side effects when the ring has no room, reclaim or wait for space and retry.
+    // Larger uploads than get_max_upload_size() have to be split
+    [[nodiscard]] bool stage(const VulkanBuffer& destination, VkDeviceSize destinationOffset, const void* data,
+                             VkDeviceSize size);
+
+    [[nodiscard]] bool has_pending_copies() const {
+        return !mPendingCopies.empty();
+    }
+    // Records the queued copies, followed by a barrier making them visible to vertex input and shaders.
+    // Earlier reads of the destinations on the same queue finish before the copies overwrite them.
+    // Returns the head covered by the recording, to retire() it with the submission carrying the command buffer
+    u64 record_copies(VkCommandBuffer commandBuffer);
+    // Records the queued copies on a queue of its own, semaphores order them against the queue reading the
+    // destinations. Destinations have to be shared with that queue's family, no ownership is transferred
+    u64 record_copies_for_queue(VkCommandBuffer commandBuffer);
+    // The space up to a head returned by a recording is released once the timeline reaches the value. Uploads
+    // staged after the recording stay until a later recording is retired
+    void retire(u64 head, u64 submitValue);
+
+    // Releases the space of every submission the timeline has completed
+    void reclaim(VulkanTimelineSemaphore& timeline);
+    // Blocks until the oldest recording's submission has completed, false when it is not retired yet or nothing
+    // is outstanding
+    bool wait_for_space(VulkanTimelineSemaphore& timeline, size_t timeoutNs);
+
+    [[nodiscard]] VkDeviceSize get_capacity() const {
+        return mCapacity;
+    }
+    // Every upload up to this size fits once the ring is drained
+    [[nodiscard]] VkDeviceSize get_max_upload_size() const {
+        return mCapacity / 2;
+    }
+
+private:
+    struct PendingCopy {
+        VkBuffer destination{VK_NULL_HANDLE};
+        VkBufferCopy region{};
+        // Writes overlapping a range written since the last barrier need a barrier in between
+        bool needsBarrier{false};
+    };
+    // Start to end of the ranges of a destination written since the last barrier, they never overlap
+    using WrittenRanges = std::map<VkDeviceSize, VkDeviceSize>;
+
+    struct Retirement {
+        // Zero until the recording is submitted, timeline values start at one
+        u64 submitValue{0};
+        u64 head{0};
+    };
+
+    static constexpr VkDeviceSize COPY_ALIGNMENT = 16;
+
+    std::unique_ptr<VulkanBuffer> mBuffer;
+    u8* mMapped{nullptr};
+    VkDeviceSize mCapacity{0};
+    // Total bytes ever allocated and released, the ring position is the value modulo the capacity
+    u64 mHead{0};
+    u64 mTail{0};
+    // Head at the last recording, later allocations are copied by the next one
+    u64 mRecordedHead{0};
+    // One per recording in recording order, the space is only released in that order
+    std::deque<Retirement> mRetirements;
+    std::vector<PendingCopy> mPendingCopies;
+    // Keyed by destination, cleared along with the pending copies and by every barrier between them
+    std::unordered_map<VkBuffer, WrittenRanges> mWrittenRanges;
+
+    // Tracks the written range, true when the copy has to wait for the copies before
+    bool track_write(VkBuffer destination, VkDeviceSize offset, VkDeviceSize size);
+    void record_copy_commands(VkCommandBuffer commandBuffer) const;
+    u64 finish_recording();
+};
\ No newline at end of file
@@ -8,14 +8,20 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
 
 
-VulkanSwapchain::VulkanSwapchain(VulkanDevice& device, uint32_t width, uint32_t height) : mDevice{&device} {
+VulkanSwapchain::VulkanSwapchain(VulkanDevice& device, uint32_t width, uint32_t height)
+    : mDevice{&device}, mOffscreen{device.is_headless()} {
     create(width, height);
 };
 
 void VulkanSwapchain::create(uint32_t width, uint32_t height) {
+    if (mOffscreen) {
+        create_offscreen_images(width, height);
+        return;
+    }
     const auto swapChainSupport = mDevice->get_swapchain_support_details();
     mImageFormat = choose_swap_surface_format(swapChainSupport.formats);
     mPresentMode = choose_swap_present_mode(swapChainSupport.presentModes);
@@ -60,7 +66,7 @@ void VulkanSwapchain::create(uint32_t width, uint32_t height) {
 
     createInfo.oldSwapchain = VK_NULL_HANDLE;
 
-    VK_CHECK(vkCreateSwapchainKHR(logicalDevice, &createInfo, nullptr, &mHandle) != VK_SUCCESS);
+    VK_CHECK(vkCreateSwapchainKHR(logicalDevice, &createInfo, nullptr, &mHandle));
 
     // Set swapchain images TODO: Refactor
 
@@ -89,7 +95,35 @@ void VulkanSwapchain::create(uint32_t width, uint32_t height) {
         VK_CHECK(vkCreateImageView(mDevice->get_logical_device(), &viewInfo, nullptr, &mViews[i]));
     }
 
-    // Depth resources
+    create_depth_attachment();
+    MSG_INFO("[Vulkan] Swapchain: {:p} successfully created", static_cast<void*>(this));
+}
+
+void VulkanSwapchain::create_offscreen_images(uint32_t width, uint32_t height) {
+    mImageFormat = {VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+    mImageExtent = {width, height};
+    mImageCount = OFFSCREEN_IMAGE_COUNT;
+    mNextOffscreenImage = 0;
+
+    mImages.resize(mImageCount);
+    mViews.resize(mImageCount);
+    mOffscreenImages.clear();
+    mOffscreenImages.reserve(mImageCount);
+    for (uint32_t i = 0; i < mImageCount; ++i) {
+        // Transfer source so frames can be read back for captures and image comparisons
+        const auto& image = mOffscreenImages.emplace_back(std::make_unique<VulkanImage>(
+            *mDevice, mImageExtent.width, mImageExtent.height, mImageFormat.format, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            VK_IMAGE_ASPECT_COLOR_BIT));
+        mImages[i] = image->get_handle();
+        mViews[i] = image->get_view();
+    }
+
+    create_depth_attachment();
+    MSG_INFO("[Vulkan] Offscreen swapchain: {:p} successfully created", static_cast<void*>(this));
+}
+
+void VulkanSwapchain::create_depth_attachment() {
     VkFormat depthFormat = mDevice->get_depth_format();
 
     VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -97,8 +131,7 @@ void VulkanSwapchain::create(uint32_t width, uint32_t height) {
     VkMemoryPropertyFlags memoryFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
     mDepthAttachment = std::make_unique<VulkanImage>(*mDevice, mImageExtent.width, mImageExtent.height, depthFormat,
-                                                     tiling, usageFlags, memoryFlags);
-    MSG_INFO("[Vulkan] Swapchain: {:p} successfully created", static_cast<void*>(this));
+                                                     tiling, usageFlags, memoryFlags, VK_IMAGE_ASPECT_DEPTH_BIT);
 }
 
 VulkanSwapchain::~VulkanSwapchain() {
@@ -106,6 +139,11 @@ VulkanSwapchain::~VulkanSwapchain() {
 };
 
 void VulkanSwapchain::destroy() {
+    if (mOffscreen) {
+        // Views are owned by the offscreen images
+        mOffscreenImages.clear();
+        return;
+    }
     for (auto const& imageView : mViews) {
         vkDestroyImageView(mDevice->get_logical_device(), imageView, nullptr);
     }
@@ -119,6 +157,11 @@ void VulkanSwapchain::recreate(uint32_t width, uint32_t height) {
 
 bool VulkanSwapchain::acquire_next_image_index(size_t timeout_ns, VkSemaphore imageAvailable, VkFence imageFence,
                                                uint32_t& outImageIndex) {
+    if (mOffscreen) {
+        outImageIndex = mNextOffscreenImage;
+        mNextOffscreenImage = (mNextOffscreenImage + 1) % mImageCount;
+        return true;
+    }
     VkResult result = vkAcquireNextImageKHR(mDevice->get_logical_device(), mHandle, timeout_ns, imageAvailable,
                                             imageFence, &outImageIndex);
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
@@ -137,6 +180,9 @@ const VkFormat& VulkanSwapchain::get_image_depth_format() const {
 }
 
 VkResult VulkanSwapchain::present(VkQueue presentQueue, uint32_t presentImageIndex, VkSemaphore renderComplete) {
+    if (mOffscreen) {
+        return VK_SUCCESS;
+    }
     VkPresentInfoKHR presentInfo;
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
@@ -184,4 +230,8 @@ VkExtent2D VulkanSwapchain::choose_swap_extent(VkSurfaceCapabilitiesKHR capabili
 
 VkImageView VulkanSwapchain::get_depth_view() const {
     return mDepthAttachment->get_view();
+}
+
+VkImage VulkanSwapchain::get_depth_image() const {
+    return mDepthAttachment->get_handle();
 }
\ No newline at end of file
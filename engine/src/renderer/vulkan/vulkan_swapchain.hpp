@@ -28,16 +28,21 @@ public:
         return mImageCount;
     };
 
-    [[nodiscard]] const size_t& get_max_frames_inflight() const {
-        return mMaxFramesInFlight;
-    };
     [[nodiscard]] VkExtent2D get_image_extent() const {
         return mImageExtent;
     };
     [[nodiscard]] VkImageView get_image_view(size_t index) const {
         return mViews.at(index);
     };
+    [[nodiscard]] VkImage get_image(size_t index) const {
+        return mImages.at(index);
+    };
     [[nodiscard]] VkImageView get_depth_view() const;
+    [[nodiscard]] VkImage get_depth_image() const;
+    // Headless devices render into plain images instead of presentable surface images
+    [[nodiscard]] bool is_offscreen() const {
+        return mOffscreen;
+    }
 
     [[nodiscard]] VkResult present(VkQueue presentQueue, uint32_t presentImageIndex, VkSemaphore renderComplete);
 
@@ -52,12 +57,18 @@ private:
     std::vector<VkImage> mImages;
     std::vector<VkImageView> mViews;
 
-    size_t mMaxFramesInFlight{2};
     VkPresentModeKHR mPresentMode{};
 
     std::unique_ptr<VulkanImage> mDepthAttachment{nullptr};
 
+    static constexpr uint32_t OFFSCREEN_IMAGE_COUNT = 3;
+    bool mOffscreen{false};
+    std::vector<std::unique_ptr<VulkanImage>> mOffscreenImages;
+    uint32_t mNextOffscreenImage{0};
+
     void create(uint32_t width, uint32_t height);
+    void create_offscreen_images(uint32_t width, uint32_t height);
+    void create_depth_attachment();
     void destroy();
     VkSurfaceFormatKHR choose_swap_surface_format(std::vector<VkSurfaceFormatKHR> formats);
     VkPresentModeKHR choose_swap_present_mode(std::vector<VkPresentModeKHR> presentModes);
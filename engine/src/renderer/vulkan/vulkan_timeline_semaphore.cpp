@@ -0,0 +1,72 @@
+#include "vulkan_timeline_semaphore.hpp"
+#include "core/logger.hpp"
+#include "vulkan_defines.inl"
+
+VulkanTimelineSemaphore::VulkanTimelineSemaphore(const VkDevice device) : mDevice{device} {
+    VkSemaphoreTypeCreateInfo typeCreateInfo{};
+    typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeCreateInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreCreateInfo{};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCreateInfo.pNext = &typeCreateInfo;
+    VK_CHECK(vkCreateSemaphore(mDevice, &semaphoreCreateInfo, nullptr, &mHandle));
+    MSG_INFO("[Vulkan] Timeline semaphore: {:p} created", static_cast<void*>(this));
+}
+
+VulkanTimelineSemaphore::~VulkanTimelineSemaphore() {
+    if (mHandle != nullptr) {
+        vkDestroySemaphore(mDevice, mHandle, nullptr);
+    }
+    MSG_INFO("[Vulkan] Timeline semaphore: {:p} destroyed", static_cast<void*>(this));
+}
+
+bool VulkanTimelineSemaphore::is_complete(u64 value) {
+    return value <= mCompletedValue || value <= get_completed_value();
+}
+
+u64 VulkanTimelineSemaphore::get_completed_value() {
+    u64 value{0};
+    if (vkGetSemaphoreCounterValue(mDevice, mHandle, &value) != VK_SUCCESS) {
+        MSG_ERROR("[Vulkan] Timeline semaphore counter query failed");
+        return mCompletedValue;
+    }
+    mCompletedValue = value;
+    return mCompletedValue;
+}
+
+bool VulkanTimelineSemaphore::wait(u64 value, size_t timeoutNs) {
+    if (value <= mCompletedValue) {
+        return true;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &mHandle;
+    waitInfo.pValues = &value;
+
+    VkResult result = vkWaitSemaphores(mDevice, &waitInfo, timeoutNs);
+    switch (result) {
+        case VK_SUCCESS:
+            mCompletedValue = value;
+            return true;
+        case VK_TIMEOUT:
+            MSG_WARN("vk_timeline_wait - Timed out waiting for value {}", value);
+            break;
+        case VK_ERROR_DEVICE_LOST:
+            MSG_ERROR("vk_timeline_wait - VK_ERROR_DEVICE_LOST.");
+            break;
+        case VK_ERROR_OUT_OF_HOST_MEMORY:
+            MSG_ERROR("vk_timeline_wait - VK_ERROR_OUT_OF_HOST_MEMORY.");
+            break;
+        case VK_ERROR_OUT_OF_DEVICE_MEMORY:
+            MSG_ERROR("vk_timeline_wait - VK_ERROR_OUT_OF_DEVICE_MEMORY.");
+            break;
+        default:
+            MSG_ERROR("vk_timeline_wait - An unknown error has occurred.");
+            break;
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include "defines.hpp"
+#include "vulkan/vulkan_core.h"
+
+// Timeline semaphore of one queue, every submission to the queue signals the next value.
+// Work submitted with value N has completed once the counter reached N, so CPU waits, reuse checks and
+// deferred deletion all reduce to comparing against a submission's value.
+class VulkanTimelineSemaphore {
+public:
+    VulkanTimelineSemaphore(const VulkanTimelineSemaphore&) = delete;
+    VulkanTimelineSemaphore(VulkanTimelineSemaphore&&) = delete;
+    VulkanTimelineSemaphore& operator=(const VulkanTimelineSemaphore&) = delete;
+    VulkanTimelineSemaphore& operator=(VulkanTimelineSemaphore&&) = delete;
+    explicit VulkanTimelineSemaphore(VkDevice device);
+    ~VulkanTimelineSemaphore();
+
+    // Value for the next submission to signal, submissions must signal their values in order
+    [[nodiscard]] u64 advance() {
+        return ++mPendingValue;
+    }
+    // Value of the last submission, waiting on it waits for the queue to drain
+    [[nodiscard]] u64 get_pending_value() const {
+        return mPendingValue;
+    }
+    // Only queries the device when the last known counter does not cover the value yet
+    [[nodiscard]] bool is_complete(u64 value);
+    [[nodiscard]] u64 get_completed_value();
+    bool wait(u64 value, size_t timeoutNs);
+
+    [[nodiscard]] const VkSemaphore& get_handle() const {
+        return mHandle;
+    };
+
+private:
+    VkSemaphore mHandle{nullptr};
+    VkDevice mDevice{nullptr};
+    u64 mPendingValue{0};
+    u64 mCompletedValue{0};
+};
\ No newline at end of file
@@ -11,7 +11,7 @@ namespace GameFunctions {
     bool update(double /*unused*/) {
         return true;
     };
-    bool render(double /*unused*/) {
+    bool render(double /*unused*/, RenderPacket& /*unused*/) {
         return true;
     };
     void on_resize(short /*unused*/, short /*unused*/) {
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <algorithm>
+#include <defines.hpp>
+#include <headless_game.hpp>
+#include <vector>
+
+// Helpers of the renderer tests, their games come from make_headless_game()
+
+// The first frames include startup costs
+constexpr u64 WARMUP_FRAMES = 10;
+
+// Sorts the values
+inline f64 median(std::vector<f64>& values) {
+    std::ranges::sort(values);
+    return values[values.size() / 2];
+}
@@ -0,0 +1,147 @@
+#include "headless_test.hpp"
+#include <entry.hpp>
+#include <renderer/renderer.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// Requests a hundred pipeline variants while drawing with them. Fails when no variant is pending right after its
+// request or drawn with the builtin pipeline meanwhile, which means they are compiled on the frame. Also fails
+// when frames requesting variants are much slower than those without, or when a variant never becomes ready.
+
+namespace {
+    constexpr u64 IDLE_FRAMES = 60;
+    constexpr u32 VARIANTS_PER_FRAME = 4;
+    // Frames after the last request the compile threads get to finish, headless frames are not paced so this
+    // leaves a software driver seconds
+    constexpr u64 COMPILE_FRAMES = 2000;
+    // Compile threads compete with the frame for the CPU, but compiling on the frame costs every requesting frame
+    // at least a compile per variant. Medians keep single hitches of a shared machine out
+    constexpr f64 MAX_REQUEST_FRAME_RATIO = 4.0;
+
+    constexpr std::array TOPOLOGIES{PrimitiveTopology::PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+                                    PrimitiveTopology::PRIMITIVE_TOPOLOGY_LINE_LIST,
+                                    PrimitiveTopology::PRIMITIVE_TOPOLOGY_POINT_LIST};
+    constexpr std::array CULL_MODES{CullMode::CULL_MODE_NONE, CullMode::CULL_MODE_BACK, CullMode::CULL_MODE_FRONT};
+    constexpr std::array BLEND_MODES{BlendMode::BLEND_MODE_OPAQUE, BlendMode::BLEND_MODE_ALPHA,
+                                     BlendMode::BLEND_MODE_ADDITIVE};
+    // Every combination of the above, with and without depth test and depth write
+    constexpr u64 VARIANT_COUNT = TOPOLOGIES.size() * CULL_MODES.size() * BLEND_MODES.size() * 4;
+    constexpr u64 REQUEST_FRAMES = (VARIANT_COUNT + VARIANTS_PER_FRAME - 1) / VARIANTS_PER_FRAME;
+
+    Game* sGame{nullptr};
+    BufferHandle sVertexBuffer{};
+    std::vector<PipelineDescription> sDescriptions;
+    std::vector<PipelineHandle> sPipelines;
+    std::vector<f64> sIdleFrameTimes;
+    std::vector<f64> sRequestFrameTimes;
+    // Variants not ready right after their request, all of them unless compiled on the frame
+    u64 sPendingAfterRequest{0};
+    u64 sFrame{0};
+
+    bool initialize() {
+        const std::array<Vertex, 6> vertices{Vertex{{-0.5F, -0.5F, 0.0F}, {1.0F, 0.0F, 0.0F, 1.0F}},
+                                             Vertex{{0.5F, -0.5F, 0.0F}, {0.0F, 1.0F, 0.0F, 1.0F}},
+                                             Vertex{{0.0F, 0.5F, 0.0F}, {0.0F, 0.0F, 1.0F, 1.0F}},
+                                             Vertex{{-0.5F, 0.5F, 0.5F}, {1.0F, 1.0F, 0.0F, 0.5F}},
+                                             Vertex{{0.5F, 0.5F, 0.5F}, {0.0F, 1.0F, 1.0F, 0.5F}},
+                                             Vertex{{0.0F, -0.5F, 0.5F}, {1.0F, 0.0F, 1.0F, 0.5F}}};
+        sVertexBuffer = sGame->mRenderer->create_buffer(BufferUsage::BUFFER_USAGE_VERTEX, sizeof(vertices));
+        if (!sVertexBuffer.is_valid() ||
+            !sGame->mRenderer->upload_buffer(sVertexBuffer, vertices.data(), sizeof(vertices))) {
+            return false;
+        }
+        for (const auto topology : TOPOLOGIES) {
+            for (const auto cullMode : CULL_MODES) {
+                for (const auto blendMode : BLEND_MODES) {
+                    for (const bool depthTest : {false, true}) {
+                        for (const bool depthWrite : {false, true}) {
+                            PipelineDescription description{};
+                            description.topology = topology;
+                            description.cullMode = cullMode;
+                            description.blendMode = blendMode;
+                            description.depthTest = depthTest;
+                            description.depthWrite = depthWrite;
+                            sDescriptions.push_back(description);
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool check_results() {
+        const auto ready = static_cast<u64>(std::ranges::count_if(
+            sPipelines, [](PipelineHandle pipeline) { return sGame->mRenderer->is_pipeline_ready(pipeline); }));
+        const u64 fallbackDraws = sGame->mRenderer->get_statistics().fallbackDraws;
+        const f64 idleMedian = median(sIdleFrameTimes);
+        const f64 requestMedian = median(sRequestFrameTimes);
+        MSG_INFO("Pipeline test: {} of {} variants ready, {} pending right after their request, {} fallback draws, "
+                 "median frame {:.3f} ms without requests, {:.3f} ms with requests",
+                 ready, sPipelines.size(), sPendingAfterRequest, fallbackDraws, idleMedian * 1000.0,
+                 requestMedian * 1000.0);
+        if (ready != VARIANT_COUNT) {
+            MSG_ERROR("Pipeline test: {} variants never became ready", VARIANT_COUNT - ready);
+            return false;
+        }
+        if (sPendingAfterRequest == 0 || fallbackDraws == 0) {
+            MSG_ERROR("Pipeline test: variants were ready as soon as requested, they were compiled on the frame");
+            return false;
+        }
+        if (requestMedian > idleMedian * MAX_REQUEST_FRAME_RATIO) {
+            MSG_ERROR("Pipeline test: frames requesting variants took {:.1f} times those without, above {:.1f}",
+                      requestMedian / idleMedian, MAX_REQUEST_FRAME_RATIO);
+            return false;
+        }
+        return true;
+    }
+
+    bool update(double deltaTime) {
+        ++sFrame;
+        if (sFrame <= WARMUP_FRAMES) {
+            return true;
+        }
+        if (sFrame <= WARMUP_FRAMES + IDLE_FRAMES) {
+            sIdleFrameTimes.push_back(deltaTime);
+            return true;
+        }
+        if (sFrame <= WARMUP_FRAMES + IDLE_FRAMES + REQUEST_FRAMES) {
+            // The time of the frame before, which drew the variants requested so far
+            sRequestFrameTimes.push_back(deltaTime);
+            for (u32 i = 0; i < VARIANTS_PER_FRAME && sPipelines.size() < sDescriptions.size(); ++i) {
+                const auto pipeline = sGame->mRenderer->create_pipeline(sDescriptions[sPipelines.size()]);
+                if (!pipeline.is_valid()) {
+                    return false;
+                }
+                if (!sGame->mRenderer->is_pipeline_ready(pipeline)) {
+                    ++sPendingAfterRequest;
+                }
+                sPipelines.push_back(pipeline);
+            }
+            return true;
+        }
+        if (sFrame <= WARMUP_FRAMES + IDLE_FRAMES + REQUEST_FRAMES + COMPILE_FRAMES) {
+            return true;
+        }
+        return check_results();
+    }
+
+    bool render(double /*unused*/, RenderPacket& packet) {
+        for (const auto& pipeline : sPipelines) {
+            packet.drawCommands.push_back(DrawCommand{sVertexBuffer, {}, 6, 0, 1, pipeline});
+        }
+        return true;
+    }
+}  // namespace
+
+bool create_game(Game* game) {
+    *game = make_headless_game("Pipeline Test", WARMUP_FRAMES + IDLE_FRAMES + REQUEST_FRAMES + COMPILE_FRAMES + 1);
+    // Every run compiles from scratch, a warm cache would hide stalls
+    game->mPipelineCachePath.clear();
+    game->initialize = initialize;
+    game->update = update;
+    game->render = render;
+    sGame = game;
+    return true;
+}
\ No newline at end of file
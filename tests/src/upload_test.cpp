@@ -0,0 +1,132 @@
+#include "headless_test.hpp"
+#include <entry.hpp>
+#include <renderer/renderer.hpp>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+// Streams large uploads into vertex buffers while drawing from them, and compares those frames to frames drawing
+// without uploads. Fails when an upload waits for the GPU to free staging space, or when upload frames take much
+// longer than an idle frame plus the copies of their data, which means the frame stalled on the upload.
+//
+// Runs with --no-transfer-queue to copy on the graphics queue, which every device has. Without it the copies go
+// to the dedicated transfer queue, devices without one like lavapipe skip that variant.
+
+namespace {
+    constexpr u64 IDLE_FRAMES = 60;
+    constexpr u64 UPLOAD_FRAMES = 120;
+    constexpr u64 UPLOAD_SIZE = 4ULL * 1024 * 1024;
+    // Uploads go to the buffer drawn longest ago, the others are still read by frames in flight
+    constexpr u32 STREAM_BUFFER_COUNT = 3;
+    constexpr u32 COPY_SAMPLES = 16;
+    // An upload frame pays for writing the staging memory and for the GPU copy, which a software driver runs on
+    // the CPU as well. Both get twice the time of a CPU copy, staging memory may be slower to write. A stalled
+    // frame also waits for the frames in flight before it. Medians keep single hitches of a shared machine out
+    constexpr f64 MAX_IDLE_FRAME_RATIO = 2.0;
+    constexpr f64 COPIES_PER_UPLOAD_FRAME = 4.0;
+
+    Game* sGame{nullptr};
+    bool sSkipped{false};
+    std::array<BufferHandle, STREAM_BUFFER_COUNT> sBuffers{};
+    std::vector<Vertex> sVertices;
+    std::vector<Vertex> sCopy;
+    std::vector<f64> sCopyTimes;
+    std::vector<f64> sIdleFrameTimes;
+    std::vector<f64> sUploadFrameTimes;
+    u64 sFrame{0};
+
+    bool initialize() {
+        auto& renderer = *sGame->mRenderer;
+        if (renderer.uses_transfer_queue() != sGame->mTransferQueue) {
+            sSkipped = sGame->mTransferQueue;
+            if (!sSkipped) {
+                MSG_ERROR("Upload test: copies run on the transfer queue despite --no-transfer-queue");
+                return false;
+            }
+            MSG_INFO("Upload test: the device has no dedicated transfer queue, skipped");
+            return true;
+        }
+
+        sVertices.resize(UPLOAD_SIZE / sizeof(Vertex));
+        for (size_t i = 0; i < sVertices.size(); ++i) {
+            const auto corner = static_cast<f32>(i % 3);
+            sVertices[i] = Vertex{{corner * 0.5F - 0.5F, corner == 1.0F ? 0.5F : -0.5F, 0.0F}, {0.0F, 1.0F, 0.0F, 1.0F}};
+        }
+        sCopy.resize(sVertices.size());
+        for (u32 i = 0; i < COPY_SAMPLES; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            std::memcpy(sCopy.data(), sVertices.data(), UPLOAD_SIZE);
+            sCopyTimes.push_back(std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count());
+        }
+        for (auto& buffer : sBuffers) {
+            buffer = renderer.create_buffer(BufferUsage::BUFFER_USAGE_VERTEX, UPLOAD_SIZE);
+            if (!buffer.is_valid() || !renderer.upload_buffer(buffer, sVertices.data(), UPLOAD_SIZE)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool check_frames() {
+        const f64 copyMedian = median(sCopyTimes);
+        const f64 idleMedian = median(sIdleFrameTimes);
+        const f64 uploadMedian = median(sUploadFrameTimes);
+        const u64 stalls = sGame->mRenderer->get_statistics().uploadStalls;
+        const char* queue = sGame->mRenderer->uses_transfer_queue() ? "transfer" : "graphics";
+        MSG_INFO("Upload test: {} MiB per frame on the {} queue, median frame {:.3f} ms without uploads, {:.3f} ms "
+                 "with uploads, {:.3f} ms to copy on the CPU, {} stalls",
+                 UPLOAD_SIZE / (1024 * 1024), queue, idleMedian * 1000.0, uploadMedian * 1000.0, copyMedian * 1000.0,
+                 stalls);
+        if (stalls > 0) {
+            MSG_ERROR("Upload test: {} uploads waited for the GPU to free staging space", stalls);
+            return false;
+        }
+        const f64 maxUploadFrame = idleMedian * MAX_IDLE_FRAME_RATIO + copyMedian * COPIES_PER_UPLOAD_FRAME;
+        if (uploadMedian > maxUploadFrame) {
+            MSG_ERROR("Upload test: frames with uploads took {:.3f} ms, above {:.3f} ms", uploadMedian * 1000.0,
+                      maxUploadFrame * 1000.0);
+            return false;
+        }
+        return true;
+    }
+
+    bool update(double deltaTime) {
+        ++sFrame;
+        if (sSkipped || sFrame <= WARMUP_FRAMES) {
+            return true;
+        }
+        // deltaTime is the time of the frame before, which drew the buffer uploaded by the frame before it
+        if (sFrame <= WARMUP_FRAMES + IDLE_FRAMES) {
+            sIdleFrameTimes.push_back(deltaTime);
+            return true;
+        }
+        if (sFrame <= WARMUP_FRAMES + IDLE_FRAMES + UPLOAD_FRAMES) {
+            if (sFrame > WARMUP_FRAMES + IDLE_FRAMES + 1) {
+                sUploadFrameTimes.push_back(deltaTime);
+            }
+            return sGame->mRenderer->upload_buffer(sBuffers[sFrame % STREAM_BUFFER_COUNT], sVertices.data(),
+                                                   UPLOAD_SIZE);
+        }
+        return check_frames();
+    }
+
+    bool render(double /*unused*/, RenderPacket& packet) {
+        if (sSkipped) {
+            return true;
+        }
+        // The buffer uploaded last frame, a whole upload has to land before it is drawn
+        const auto& buffer = sBuffers[(sFrame + STREAM_BUFFER_COUNT - 1) % STREAM_BUFFER_COUNT];
+        packet.drawCommands.push_back(DrawCommand{buffer, {}, 3, 0, 1});
+        return true;
+    }
+}  // namespace
+
+bool create_game(Game* game) {
+    *game = make_headless_game("Upload Test", WARMUP_FRAMES + IDLE_FRAMES + UPLOAD_FRAMES + 1);
+    game->initialize = initialize;
+    game->update = update;
+    game->render = render;
+    sGame = game;
+    return true;
+}
\ No newline at end of file